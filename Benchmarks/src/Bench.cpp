@@ -0,0 +1,28 @@
+#include "Bench.h"
+
+#include <iostream>
+
+namespace oly::bench
+{
+	static size_t failed_checks = 0;
+
+	std::vector<Suite>& suites()
+	{
+		static std::vector<Suite> registered;
+		return registered;
+	}
+
+	void check(bool condition, std::string_view what)
+	{
+		if (!condition)
+		{
+			++failed_checks;
+			std::cout << "  FAILED: " << what << std::endl;
+		}
+	}
+
+	size_t failures()
+	{
+		return failed_checks;
+	}
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "core/util/Time.h"
+
+#include <vector>
+#include <string_view>
+#include <cstdint>
+
+namespace oly::context
+{
+	class HeadlessContext;
+}
+
+namespace oly::bench
+{
+	using SuiteFunction = void(*)();
+
+	struct Suite
+	{
+		std::string_view name;
+		SuiteFunction run;
+	};
+
+	// Suites register themselves during static initialization.
+	std::vector<Suite>& suites();
+
+	struct SuiteRegistration
+	{
+		SuiteRegistration(std::string_view name, SuiteFunction run) { suites().push_back({ .name = name, .run = run }); }
+	};
+
+	// Records a failure in the running suite if condition is false. The program exits with a nonzero code if any check failed.
+	void check(bool condition, std::string_view what);
+	size_t failures();
+
+	// The context owned by main(), for suites that tick services.
+	const context::HeadlessContext& headless_context();
+
+	// Mean wall-clock seconds per run of fn.
+	template<typename Fn>
+	double time(size_t runs, Fn&& fn)
+	{
+		Stopwatch stopwatch;
+		for (size_t i = 0; i < runs; ++i)
+			fn();
+		return runs > 0 ? stopwatch.lap() / runs : 0.0;
+	}
+
+	// Deterministic generator, so that scenes are the same across runs and platforms.
+	struct Random
+	{
+		std::uint64_t state = 0x9E3779B97F4A7C15ull;
+
+		std::uint32_t next()
+		{
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+			return (std::uint32_t)(state >> 32);
+		}
+
+		float range(float min, float max) { return min + (max - min) * (next() / 4294967296.0f); }
+	};
+
+	// Keeps the optimizer from discarding a computed value.
+	template<typename T>
+	void keep(const T& value)
+	{
+		[[maybe_unused]] static const void* volatile sink;
+		sink = &value;
+	}
+}
+
+#define OLY_BENCHMARK_SUITE(suite)\
+	static void suite();\
+	static oly::bench::SuiteRegistration suite##_registration(#suite, &suite);\
+	static void suite()
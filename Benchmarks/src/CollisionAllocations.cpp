@@ -0,0 +1,66 @@
+#include "Bench.h"
+
+#include "physics/collision/scene/dispatch/CollisionDispatcher.h"
+#include "physics/collision/objects/Primitive.h"
+
+#include <iostream>
+
+namespace oly::bench
+{
+	struct OverlapCounter : public col2d::CollisionController
+	{
+		size_t events = 0;
+
+		void on_overlap(const col2d::OverlapEventData&) { ++events; }
+	};
+
+	// A 36x36 grid of circles, each overlapping its 8 neighbours, gives 4970 overlapping pairs.
+	static void run_steady_state(const char* name, size_t tree)
+	{
+		constexpr int side = 36;
+		auto& dispatcher = col2d::CollisionDispatcher::instance();
+		{
+			OverlapCounter counter;
+			std::vector<col2d::Collider> colliders;
+			colliders.reserve(side * side);
+			for (int y = 0; y < side; ++y)
+			{
+				for (int x = 0; x < side; ++x)
+				{
+					col2d::Collider& collider = colliders.emplace_back(col2d::TPrimitive(col2d::Circle({}, 0.75f)));
+					collider.layer() = 1;
+					collider.mask() = 1;
+					collider.set_local().position = { (float)x, (float)y };
+					collider.handles.attach(tree);
+					counter.bind(collider, &OverlapCounter::on_overlap);
+				}
+			}
+
+			// storage grows over the first ticks, as pairs enter the phase tracker and iteration storage is pooled
+			for (int i = 0; i < 3; ++i)
+				dispatcher.on_tick();
+
+			const size_t allocations = dispatcher.allocation_count();
+			counter.events = 0;
+			constexpr int ticks = 10;
+			for (int i = 0; i < ticks; ++i)
+				dispatcher.on_tick();
+
+			std::cout << "  " << name << ": " << counter.events / ticks << " overlap events/tick, "
+				<< dispatcher.allocation_count() - allocations << " allocations over " << ticks << " ticks" << std::endl;
+			check(counter.events >= ticks * 4970, "every overlapping pair is dispatched");
+			check(dispatcher.allocation_count() == allocations, "steady-state ticks don't allocate");
+		}
+		dispatcher.remove_tree(tree);
+	}
+
+	OLY_BENCHMARK_SUITE(collision_steady_state_allocations)
+	{
+		const math::Rect2D bounds{ .x1 = -64.0f, .x2 = 64.0f, .y1 = -64.0f, .y2 = 64.0f };
+		auto& dispatcher = col2d::CollisionDispatcher::instance();
+		run_steady_state("linked quadtree", dispatcher.add_tree(bounds, { 2, 2 }, 4, col2d::TreeLayout::LinkedQuadtree));
+		run_steady_state("flat quadtree", dispatcher.add_tree(bounds, { 2, 2 }, 4, col2d::TreeLayout::FlatQuadtree));
+		run_steady_state("dynamic AABB tree", dispatcher.add_tree(col2d::TreeLayout::DynamicAABB));
+		run_steady_state("sweep and prune", dispatcher.add_tree(col2d::TreeLayout::SweepAndPrune));
+	}
+}
@@ -0,0 +1,82 @@
+#include "Bench.h"
+
+#include "physics/collision/scene/dispatch/CollisionDispatcher.h"
+#include "physics/collision/objects/Primitive.h"
+
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+
+namespace oly::bench
+{
+	struct MovingBox
+	{
+		col2d::Collider collider;
+		glm::vec2 velocity;
+	};
+
+	// Boxes of side 1-2 scattered at a constant density of one per 16 square units, moving at up to 0.5 units per tick and bouncing off the
+	// world bounds. No handlers are bound, so dispatch only flushes the tree and iterates its pairs.
+	static void run_moving_boxes(const char* name, col2d::TreeLayout layout, size_t count, int ticks)
+	{
+		const float half_extent = 2.0f * std::sqrt((float)count);
+		const math::Rect2D bounds{ .x1 = -half_extent, .x2 = half_extent, .y1 = -half_extent, .y2 = half_extent };
+
+		// boxes overshoot the bounds by up to a tick before bouncing
+		const math::Rect2D tree_bounds{ .x1 = bounds.x1 - 2.0f, .x2 = bounds.x2 + 2.0f, .y1 = bounds.y1 - 2.0f, .y2 = bounds.y2 + 2.0f };
+
+		auto& dispatcher = col2d::CollisionDispatcher::instance();
+		const size_t tree = dispatcher.add_tree(tree_bounds, { 2, 2 }, 4, layout);
+		{
+			Random random;
+			std::vector<MovingBox> boxes;
+			boxes.reserve(count);
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float w = random.range(0.5f, 1.0f), h = random.range(0.5f, 1.0f);
+				MovingBox& box = boxes.emplace_back(col2d::Collider(col2d::TPrimitive(col2d::AABB{ .x1 = -w, .x2 = w, .y1 = -h, .y2 = h })),
+					glm::vec2{ random.range(-0.5f, 0.5f), random.range(-0.5f, 0.5f) });
+				box.collider.layer() = 1;
+				box.collider.mask() = 1;
+				box.collider.set_local().position = { random.range(bounds.x1, bounds.x2), random.range(bounds.y1, bounds.y2) };
+				box.collider.handles.attach(tree);
+			}
+
+			auto step = [&]() {
+				for (MovingBox& box : boxes)
+				{
+					glm::vec2& position = box.collider.set_local().position;
+					position += box.velocity;
+					if (position.x < bounds.x1 || position.x > bounds.x2)
+						box.velocity.x = -box.velocity.x;
+					if (position.y < bounds.y1 || position.y > bounds.y2)
+						box.velocity.y = -box.velocity.y;
+				}
+				dispatcher.on_tick();
+			};
+
+			// the first tick inserts every collider
+			step();
+			dispatcher.profiling = true;
+			dispatcher.reset_profile();
+			const double seconds = time(ticks, step);
+			dispatcher.profiling = false;
+
+			const auto& profile = dispatcher.get_profile();
+			std::cout << "  " << std::setw(16) << std::left << name << std::setw(7) << std::right << count << " colliders: "
+				<< std::fixed << std::setprecision(3) << seconds * 1000.0 << " ms/tick (flush " << profile.tree_flush * 1000.0 / ticks
+				<< " ms, pairs " << profile.pair_generation * 1000.0 / ticks << " ms), " << profile.candidate_pairs / ticks << " pairs/tick"
+				<< std::defaultfloat << std::endl;
+		}
+		dispatcher.remove_tree(tree);
+	}
+
+	OLY_BENCHMARK_SUITE(collision_tree_layouts)
+	{
+		for (auto [count, ticks] : { std::pair<size_t, int>{ 1'000, 50 }, { 10'000, 20 }, { 100'000, 5 } })
+		{
+			run_moving_boxes("linked quadtree", col2d::TreeLayout::LinkedQuadtree, count, ticks);
+			run_moving_boxes("flat quadtree", col2d::TreeLayout::FlatQuadtree, count, ticks);
+		}
+	}
+}
@@ -0,0 +1,119 @@
+#include "Bench.h"
+
+#include "core/containers/Ranges.h"
+
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <string>
+
+namespace oly::bench
+{
+	// runs of a set's indices, coalescing runs separated by at most merge_gap indices, as persistent buffers grouped their dirty sets
+	static void for_each_run(const std::set<unsigned int>& indices, unsigned int merge_gap, auto&& func)
+	{
+		bool open = false;
+		Range<unsigned int> run;
+		for (unsigned int i : indices)
+		{
+			if (open && i <= run.end() + merge_gap)
+				run.length = i + 1 - run.initial;
+			else
+			{
+				if (open)
+					func(run);
+				open = true;
+				run = { .initial = i, .length = 1 };
+			}
+		}
+		if (open)
+			func(run);
+	}
+
+	static void check_against_set()
+	{
+		Random random;
+		bool matched = true;
+		for (int trial = 0; trial < 2000 && matched; ++trial)
+		{
+			const unsigned int merge_gap = trial % 4;
+			DirtyIntervals<unsigned int> intervals(merge_gap);
+			std::set<unsigned int> reference;
+			const unsigned int inserts = random.next() % 20;
+			for (unsigned int k = 0; k < inserts; ++k)
+			{
+				const unsigned int index = random.next() % 400;
+				if (random.next() % 2)
+				{
+					intervals.insert(index);
+					reference.insert(index);
+				}
+				else
+				{
+					const unsigned int length = random.next() % 150;
+					intervals.insert(Range<unsigned int>{ index, length });
+					for (unsigned int i = index; i < index + length; ++i)
+						reference.insert(i);
+				}
+			}
+
+			std::vector<Range<unsigned int>> expected, actual;
+			for_each_run(reference, merge_gap, [&](Range<unsigned int> run) { expected.push_back(run); });
+			intervals.for_each([&](Range<unsigned int> run) { actual.push_back(run); });
+			matched = expected.size() == actual.size() && std::equal(expected.begin(), expected.end(), actual.begin(),
+				[](Range<unsigned int> a, Range<unsigned int> b) { return a.initial == b.initial && a.length == b.length; });
+
+			for (unsigned int i = 0; i < 600 && matched; ++i)
+				matched = intervals.contains(i) == (reference.count(i) > 0);
+
+			intervals.clear();
+			size_t runs = 0;
+			intervals.for_each([&](Range<unsigned int>) { ++runs; });
+			matched = matched && runs == 0 && intervals.empty();
+		}
+		check(matched, "dirty intervals match a std::set of indices");
+	}
+
+	// Marks dirty_per_frame random indices out of capacity each frame, then iterates and clears the dirty runs, as a persistent buffer does.
+	static void run_frames(const char* name, unsigned int capacity, unsigned int dirty_per_frame, unsigned int merge_gap)
+	{
+		constexpr int frames = 200;
+		std::vector<unsigned int> indices(dirty_per_frame * frames);
+		Random random;
+		for (unsigned int& index : indices)
+			index = random.next() % capacity;
+
+		size_t interval_runs = 0, set_runs = 0;
+		DirtyIntervals<unsigned int> intervals(merge_gap);
+		const double interval_seconds = time(frames, [&, frame = 0]() mutable {
+			for (unsigned int i = 0; i < dirty_per_frame; ++i)
+				intervals.insert(indices[frame * dirty_per_frame + i]);
+			intervals.for_each([&](Range<unsigned int>) { ++interval_runs; });
+			intervals.clear();
+			++frame;
+			});
+
+		std::set<unsigned int> set;
+		const double set_seconds = time(frames, [&, frame = 0]() mutable {
+			for (unsigned int i = 0; i < dirty_per_frame; ++i)
+				set.insert(indices[frame * dirty_per_frame + i]);
+			for_each_run(set, merge_gap, [&](Range<unsigned int>) { ++set_runs; });
+			set.clear();
+			++frame;
+			});
+
+		check(interval_runs == set_runs, std::string(name) + " run count");
+		std::cout << "  " << std::setw(22) << std::left << name << std::right << std::fixed << std::setprecision(3) << "intervals "
+			<< interval_seconds * 1000.0 << " ms/frame, set " << set_seconds * 1000.0 << " ms/frame (" << std::setprecision(1)
+			<< set_seconds / interval_seconds << "x), " << interval_runs / frames << " runs/frame" << std::defaultfloat << std::endl;
+	}
+
+	OLY_BENCHMARK_SUITE(dirty_intervals)
+	{
+		check_against_set();
+		run_frames("sparse 100 of 100k", 100'000, 100, 0);
+		run_frames("scattered 10k of 100k", 100'000, 10'000, 0);
+		run_frames("scattered 10k, gap 8", 100'000, 10'000, 8);
+		run_frames("dense 90k of 100k", 100'000, 90'000, 0);
+	}
+}
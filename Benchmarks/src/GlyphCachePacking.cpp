@@ -0,0 +1,152 @@
+#include "Bench.h"
+
+#include "graphics/text/GlyphCache.h"
+
+#include <iostream>
+#include <iomanip>
+#include <unordered_map>
+#include <cmath>
+
+namespace oly::bench
+{
+	using rendering::GlyphCache;
+	using rendering::GlyphKey;
+
+	static GlyphKey glyph_key(glm::uint c)
+	{
+		return { .font = 1 + c % 3, .codepoint = utf::Codepoint(c) };
+	}
+
+	static bool overlap(const GlyphCache::Placement& a, const GlyphCache::Placement& b)
+	{
+		return a.page == b.page && a.area.x < b.area.x + b.area.w && b.area.x < a.area.x + a.area.w
+			&& a.area.y < b.area.y + b.area.h && b.area.y < a.area.y + a.area.h;
+	}
+
+	// Random finds, inserts, leases and releases, periodically checking that live glyphs lie within their pages without overlapping, and that
+	// leased glyphs are never evicted.
+	static void check_random_packing()
+	{
+		constexpr glm::ivec2 page_size = { 256, 256 };
+		GlyphCache cache(page_size, 2);
+		std::unordered_map<glm::uint, GlyphCache::Placement> live;
+		std::unordered_map<glm::uint, glm::uint> leased;
+		Random random;
+		bool valid = true;
+		for (int step = 0; step < 100'000 && valid; ++step)
+		{
+			const glm::uint c = random.next() % 3000;
+			const GlyphKey key = glyph_key(c);
+			const glm::uint op = random.next() % 10;
+			if (op < 6)
+			{
+				if (const GlyphCache::Placement* placement = cache.find(key))
+					valid = live.count(c) && live[c].area.x == placement->area.x && live[c].area.y == placement->area.y && live[c].page == placement->page;
+				else if (auto placement = cache.insert(key, glm::ivec2(4 + random.next() % 30, 6 + random.next() % 30)))
+				{
+					valid = placement->page < 2 && placement->area.x >= 0 && placement->area.y >= 0
+						&& placement->area.x + placement->area.w <= page_size.x && placement->area.y + placement->area.h <= page_size.y;
+					live[c] = *placement;
+				}
+			}
+			else if (op < 8)
+			{
+				if (cache.leases(key) > 0 || cache.find(key))
+				{
+					cache.acquire(key);
+					++leased[c];
+				}
+			}
+			else if (auto it = leased.find(c); it != leased.end())
+			{
+				cache.release(key);
+				if (--it->second == 0)
+					leased.erase(it);
+			}
+
+			if (step % 1000 == 0)
+			{
+				// finding every glyph would reorder the LRU list, so evicted glyphs are detected through the stats instead
+				std::vector<GlyphCache::Placement> placements;
+				for (auto it = live.begin(); it != live.end() && valid;)
+				{
+					const size_t misses = cache.get_stats().misses;
+					cache.find(glyph_key(it->first));
+					if (cache.get_stats().misses != misses)
+					{
+						valid = !leased.count(it->first);
+						it = live.erase(it);
+					}
+					else
+						placements.push_back((it++)->second);
+				}
+				for (size_t i = 0; i < placements.size() && valid; ++i)
+					for (size_t j = i + 1; j < placements.size() && valid; ++j)
+						valid = !overlap(placements[i], placements[j]);
+				valid = valid && placements.size() == cache.size();
+			}
+		}
+		check(valid, "random packing keeps live glyphs in bounds and disjoint, and leased glyphs resident");
+	}
+
+	// A page holds 16 glyphs of 16x16. After 8 of them are used again, inserting 8 more evicts exactly the 8 that were not.
+	static void check_lru_order()
+	{
+		GlyphCache cache({ 64, 64 }, 1);
+		for (glm::uint c = 0; c < 16; ++c)
+			cache.insert(glyph_key(c), { 16, 16 });
+		for (glm::uint c = 0; c < 8; ++c)
+			cache.find(glyph_key(c));
+
+		cache.reset_stats();
+		for (glm::uint c = 16; c < 24; ++c)
+			cache.insert(glyph_key(c), { 16, 16 });
+		check(cache.get_stats().evictions == 8 && cache.get_stats().rejections == 0, "one eviction per insert into a full page");
+
+		bool evicted_lru = true;
+		for (glm::uint c = 0; c < 24; ++c)
+			evicted_lru &= (cache.find(glyph_key(c)) != nullptr) == (c < 8 || c >= 16);
+		check(evicted_lru, "least recently used glyphs are evicted first");
+
+		// with every glyph leased, nothing can make room
+		for (glm::uint c = 0; c < 24; ++c)
+			cache.acquire(glyph_key(c));
+		cache.reset_stats();
+		check(!cache.insert(glyph_key(24), { 16, 16 }) && cache.get_stats().rejections == 1 && cache.size() == 16, "leased glyphs are not evicted");
+	}
+
+	// Text-like lookups: codepoint frequencies fall off with rank, so that a few hundred glyphs account for most finds.
+	static void run_text_workload(glm::ivec2 page_size, size_t max_pages)
+	{
+		constexpr size_t lookups = 200'000;
+		constexpr glm::uint alphabet = 20'000;
+		std::vector<glm::uint> codepoints(lookups);
+		Random random;
+		for (glm::uint& c : codepoints)
+			c = glm::uint(std::pow(random.range(0.0f, 1.0f), 8.0f) * alphabet);
+
+		GlyphCache cache(page_size, max_pages);
+		const double seconds = time(1, [&]() {
+			for (glm::uint c : codepoints)
+			{
+				const GlyphKey key = glyph_key(c);
+				if (!cache.find(key))
+					keep(cache.insert(key, glm::ivec2(8 + c % 24, 20 + c % 8)));
+			}
+			});
+
+		const auto& stats = cache.get_stats();
+		std::cout << "  " << page_size.x << "x" << page_size.y << " x " << max_pages << " pages: " << std::fixed << std::setprecision(1)
+			<< seconds * 1e9 / lookups << " ns/lookup, hit rate " << 100.0 * stats.hits / (stats.hits + stats.misses) << "%, " << stats.evictions
+			<< " evictions, " << cache.size() << " resident" << std::defaultfloat << std::endl;
+	}
+
+	OLY_BENCHMARK_SUITE(glyph_cache)
+	{
+		check_random_packing();
+		check_lru_order();
+		run_text_workload({ 512, 512 }, 1);
+		run_text_workload({ 1024, 1024 }, 2);
+		run_text_workload({ 1024, 1024 }, 4);
+	}
+}
@@ -0,0 +1,54 @@
+#include "Bench.h"
+
+#include "core/util/AllocationCounter.h"
+#include "core/context/Context.h"
+
+#include <algorithm>
+#include <iostream>
+
+// suites measure allocations through the counting operators
+OLY_COUNT_ALLOCATIONS()
+
+static const oly::context::HeadlessContext* active_context = nullptr;
+
+const oly::context::HeadlessContext& oly::bench::headless_context()
+{
+	return *active_context;
+}
+
+int main(int argc, char** argv)
+{
+	// suites share one headless context, which loads the collision LUTs and registers the collision and physics services
+	oly::context::HeadlessContext context;
+	active_context = &context;
+
+	std::vector<oly::bench::Suite> suites = oly::bench::suites();
+	std::sort(suites.begin(), suites.end(), [](const auto& a, const auto& b) { return a.name < b.name; });
+
+	std::vector<std::string_view> selected(argv + 1, argv + argc);
+	size_t ran = 0;
+	for (const oly::bench::Suite& suite : suites)
+	{
+		if (!selected.empty() && std::find(selected.begin(), selected.end(), suite.name) == selected.end())
+			continue;
+
+		std::cout << "[" << suite.name << "]" << std::endl;
+		suite.run();
+		++ran;
+	}
+
+	if (ran == 0)
+	{
+		std::cout << "no suites matched - available suites:" << std::endl;
+		for (const oly::bench::Suite& suite : suites)
+			std::cout << "  " << suite.name << std::endl;
+		return 1;
+	}
+
+	if (oly::bench::failures() > 0)
+	{
+		std::cout << oly::bench::failures() << " check(s) failed" << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,97 @@
+#include "Bench.h"
+
+#include "physics/collision/methods/Batch.h"
+#include "physics/collision/methods/Collide.h"
+#include "physics/collision/methods/KDOPCollide.h"
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+namespace oly::bench
+{
+	static constexpr size_t PAIRS = 100'000;
+	static constexpr size_t RUNS = 20;
+
+	// Shapes are scattered over a 20x20 square with extents up to 5, so roughly half of the pairs overlap.
+	static glm::vec2 random_center(Random& random)
+	{
+		return { random.range(-10.0f, 10.0f), random.range(-10.0f, 10.0f) };
+	}
+
+	static math::Polygon2D random_box(Random& random)
+	{
+		const glm::vec2 center = random_center(random);
+		const glm::vec2 extent = { random.range(0.1f, 2.5f), random.range(0.1f, 2.5f) };
+		const UnitVector2D u(random.range(-glm::pi<float>(), glm::pi<float>()));
+		const glm::vec2 x = extent.x * glm::vec2{ u.x(), u.y() };
+		const glm::vec2 y = extent.y * glm::vec2{ -u.y(), u.x() };
+		return { center - x - y, center + x - y, center + x + y, center - x + y };
+	}
+
+	// Times the batch kernel against the single-pair overlaps() on the same pairs, and checks that their results match.
+	template<typename Shape, typename Pairs>
+	static void run_batch(const std::string& name, const std::vector<Shape>& shapes)
+	{
+		Pairs pairs;
+		for (size_t i = 0; i < PAIRS; ++i)
+			pairs.push(shapes[2 * i], shapes[2 * i + 1]);
+
+		std::vector<col2d::OverlapResult> batched(PAIRS), single(PAIRS);
+		const double batch_seconds = time(RUNS, [&]() { col2d::batch::overlaps(pairs, batched.data()); });
+		const double single_seconds = time(RUNS, [&]() {
+			for (size_t i = 0; i < PAIRS; ++i)
+				single[i] = col2d::overlaps(shapes[2 * i], shapes[2 * i + 1]);
+			});
+		keep(batched);
+		keep(single);
+
+		size_t mismatches = 0;
+		for (size_t i = 0; i < PAIRS; ++i)
+			if (batched[i].overlap != single[i].overlap)
+				++mismatches;
+
+		std::cout << "  " << std::setw(10) << std::left << name << std::right << std::fixed << std::setprecision(1)
+			<< std::setw(8) << PAIRS / batch_seconds / 1e6 << " Mpairs/s batched, " << std::setw(8) << PAIRS / single_seconds / 1e6
+			<< " Mpairs/s single, " << mismatches << " mismatches" << std::defaultfloat << std::endl;
+		check(mismatches == 0, name + " batch results match single-pair tests");
+	}
+
+	template<size_t K>
+	static void run_kdop_batch(Random& random)
+	{
+		std::vector<col2d::KDOP<K>> kdops;
+		kdops.reserve(2 * PAIRS);
+		for (size_t i = 0; i < 2 * PAIRS; ++i)
+			kdops.push_back(col2d::KDOP<K>::wrap(random_box(random)));
+		run_batch<col2d::KDOP<K>, col2d::batch::KDOPPairs<K>>("KDOP" + std::to_string(K), kdops);
+	}
+
+	OLY_BENCHMARK_SUITE(narrow_phase_batches)
+	{
+		Random random;
+
+		std::vector<col2d::Circle> circles;
+		std::vector<col2d::AABB> aabbs;
+		std::vector<col2d::OBB> obbs;
+		circles.reserve(2 * PAIRS);
+		aabbs.reserve(2 * PAIRS);
+		obbs.reserve(2 * PAIRS);
+		for (size_t i = 0; i < 2 * PAIRS; ++i)
+		{
+			circles.push_back(col2d::Circle(random_center(random), random.range(0.1f, 2.5f)));
+			const glm::vec2 center = random_center(random);
+			const glm::vec2 extent = { random.range(0.1f, 2.5f), random.range(0.1f, 2.5f) };
+			aabbs.push_back(col2d::AABB{ .x1 = center.x - extent.x, .x2 = center.x + extent.x, .y1 = center.y - extent.y, .y2 = center.y + extent.y });
+			obbs.push_back(col2d::OBB{ .center = random_center(random), .width = random.range(0.2f, 5.0f), .height = random.range(0.2f, 5.0f),
+				.rotation = random.range(-glm::pi<float>(), glm::pi<float>()) });
+		}
+
+		run_batch<col2d::Circle, col2d::batch::CirclePairs>("circle", circles);
+		run_batch<col2d::AABB, col2d::batch::AABBPairs>("AABB", aabbs);
+		run_batch<col2d::OBB, col2d::batch::OBBPairs>("OBB", obbs);
+		run_kdop_batch<2>(random);
+		run_kdop_batch<4>(random);
+		run_kdop_batch<8>(random);
+	}
+}
@@ -0,0 +1,85 @@
+#include "Bench.h"
+
+#include "graphics/particles/ParticleSimulator.h"
+#include "graphics/particles/ShaderStructs.h"
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+namespace oly::bench
+{
+	// a power of two, so that accumulated time elapsed is exact and lifetimes expire on a known tick
+	static constexpr float PARTICLE_TICK = 1.0f / 64.0f;
+	static constexpr GLuint SPAWN_PER_TICK = 500;
+
+	static particles::internal::EmitterParams emitter(GLuint max_particles)
+	{
+		particles::internal::EmitterParams params;
+		params.max_particles = max_particles;
+		params.lifetime.domain.params[0] = 1.0f;
+		params.size.domain.params[0] = 1.0f;
+		params.size.domain.params[1] = 1.0f;
+		params.velocity.domain.params[0] = 10.0f;
+		params.velocity.domain.params[1] = -5.0f;
+		return params;
+	}
+
+	// Spawns SPAWN_PER_TICK particles and updates once per tick, calling expect with the tick number and particle count after each update.
+	template<typename Expect>
+	static void run_emitter(const char* name, const particles::internal::EmitterParams& params, int ticks, Expect&& expect)
+	{
+		particles::ParticleSimulator simulator(params.max_particles);
+		const glm::mat3 transform = 1.0f;
+
+		Stopwatch stopwatch;
+		double spawn_seconds = 0.0, update_seconds = 0.0;
+		size_t updated = 0;
+		bool matched = true;
+		for (int tick = 1; tick <= ticks; ++tick)
+		{
+			stopwatch.lap();
+			simulator.spawn(params, SPAWN_PER_TICK, tick * PARTICLE_TICK, transform);
+			spawn_seconds += stopwatch.lap();
+			updated += simulator.size();
+			simulator.update(PARTICLE_TICK);
+			update_seconds += stopwatch.lap();
+			if (!expect(tick, simulator.size()))
+			{
+				std::cout << "  " << name << ": " << simulator.size() << " particles after tick " << tick << std::endl;
+				matched = false;
+				break;
+			}
+		}
+		check(matched, std::string(name) + " particle count");
+
+		std::cout << "  " << std::setw(18) << std::left << name << std::right << std::setw(6) << simulator.size() << " particles: " << std::fixed
+			<< std::setprecision(3) << "spawn " << spawn_seconds * 1000.0 / ticks << " ms/tick, update " << update_seconds * 1000.0 / ticks
+			<< " ms/tick (" << std::setprecision(1) << updated / update_seconds * 1e-6 << " Mparticles/s)" << std::defaultfloat << std::endl;
+	}
+
+	OLY_BENCHMARK_SUITE(particle_cpu_backend)
+	{
+		// a batch spawned on tick k is aged k/64 seconds on each later update, so it expires on its 64th update
+		run_emitter("constant lifetime", emitter(100'000), 300, [](int tick, size_t count) {
+			return count == (size_t)std::min(tick, 63) * SPAWN_PER_TICK;
+			});
+
+		// spawning stops at max_particles, and resumes as particles expire
+		run_emitter("capped", emitter(10'000), 300, [reached = false](int tick, size_t count) mutable {
+			if (count + SPAWN_PER_TICK > 10'000)
+				reached = true;
+			return count <= 10'000 && (tick < 63 || reached);
+			});
+
+		// lifetimes uniform in [0.5, 1.5] average to 64 ticks, less half a tick for the first update
+		auto params = emitter(100'000);
+		params.lifetime.domain.type = particles::internal::Domain1D::Line;
+		params.lifetime.domain.params[0] = 0.5f;
+		params.lifetime.domain.params[1] = 1.5f;
+		run_emitter("random lifetime", params, 300, [](int tick, size_t count) {
+			const double expected = 63.5 * SPAWN_PER_TICK;
+			return tick < 96 || (count > 0.97 * expected && count < 1.03 * expected);
+			});
+	}
+}
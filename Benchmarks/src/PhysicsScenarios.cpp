@@ -0,0 +1,120 @@
+#include "Bench.h"
+
+#include "core/context/Context.h"
+#include "physics/dynamics/bodies/PhysicsStepper.h"
+#include "physics/dynamics/bodies/StaticBody.h"
+#include "physics/dynamics/bodies/LinearBody.h"
+#include "physics/dynamics/Constants.h"
+#include "physics/collision/objects/Primitive.h"
+
+#include <iostream>
+#include <iomanip>
+#include <functional>
+
+namespace oly::bench
+{
+	static constexpr double TICK = 1.0 / 60.0;
+
+	struct Scene
+	{
+		std::vector<physics::StaticBodyRef> statics;
+		std::vector<physics::LinearBodyRef> bodies;
+
+		physics::StaticBodyRef& add_static(col2d::AABB aabb)
+		{
+			physics::StaticBodyRef& body = statics.emplace_back(REF_INIT);
+			body->add_collider(aabb);
+			body->collider().layer() = 1;
+			body->collider().mask() = 1;
+			return body;
+		}
+
+		template<typename Shape>
+		physics::LinearBodyRef& add_body(Shape shape, glm::vec2 position, glm::vec2 velocity = {})
+		{
+			physics::LinearBodyRef& body = bodies.emplace_back(REF_INIT);
+			body->add_collider(shape);
+			body->collider().layer() = 1;
+			body->collider().mask() = 1;
+			body->set_local().position = position;
+			body->properties().net_acceleration = physics::GRAVITY;
+			body->properties().net_impulse = velocity;
+			return body;
+		}
+	};
+
+	// Steps the scene through the shared context, calling spawn before each tick. The tree is added before the scene is built, so that bodies
+	// attach to it, and removed once the scene is destroyed.
+	static void run_scenario(const char* name, int ticks, const std::function<void(Scene&)>& build, const std::function<void(Scene&, int)>& spawn = {})
+	{
+		auto& dispatcher = col2d::CollisionDispatcher::instance();
+		auto& stepper = physics::PhysicsStepper::instance();
+		const size_t tree = dispatcher.add_tree({ .x1 = -2000.0f, .x2 = 2000.0f, .y1 = -1000.0f, .y2 = 3000.0f });
+		check(tree == 0, "rigid bodies attach to the scenario's tree");
+		{
+			Scene scene;
+			build(scene);
+
+			dispatcher.profiling = true;
+			stepper.profiling = true;
+			dispatcher.reset_profile();
+			stepper.reset_profile();
+			const double seconds = time(ticks, [&, tick = 0]() mutable {
+				if (spawn)
+					spawn(scene, tick++);
+				headless_context().tick(TICK);
+				});
+			dispatcher.profiling = false;
+			stepper.profiling = false;
+
+			const auto& collision = dispatcher.get_profile();
+			const auto& physics = stepper.get_profile();
+			const auto ms = [ticks](double s) { return s * 1000.0 / ticks; };
+			std::cout << "  " << std::setw(14) << std::left << name << std::right << scene.bodies.size() << " bodies, " << scene.statics.size()
+				<< " statics: " << std::fixed << std::setprecision(3) << ms(seconds) << " ms/tick (flush " << ms(collision.tree_flush)
+				<< " ms, pairs " << ms(collision.pair_generation) << " ms, narrow " << ms(collision.narrow_phase) << " ms, handlers "
+				<< ms(collision.handler_invocation) << " ms, integration " << ms(physics.integration) << " ms)" << std::defaultfloat << std::endl;
+			std::cout << "    state hash " << std::hex << stepper.state_hash() << std::dec << std::endl;
+		}
+		dispatcher.remove_tree(tree);
+	}
+
+	// Headless scenes for comparing collision and physics changes. Each scene is deterministic, so the state hash printed after a scene only
+	// changes between builds if the simulation does.
+	OLY_BENCHMARK_SUITE(physics_scenarios)
+	{
+		// 25 layers of 20 boxes dropped onto the ground
+		run_scenario("box pile", 300, [](Scene& scene) {
+			scene.add_static({ .x1 = -500.0f, .x2 = 500.0f, .y1 = -40.0f, .y2 = 0.0f });
+			Random random;
+			for (int row = 0; row < 25; ++row)
+				for (int col = 0; col < 20; ++col)
+					scene.add_body(col2d::AABB{ .x1 = -10.0f, .x2 = 10.0f, .y1 = -10.0f, .y2 = 10.0f },
+						{ -400.0f + 40.0f * col + random.range(-2.0f, 2.0f), 20.0f + 25.0f * row });
+			});
+
+		// 4 circles spawned per tick above a ground with walls, up to 1000
+		run_scenario("circle rain", 400, [](Scene& scene) {
+			scene.add_static({ .x1 = -500.0f, .x2 = 500.0f, .y1 = -40.0f, .y2 = 0.0f });
+			scene.add_static({ .x1 = -540.0f, .x2 = -500.0f, .y1 = -40.0f, .y2 = 1000.0f });
+			scene.add_static({ .x1 = 500.0f, .x2 = 540.0f, .y1 = -40.0f, .y2 = 1000.0f });
+			scene.bodies.reserve(1000);
+			}, [random = Random()](Scene& scene, int tick) mutable {
+				for (int i = 0; i < 4 && scene.bodies.size() < 1000; ++i)
+					scene.add_body(col2d::Circle({}, random.range(4.0f, 8.0f)), { random.range(-480.0f, 480.0f), random.range(600.0f, 700.0f) },
+						{ random.range(-20.0f, 20.0f), 0.0f });
+			});
+
+		// a 200x10 map of static tiles, with 200 boxes thrown across it
+		run_scenario("static tilemap", 300, [](Scene& scene) {
+			scene.statics.reserve(2000);
+			for (int row = 0; row < 10; ++row)
+				for (int col = 0; col < 200; ++col)
+					scene.add_static({ .x1 = -1600.0f + 16.0f * col, .x2 = -1584.0f + 16.0f * col, .y1 = -160.0f + 16.0f * row, .y2 = -144.0f + 16.0f * row });
+			Random random;
+			for (int i = 0; i < 200; ++i)
+				scene.add_body(col2d::AABB{ .x1 = -6.0f, .x2 = 6.0f, .y1 = -6.0f, .y2 = 6.0f },
+					{ random.range(-1500.0f, 1500.0f), random.range(50.0f, 400.0f) }, { random.range(-200.0f, 200.0f), 0.0f });
+			});
+	}
+}
@@ -0,0 +1,85 @@
+#include "Bench.h"
+
+#include "graphics/text/Font.h"
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <algorithm>
+
+namespace oly::bench
+{
+	// Rasterizes printable ASCII as coverage and as a signed distance field, and compares the two on the CPU. Coverage is rasterized from the
+	// outline flattened to within 0.35px, and the field is measured to the curves themselves. A fully covered pixel has its center at least
+	// half a pixel inside the flattened outline, so at least 0.15px inside the curves, where the field reads 127 * 0.15 / spread above the edge
+	// value, which is at least 2 at the spreads checked here. Likewise for pixels that are not covered at all, so no saturated pixel may
+	// disagree. Partially covered pixels are only counted, since area coverage and center distance legitimately disagree there.
+	static void compare_glyphs(const rendering::FontFace& face, float font_size, int spread)
+	{
+		const float scale = face.scale_for_pixel_height(font_size);
+		std::vector<unsigned char> coverage, field;
+		size_t saturated = 0, saturated_mismatches = 0, edge = 0, edge_mismatches = 0;
+		// furthest that the field places a mismatched saturated pixel on the wrong side of the edge, in pixels
+		float max_violation = 0.0f;
+		double coverage_seconds = 0.0, field_seconds = 0.0;
+		Stopwatch stopwatch;
+		for (int c = '!'; c <= '~'; ++c)
+		{
+			const int index = face.find_glyph_index(utf::Codepoint(c));
+			int x0, x1, y0, y1;
+			face.get_bitmap_box(index, scale, x0, x1, y0, y1);
+			const int w = x1 - x0, h = y1 - y0;
+			if (w <= 0 || h <= 0)
+				continue;
+
+			const int fw = w + 2 * spread, fh = h + 2 * spread;
+			coverage.resize(size_t(w) * h);
+			field.resize(size_t(fw) * fh);
+
+			stopwatch.lap();
+			face.make_bitmap(coverage.data(), w, h, scale, index);
+			coverage_seconds += stopwatch.lap();
+			face.make_sdf_bitmap(field.data(), fw, fh, scale, index, spread);
+			field_seconds += stopwatch.lap();
+
+			// both bitmaps are flipped by their own heights, so the field is still offset by spread on each axis
+			for (int y = 0; y < h; ++y)
+			{
+				for (int x = 0; x < w; ++x)
+				{
+					const unsigned char c = coverage[y * w + x];
+					const bool inside = field[(y + spread) * fw + x + spread] >= 128;
+					if (c == 0 || c == 255)
+					{
+						++saturated;
+						if (inside != (c == 255))
+						{
+							++saturated_mismatches;
+							const float distance = (field[(y + spread) * fw + x + spread] - 128) * spread / 127.0f;
+							max_violation = std::max(max_violation, c == 255 ? -distance : distance);
+						}
+					}
+					else
+					{
+						++edge;
+						edge_mismatches += inside != (c >= 128);
+					}
+				}
+			}
+		}
+
+		check(saturated_mismatches == 0, "sdf matches coverage on saturated pixels at " + std::to_string((int)font_size) + "px, spread " + std::to_string(spread));
+		std::cout << "  " << std::setw(3) << font_size << "px, spread " << spread << ": " << std::fixed << std::setprecision(3) << "coverage "
+			<< coverage_seconds * 1000.0 << " ms, sdf " << field_seconds * 1000.0 << " ms, " << saturated_mismatches << "/" << saturated
+			<< " saturated (max violation " << max_violation << " px) and " << edge_mismatches << "/" << edge << " edge pixels disagree" << std::defaultfloat
+			<< std::endl;
+	}
+
+	OLY_BENCHMARK_SUITE(sdf_glyphs)
+	{
+		const rendering::FontFace face(OLYMPIAN_BENCHMARK_FONT, rendering::Kerning{});
+		compare_glyphs(face, 24.0f, 4);
+		compare_glyphs(face, 64.0f, 4);
+		compare_glyphs(face, 64.0f, 8);
+	}
+}
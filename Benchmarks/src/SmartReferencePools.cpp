@@ -0,0 +1,99 @@
+#include "Bench.h"
+
+#include "core/types/SmartReference.h"
+
+#include <iostream>
+#include <iomanip>
+#include <memory>
+
+namespace oly::bench
+{
+	struct PooledObject
+	{
+		int value = 0;
+
+		PooledObject() = default;
+		PooledObject(int value) : value(value) {}
+	};
+
+	static constexpr size_t OBJECTS = 100'000;
+	static constexpr size_t COPIES = 4 * OBJECTS;
+
+	// Copies are taken in a scattered order, so that dereferencing them walks the slabs the way references held by other objects would.
+	template<typename Ref, typename Make>
+	static void run_references(const char* name, Make&& make, auto&& deref)
+	{
+		std::vector<Ref> refs;
+		refs.reserve(OBJECTS);
+		const double create_seconds = time(1, [&]() {
+			for (size_t i = 0; i < OBJECTS; ++i)
+				refs.push_back(make((int)i));
+			});
+
+		std::vector<Ref> copies;
+		copies.reserve(COPIES);
+		const double copy_seconds = time(1, [&]() {
+			for (size_t i = 0; i < COPIES; ++i)
+				copies.push_back(refs[(i * 7919) % OBJECTS]);
+			});
+
+		long long sum = 0;
+		const double deref_seconds = time(10, [&]() {
+			for (const Ref& copy : copies)
+				sum += deref(copy);
+			});
+		keep(sum);
+
+		const double release_seconds = time(1, [&]() {
+			copies.clear();
+			refs.clear();
+			});
+
+		std::cout << "  " << std::setw(17) << std::left << name << std::right << std::fixed << std::setprecision(1) << "create "
+			<< create_seconds * 1e9 / OBJECTS << " ns, copy " << copy_seconds * 1e9 / COPIES << " ns, deref " << deref_seconds * 1e9 / COPIES
+			<< " ns, release " << release_seconds * 1e9 / (OBJECTS + COPIES) << " ns" << std::defaultfloat << std::endl;
+	}
+
+	// Marking half the objects and cleaning frees their slots and invalidates every copy at once, without touching the copies.
+	static void run_clean()
+	{
+		std::vector<SmartReference<PooledObject>> refs;
+		refs.reserve(OBJECTS);
+		for (size_t i = 0; i < OBJECTS; ++i)
+			refs.emplace_back((int)i);
+		std::vector<SmartReference<PooledObject>> copies(refs.begin(), refs.end());
+		const PooledObject* survivor = &*refs[1];
+
+		for (size_t i = 0; i < OBJECTS; i += 2)
+			refs[i].mark_for_deletion();
+		const double clean_seconds = time(1, []() { internal::PoolBatch::instance().clean(); });
+
+		bool invalidated = true;
+		for (size_t i = 0; i < OBJECTS; ++i)
+			invalidated &= (bool)refs[i] == (i % 2 == 1) && (bool)copies[i] == (i % 2 == 1);
+		check(invalidated, "cleaning invalidates every reference to a marked object, and only those");
+		check(&*refs[1] == survivor && refs[1]->value == 1, "surviving objects do not move");
+
+		// freed slots are reused by new objects, which stale references must not see
+		std::vector<SmartReference<PooledObject>> reused;
+		reused.reserve(OBJECTS / 2);
+		for (size_t i = 0; i < OBJECTS / 2; ++i)
+			reused.emplace_back(-1);
+		bool stale = true;
+		for (size_t i = 0; i < OBJECTS; i += 2)
+			stale &= !refs[i] && !copies[i];
+		check(stale, "references to freed slots stay invalid after the slots are reused");
+
+		std::cout << "  clean " << OBJECTS / 2 << " of " << OBJECTS << " with " << OBJECTS << " copies: " << std::fixed << std::setprecision(3)
+			<< clean_seconds * 1000.0 << " ms" << std::defaultfloat << std::endl;
+	}
+
+	OLY_BENCHMARK_SUITE(smart_reference_pool)
+	{
+		run_references<SmartReference<PooledObject>>("smart reference", [](int i) { return SmartReference<PooledObject>(i); },
+			[](const SmartReference<PooledObject>& ref) { return ref->value; });
+		run_references<std::shared_ptr<PooledObject>>("shared_ptr", [](int i) { return std::make_shared<PooledObject>(i); },
+			[](const std::shared_ptr<PooledObject>& ref) { return ref->value; });
+		run_clean();
+	}
+}
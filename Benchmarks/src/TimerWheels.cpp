@@ -0,0 +1,108 @@
+#include "Bench.h"
+
+#include "core/util/TimerWheel.h"
+
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+
+namespace oly::bench
+{
+	static constexpr size_t TIMERS = 100'000;
+	static constexpr double FRAME = 1.0 / 60.0;
+	static constexpr double HORIZON = 60.0;
+
+	// Schedules TIMERS timers over the next minute, reschedules a quarter and cancels another quarter, then advances frame by frame until all
+	// have fired. Each timer must fire exactly once, in the frame that reaches its deadline, and in deadline order.
+	static void run_timer_wheel()
+	{
+		Random random;
+		std::vector<double> deadlines(TIMERS);
+		for (double& deadline : deadlines)
+			deadline = random.range(0.0f, (float)HORIZON);
+
+		TimerWheel wheel;
+		std::vector<TimerHandle> handles(TIMERS);
+		std::vector<double> fired_at(TIMERS, -1.0);
+		std::vector<std::uint32_t> order;
+		order.reserve(TIMERS);
+
+		const double schedule_seconds = time(1, [&]() {
+			for (std::uint32_t i = 0; i < TIMERS; ++i)
+				handles[i] = wheel.schedule_at(deadlines[i], [&, i]() { fired_at[i] = wheel.now(); order.push_back(i); });
+			});
+
+		const double reschedule_seconds = time(1, [&]() {
+			for (size_t i = 0; i < TIMERS / 4; ++i)
+			{
+				deadlines[i] = random.range(0.0f, (float)HORIZON);
+				wheel.reschedule_at(handles[i], deadlines[i]);
+			}
+			});
+
+		bool cancelled = true;
+		const double cancel_seconds = time(1, [&]() {
+			for (size_t i = TIMERS / 4; i < TIMERS / 2; ++i)
+				cancelled &= wheel.cancel(handles[i]);
+			});
+		check(cancelled && wheel.size() == TIMERS - TIMERS / 4, "cancelled timers are unscheduled");
+
+		const int frames = int(HORIZON / FRAME) + 2;
+		const double advance_seconds = time(frames, [&]() { wheel.advance(FRAME); });
+		check(wheel.size() == 0 && order.size() == TIMERS - TIMERS / 4, "every remaining timer fires once");
+
+		bool on_time = true;
+		for (size_t i = 0; i < TIMERS; ++i)
+		{
+			if (i >= TIMERS / 4 && i < TIMERS / 2)
+				on_time &= fired_at[i] < 0.0;
+			else
+				on_time &= fired_at[i] + 1e-6 >= deadlines[i] && fired_at[i] - FRAME - TimerWheel::RESOLUTION < deadlines[i];
+		}
+		check(on_time, "timers fire in the frame that reaches their deadline, and cancelled timers never fire");
+
+		bool ordered = true;
+		for (size_t k = 1; k < order.size(); ++k)
+			ordered &= std::ceil(deadlines[order[k - 1]] / TimerWheel::RESOLUTION - 1e-6) <= std::ceil(deadlines[order[k]] / TimerWheel::RESOLUTION - 1e-6);
+		check(ordered, "timers fire in deadline order");
+
+		std::cout << "  timer wheel, " << TIMERS << " timers: " << std::fixed << std::setprecision(1) << "schedule " << schedule_seconds * 1e9 / TIMERS
+			<< " ns, reschedule " << reschedule_seconds * 1e9 / (TIMERS / 4) << " ns, cancel " << cancel_seconds * 1e9 / (TIMERS / 4) << " ns, "
+			<< std::setprecision(3) << "advance " << advance_seconds * 1000.0 << " ms/frame" << std::defaultfloat << std::endl;
+	}
+
+	// The same frames with timers that each check their own deadline every frame, as StateTimer and CallbackTimer did before the wheel.
+	static void run_polled_timers()
+	{
+		Random random;
+		std::vector<double> deadlines(TIMERS);
+		for (double& deadline : deadlines)
+			deadline = random.range(0.0f, (float)HORIZON);
+
+		std::vector<unsigned char> active(TIMERS, 1);
+		size_t fired = 0;
+		double clock = 0.0;
+		const int frames = int(HORIZON / FRAME) + 2;
+		const double advance_seconds = time(frames, [&]() {
+			clock += FRAME;
+			for (size_t i = 0; i < TIMERS; ++i)
+			{
+				if (active[i] && clock >= deadlines[i])
+				{
+					active[i] = 0;
+					++fired;
+				}
+			}
+			});
+		keep(fired);
+
+		std::cout << "  polled timers, " << TIMERS << " timers: " << std::fixed << std::setprecision(3) << "advance " << advance_seconds * 1000.0
+			<< " ms/frame" << std::defaultfloat << std::endl;
+	}
+
+	OLY_BENCHMARK_SUITE(timer_wheel)
+	{
+		run_timer_wheel();
+		run_polled_timers();
+	}
+}
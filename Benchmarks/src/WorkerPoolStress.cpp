@@ -0,0 +1,131 @@
+#include "Bench.h"
+
+#include "core/util/WorkerPool.h"
+
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace oly::bench
+{
+	// forks the first branch of every call into a group, so that the tree of nested groups is as deep as n
+	static long long fibonacci(int n)
+	{
+		if (n < 18)
+		{
+			long long a = 0, b = 1;
+			for (int i = 0; i < n; ++i)
+				a = std::exchange(b, a + b);
+			return a;
+		}
+
+		long long x = 0;
+		TaskGroup group;
+		group.run([&x, n]() { x = fibonacci(n - 1); });
+		const long long y = fibonacci(n - 2);
+		group.wait();
+		return x + y;
+	}
+
+	static void stress_parallel_for(WorkerPool& pool)
+	{
+		bool covered = true, nested = true, rethrown = true;
+		for (int rep = 0; rep < 200; ++rep)
+		{
+			std::vector<std::atomic<int>> hits(10'007);
+			pool.parallel_for(hits.size(), 1 + rep % 50, [&hits](size_t begin, size_t end) {
+				for (size_t i = begin; i < end; ++i)
+					++hits[i];
+				});
+			for (const auto& hit : hits)
+				covered &= hit.load() == 1;
+
+			std::atomic<size_t> total = 0;
+			pool.parallel_for(64, 1, [&pool, &total](size_t begin, size_t end) {
+				for (size_t i = begin; i < end; ++i)
+					pool.parallel_for(100, 7, [&total](size_t b, size_t e) { total += e - b; });
+				});
+			nested &= total.load() == 6400;
+
+			bool threw = false;
+			try
+			{
+				pool.parallel_for(1000, 3, [](size_t begin, size_t end) {
+					if (begin <= 501 && 501 < end)
+						throw std::runtime_error("chunk failed");
+					});
+			}
+			catch (const std::runtime_error&)
+			{
+				threw = true;
+			}
+			rethrown &= threw;
+		}
+		check(covered, "parallel_for visits every index exactly once, across grain sizes");
+		check(nested, "nested parallel_for calls complete");
+		check(rethrown, "an exception thrown by a chunk is rethrown by parallel_for");
+	}
+
+	static void stress_task_groups(WorkerPool& pool)
+	{
+		std::atomic<size_t> ran = 0;
+		{
+			TaskGroup group;
+			for (size_t i = 0; i < 100'000; ++i)
+				group.run([&ran]() { ++ran; });
+			group.wait();
+		}
+		check(ran.load() == 100'000, "every job run in a group completes before wait returns");
+
+		const double seconds = time(1, []() { check(fibonacci(32) == 2'178'309, "recursively nested groups compute fib(32)"); });
+		std::cout << "  fib(32) with nested groups: " << std::fixed << std::setprecision(3) << seconds * 1000.0 << " ms" << std::defaultfloat << std::endl;
+
+		// phase jobs post to the main thread, which runs the posted jobs when the phase is joined
+		const std::thread::id main_thread = std::this_thread::get_id();
+		std::atomic<size_t> phase_ran = 0;
+		size_t main_ran = 0;
+		bool on_main = true;
+		for (size_t i = 0; i < 1000; ++i)
+		{
+			pool.phase_jobs(TickPhase::Physics).run([&]() {
+				++phase_ran;
+				pool.post_main([&]() {
+					++main_ran;
+					on_main &= std::this_thread::get_id() == main_thread;
+					});
+				});
+		}
+		pool.join_phase(TickPhase::Physics);
+		check(phase_ran.load() == 1000 && main_ran == 1000 && on_main, "joining a phase runs its jobs, and then their main thread jobs on the main thread");
+	}
+
+	// Compares one thread against the pool over a compute-bound loop, at several grain sizes.
+	static void run_scaling(WorkerPool& pool)
+	{
+		std::vector<double> data(1 << 22);
+		const auto work = [&data](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+				data[i] = std::sqrt(data[i] + 1.0) * std::sin(data[i]) + 1.0;
+			};
+
+		const double serial = time(5, [&]() { work(0, data.size()); });
+		std::cout << "  serial: " << std::fixed << std::setprecision(3) << serial * 1000.0 << " ms" << std::defaultfloat << std::endl;
+		for (size_t grain : { 256, 4096, 65536 })
+		{
+			const double parallel = time(5, [&]() { pool.parallel_for(data.size(), grain, work); });
+			std::cout << "  " << pool.concurrency() << " threads, grain " << std::setw(5) << grain << ": " << std::fixed << std::setprecision(3)
+				<< parallel * 1000.0 << " ms (" << std::setprecision(2) << serial / parallel << "x)" << std::defaultfloat << std::endl;
+		}
+		keep(data);
+	}
+
+	OLY_BENCHMARK_SUITE(worker_pool)
+	{
+		WorkerPool& pool = WorkerPool::instance();
+		stress_parallel_for(pool);
+		stress_task_groups(pool);
+		run_scaling(pool);
+	}
+}
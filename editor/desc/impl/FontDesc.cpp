@@ -29,6 +29,7 @@ namespace oly::editor
 		min_filter(GL_LINEAR, detail::Key::MinFilter, "Min filter", detail::MIN_FILTER_VALUES, detail::MIN_FILTER_NAMES),
 		mag_filter(GL_LINEAR, detail::Key::MagFilter, "Mag filter", detail::MAG_FILTER_VALUES, detail::MAG_FILTER_NAMES),
 		auto_generate_mipmaps(false, detail::Key::GenerateMipmaps, "Auto-generate mipmaps"),
+		signed_distance_field(false, detail::Key::SignedDistanceField, "Signed distance field"),
 		use_common_buffer_preset(true, detail::Key::UseCommonBufferPreset, "Use preset"),
 		common_buffer_preset(detail::CommonBufferPreset::Common, detail::Key::CommonBufferPreset, "Preset"),
 		common_buffer("", detail::Key::CommonBuffer, "Buffer")
@@ -47,7 +47,8 @@ namespace oly::editor
 		M(storage) \
 		M(min_filter) \
 		M(mag_filter) \
-		M(auto_generate_mipmaps)
+		M(auto_generate_mipmaps) \
+		M(signed_distance_field)
 
 #define FONT_ATLAS_PARTIAL_GENERATOR(M) \
 		M(font_size) \
@@ -66,6 +67,7 @@ namespace oly::editor
 		DisjointEnumField<GLenum> min_filter;
 		DisjointEnumField<GLenum> mag_filter;
 		BoolField auto_generate_mipmaps;
+		BoolField signed_distance_field;
 
 		BoolField use_common_buffer_preset;
 		EnumField<detail::CommonBufferPreset> common_buffer_preset;
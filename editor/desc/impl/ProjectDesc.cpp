@@ -76,6 +76,7 @@ namespace oly::editor
 	LoggerDesc::LoggerDesc() :
 		use_logfile(true, detail::Key::UseLogfile, "Use Logfile"),
 		use_console(true, detail::Key::UseConsole, "Use Console"),
+		async_logging(false, detail::Key::AsyncLogging, "Async Logging"),
 		max_prior_log_files(MakeOpt<int>(), detail::Key::MaxPriorLogFiles, detail::Key::EnableMaxPriorLogFiles, "Max Prior Log Files"),
 		max_prior_log_bytes(MakeOpt<int>(), detail::Key::MaxPriorLogBytes, detail::Key::EnableMaxPriorLogBytes, "Max Prior Log Bytes"),
 		enable()
@@ -152,6 +152,7 @@ namespace oly::editor
 #define LOGGER_PARTIAL_GENERATOR(M) \
 	M(use_logfile) \
 	M(use_console) \
+	M(async_logging) \
 	M(max_prior_log_files) \
 	M(max_prior_log_bytes)
 
@@ -163,6 +164,7 @@ namespace oly::editor
 	{
 		BoolField use_logfile;
 		BoolField use_console;
+		BoolField async_logging;
 		OptionalIntField<MakeOpt(0), MakeOpt<int>()> max_prior_log_files;
 		OptionalIntField<MakeOpt(0), MakeOpt<int>()> max_prior_log_bytes;
 
@@ -39,6 +39,7 @@
 #include "physics/dynamics/bodies/StaticBody.h"
 #include "physics/dynamics/bodies/LinearBody.h"
 #include "physics/dynamics/bodies/KinematicBody.h"
+#include "physics/dynamics/bodies/PhysicsStepper.h"
 
 namespace oly
 {
@@ -2,9 +2,12 @@
 
 #include "core/util/Loader.h"
 #include "core/util/Parser.h"
+#include "core/util/WorkerPool.h"
 
 #include "definitions/Keys.h"
 
+#include <algorithm>
+
 namespace oly
 {
 	void Transform2D::overload(TOMLNode node)
@@ -46,6 +49,9 @@ namespace oly
 			registry.parent.push_back(NULL_INDEX);
 			registry.index_in_parent.push_back(NULL_INDEX);
 			registry.children.push_back({});
+			registry.queued.push_back(false);
+			registry.top_dirty.push_back(NULL_INDEX);
+			registry.resolved_pass.push_back(0);
 		}
 		else
 		{
@@ -54,6 +60,7 @@ namespace oly
 			registry.index_in_parent[id] = NULL_INDEX;
 			registry.children[id].clear();
 		}
+		registry.queue(id);
 	}
 
 	void internal::Transformer2DRegistry::Handle::del()
@@ -62,7 +69,9 @@ namespace oly
 		{
 			clear_children();
 			unparent();
-			internal::Transformer2DRegistry::instance().id_generator.yield(id);
+			internal::Transformer2DRegistry& registry = internal::Transformer2DRegistry::instance();
+			registry.transformers[id] = nullptr;
+			registry.id_generator.yield(id);
 			id = NULL_INDEX;
 		}
 	}
@@ -141,6 +150,8 @@ namespace oly
 			pc.pop_back();
 			if (index_in_parent < pc.size())
 				registry.index_in_parent[pc[index_in_parent]] = index_in_parent;
+			registry.parent[id] = NULL_INDEX;
+			registry.index_in_parent[id] = NULL_INDEX;
 			registry.transformers[id]->post_set();
 		}
 	}
@@ -198,6 +209,11 @@ namespace oly
 			registry.index_in_parent[id] = pc.size();
 			pc.push_back(id);
 		}
+		else
+		{
+			registry.parent[id] = NULL_INDEX;
+			registry.index_in_parent[id] = NULL_INDEX;
+		}
 
 		registry.transformers[id]->post_set();
 	}
@@ -295,6 +311,107 @@ namespace oly
 		unparent();
 	}
 
+	void internal::Transformer2DRegistry::queue(Index id)
+	{
+		if (!queued[id])
+		{
+			queued[id] = true;
+			pending.push_back(id);
+		}
+	}
+
+	void internal::Transformer2DRegistry::update_globals()
+	{
+		if (++pass == 0)
+		{
+			std::fill(resolved_pass.begin(), resolved_pass.end(), 0);
+			pass = 1;
+		}
+
+		roots.clear();
+		for (Index id : pending)
+		{
+			queued[id] = false;
+			const Transformer2D* transformer = transformers[id];
+			if (!transformer)
+				continue;
+
+			if (transformer->_dirty_internal)
+			{
+				// descendants of a dirty transformer are always dirty, so the sweep starts from the top-most dirty ancestor. The walk stops at
+				// ancestors resolved earlier in this update, so each transformer is walked through at most once.
+				Index node = id;
+				while (resolved_pass[node] != pass && parent[node] != NULL_INDEX && transformers[parent[node]]->_dirty_internal)
+				{
+					stack.push_back(node);
+					node = parent[node];
+				}
+
+				Index root;
+				if (resolved_pass[node] == pass)
+					root = top_dirty[node];
+				else
+				{
+					root = node;
+					resolved_pass[root] = pass;
+					top_dirty[root] = root;
+					roots.push_back(root);
+				}
+
+				for (Index walked : stack)
+				{
+					resolved_pass[walked] = pass;
+					top_dirty[walked] = root;
+				}
+				stack.clear();
+			}
+			else
+			{
+				// set_global() cleans the transformer itself but not its children
+				for (Index child : children[id])
+				{
+					if (transformers[child]->_dirty_internal && resolved_pass[child] != pass)
+					{
+						resolved_pass[child] = pass;
+						top_dirty[child] = child;
+						roots.push_back(child);
+					}
+				}
+			}
+		}
+		pending.clear();
+
+		// the subtrees under distinct roots are disjoint, and each root's parent is clean
+
+		if (parallel_update.enable && roots.size() >= parallel_update.min_roots)
+		{
+			WorkerPool::instance().parallel_for(roots.size(), parallel_update.batch_size, [this](size_t begin, size_t end) {
+				std::vector<Index> local_stack;
+				for (size_t i = begin; i < end; ++i)
+					sweep(roots[i], local_stack);
+				});
+		}
+		else
+		{
+			for (Index root : roots)
+				sweep(root, stack);
+		}
+	}
+
+	void internal::Transformer2DRegistry::sweep(Index root, std::vector<Index>& nodes) const
+	{
+		nodes.push_back(root);
+		while (!nodes.empty())
+		{
+			const Index node = nodes.back();
+			nodes.pop_back();
+			transformers[node]->compute_global(parent[node] != NULL_INDEX ? transformers[parent[node]] : nullptr);
+			for (Index child : children[node])
+				if (transformers[child]->_dirty_internal)
+					nodes.push_back(child);
+		}
+	}
+
 	Transformer2D::Transformer2D(Transform2D local, Polymorphic<TransformModifier2D>&& modifier)
 		: local(local), handle(this), modifier(std::move(modifier))
 	{
@@ -346,6 +463,8 @@ namespace oly
 
 	void Transformer2D::post_set() const
 	{
+		if (handle.id != internal::Transformer2DRegistry::NULL_INDEX)
+			internal::Transformer2DRegistry::instance().queue(handle.id);
 		post_set_internal();
 		post_set_external();
 	}
@@ -367,32 +486,47 @@ namespace oly
 
 	void Transformer2D::pre_get() const
 	{
-		if (_dirty_internal)
+		if (!_dirty_internal)
+			return;
+		if (handle.id == internal::Transformer2DRegistry::NULL_INDEX)
+			throw Error(ErrorCode::InvalidID);
+
+		// dirty ancestors are collected first and then computed top-down, so that deep hierarchies don't recurse
+		internal::Transformer2DRegistry& registry = internal::Transformer2DRegistry::instance();
+		std::vector<internal::Transformer2DRegistry::Index>& chain = registry.stack;
+		const size_t base = chain.size();
+		internal::Transformer2DRegistry::Index node = handle.id;
+		while (node != internal::Transformer2DRegistry::NULL_INDEX && registry.transformers[node]->_dirty_internal)
 		{
-			_dirty_internal = false;
-			Transformer2D* parent = handle.get_parent();
-			if (parent)
-			{
-				parent->pre_get();
-				_global = local.matrix();
-				if (modifier)
-					(*modifier)(_global);
-				_global = parent->_global * _global;
-			}
-			else
-			{
-				_global = local.matrix();
-				if (modifier)
-					(*modifier)(_global);
-			}
+			chain.push_back(node);
+			node = registry.parent[node];
+		}
+
+		while (chain.size() > base)
+		{
+			node = chain.back();
+			chain.pop_back();
+			const internal::Transformer2DRegistry::Index parent = registry.parent[node];
+			registry.transformers[node]->compute_global(parent != internal::Transformer2DRegistry::NULL_INDEX ? registry.transformers[parent] : nullptr);
 		}
 	}
 
+	void Transformer2D::compute_global(const Transformer2D* parent) const
+	{
+		_dirty_internal = false;
+		_global = local.matrix();
+		if (modifier)
+			(*modifier)(_global);
+		if (parent)
+			_global = parent->_global * _global;
+	}
+
 	bool Transformer2D::flush() const
 	{
-		bool was_dirty = _dirty_external;
+		if (!_dirty_external)
+			return false;
 		_dirty_external = false;
-		return was_dirty;
+		return true;
 	}
 
 	UnitVector2D Transformer2D::forward() const
@@ -54,9 +54,12 @@ namespace oly
 		float rotation = 0.0f;
 		glm::vec2 scale = { 1.0f, 1.0f };
 
-		constexpr glm::mat3 matrix() const
+		// translation * rotation * scale, expanded so that no matrix products are needed
+		glm::mat3 matrix() const
 		{
-			return translation_matrix(position) * rotation_matrix(rotation) * scale_matrix(scale);
+			const float cos = glm::cos(rotation);
+			const float sin = glm::sin(rotation);
+			return { { cos * scale.x, sin * scale.x, 0.0f }, { -sin * scale.y, cos * scale.y, 0.0f }, glm::vec3(position, 1.0f) };
 		}
 
 		void overload(TOMLNode node);
@@ -98,6 +101,7 @@ namespace oly
 			static const Index NULL_INDEX = Index(-1);
 
 			friend class Singleton<Transformer2DRegistry>;
+			friend class oly::Transformer2D;
 			Transformer2DRegistry()
 				: id_generator(0, nmax<Index>() - 1)
 			{
@@ -108,7 +112,33 @@ namespace oly
 			std::vector<Index> index_in_parent;
 			std::vector<std::vector<Index>> children;
 
+			std::vector<Index> pending;
+			std::vector<bool> queued;
+			std::vector<Index> roots;
+			std::vector<Index> stack;
+			// top-most dirty ancestor of each transformer resolved in the current update, so that shared ancestor chains are walked once
+			std::vector<Index> top_dirty;
+			std::vector<std::uint32_t> resolved_pass;
+			std::uint32_t pass = 0;
+
+			void queue(Index id);
+			void sweep(Index root, std::vector<Index>& nodes) const;
+
 		public:
+			// Recomputes the global matrix of every transformer that was modified since the last update, so that later calls to global() don't
+			// recurse. Each modified subtree is swept once from its top-most dirty transformer, parents before children, using an explicit stack.
+			void update_globals();
+
+			// When enabled and there are at least min_roots dirty subtrees, update_globals() sweeps them on the worker pool, batch_size subtrees
+			// per job. Every global only depends on its ancestors, so the results are identical to the serial pass. Transform modifiers are then
+			// invoked from worker threads, and must not mutate state shared with other transformers.
+			struct
+			{
+				bool enable = false;
+				size_t batch_size = 16;
+				size_t min_roots = 64;
+			} parallel_update;
+
 			class Handle
 			{
 				friend class Transformer2D;
@@ -154,6 +184,7 @@ namespace oly
 
 	class Transformer2D
 	{
+		friend class internal::Transformer2DRegistry;
 		friend class internal::Transformer2DRegistry::Handle;
 
 		Transform2D local;
@@ -181,6 +212,7 @@ namespace oly
 		void post_set_internal() const;
 		void post_set_external() const;
 		void pre_get() const;
+		void compute_global(const Transformer2D* parent) const;
 
 	public:
 		bool flush() const;
@@ -1,6 +1,11 @@
 #pragma once
 
 #include <set>
+#include <vector>
+#include <bit>
+#include <cstdint>
+#include <algorithm>
+#include <concepts>
 
 namespace oly
 {
@@ -84,6 +89,117 @@ namespace oly
 		auto end() const { return ranges.end(); }
 	};
 
+	// Set of dirty indices backed by a bitset. Iteration yields the maximal runs of dirty indices in increasing order, with runs separated by at
+	// most merge_gap clean indices coalesced into one, so that dirty indices can be uploaded in a few contiguous ranges.
+	template<std::unsigned_integral T>
+	class DirtyIntervals
+	{
+		static constexpr size_t WORD_BITS = 64;
+
+		std::vector<uint64_t> words;
+		size_t first_word = 0, end_word = 0;
+
+	public:
+		T merge_gap = 0;
+
+		DirtyIntervals(T merge_gap = 0) : merge_gap(merge_gap) {}
+
+		bool empty() const { return first_word == end_word; }
+
+		void insert(T index)
+		{
+			const size_t w = index / WORD_BITS;
+			include_word(w, w + 1);
+			words[w] |= uint64_t(1) << (index % WORD_BITS);
+		}
+
+		void insert(Range<T> range)
+		{
+			if (range.length == 0)
+				return;
+
+			const size_t begin = range.initial, end = (size_t)range.initial + range.length;
+			const size_t w0 = begin / WORD_BITS, w1 = (end - 1) / WORD_BITS;
+			include_word(w0, w1 + 1);
+
+			const uint64_t head = ~uint64_t(0) << (begin % WORD_BITS);
+			const uint64_t tail = ~uint64_t(0) >> (WORD_BITS - 1 - (end - 1) % WORD_BITS);
+			if (w0 == w1)
+				words[w0] |= head & tail;
+			else
+			{
+				words[w0] |= head;
+				std::fill(words.begin() + w0 + 1, words.begin() + w1, ~uint64_t(0));
+				words[w1] |= tail;
+			}
+		}
+
+		bool contains(T index) const
+		{
+			const size_t w = index / WORD_BITS;
+			return w < words.size() && (words[w] >> (index % WORD_BITS)) & 1;
+		}
+
+		// only clears the words that may be dirty
+		void clear()
+		{
+			std::fill(words.begin() + first_word, words.begin() + end_word, 0);
+			first_word = end_word = 0;
+		}
+
+		template<typename Func>
+		void for_each(Func func) const
+		{
+			bool open = false;
+			size_t run_begin = 0, run_end = 0;
+			for (size_t w = first_word; w < end_word; ++w)
+			{
+				uint64_t bits = words[w];
+				size_t offset = 0;
+				while (bits)
+				{
+					const int zeros = std::countr_zero(bits);
+					bits >>= zeros;
+					offset += zeros;
+					const int ones = std::countr_one(bits);
+					bits = ones < (int)WORD_BITS ? bits >> ones : 0;
+
+					const size_t begin = w * WORD_BITS + offset;
+					offset += ones;
+					if (open && begin <= run_end + merge_gap)
+						run_end = begin + ones;
+					else
+					{
+						if (open)
+							func(Range<T>{ (T)run_begin, (T)(run_end - run_begin) });
+						open = true;
+						run_begin = begin;
+						run_end = begin + ones;
+					}
+				}
+			}
+			if (open)
+				func(Range<T>{ (T)run_begin, (T)(run_end - run_begin) });
+		}
+
+	private:
+		void include_word(size_t begin, size_t end)
+		{
+			if (end > words.size())
+				words.resize(std::max(end, 2 * words.size()), 0);
+			if (empty())
+			{
+				first_word = begin;
+				end_word = end;
+			}
+			else
+			{
+				first_word = std::min(first_word, begin);
+				end_word = std::max(end_word, end);
+			}
+		}
+	};
+
 	template<typename T>
 	struct Interval
 	{
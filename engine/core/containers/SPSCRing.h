@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <new>
+
+namespace oly
+{
+	// Bounded lock-free queue between exactly one producer thread and one consumer thread. Capacity is rounded up to a power of two.
+	template<typename T>
+	class SPSCRing
+	{
+		std::vector<T> slots;
+		size_t mask;
+		alignas(64) std::atomic<size_t> head = 0;
+		alignas(64) std::atomic<size_t> tail = 0;
+
+		static size_t round_capacity(size_t capacity)
+		{
+			size_t rounded = 1;
+			while (rounded < capacity)
+				rounded <<= 1;
+			return rounded;
+		}
+
+	public:
+		SPSCRing(size_t capacity)
+			: slots(round_capacity(capacity)), mask(slots.size() - 1)
+		{
+		}
+
+		SPSCRing(const SPSCRing&) = delete;
+		SPSCRing& operator=(const SPSCRing&) = delete;
+
+		size_t capacity() const { return slots.size(); }
+		size_t size() const { return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire); }
+		bool empty() const { return size() == 0; }
+
+		// producer only
+		bool try_push(T&& value)
+		{
+			const size_t t = tail.load(std::memory_order_relaxed);
+			if (t - head.load(std::memory_order_acquire) == slots.size())
+				return false;
+			slots[t & mask] = std::move(value);
+			tail.store(t + 1, std::memory_order_release);
+			return true;
+		}
+
+		// consumer only
+		bool try_pop(T& value)
+		{
+			const size_t h = head.load(std::memory_order_relaxed);
+			if (h == tail.load(std::memory_order_acquire))
+				return false;
+			value = std::move(slots[h & mask]);
+			head.store(h + 1, std::memory_order_release);
+			return true;
+		}
+	};
+}
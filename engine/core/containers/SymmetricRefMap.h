@@ -1,11 +1,15 @@
 #pragma once
 
-#include <unordered_map>
-#include <unordered_set>
+#include <vector>
 #include <optional>
+#include <algorithm>
+#include <cstdint>
 
 namespace oly
 {
+	// Maps unordered pairs of key references to values. Entries live in a pooled array and are indexed by an open-addressing table,
+	// and each key threads an intrusive list through the entries it belongs to, so per-key operations don't need a separate lookup table.
+	// Storage is retained across clear(), so a map that has reached its steady-state size no longer allocates.
 	template<typename Key, typename Value>
 	class SymmetricRefMap
 	{
@@ -18,108 +22,316 @@ namespace oly
 			bool operator==(const UnorderedPair& other) const { return (k1 == other.k1 && k2 == other.k2) || (k1 == other.k2 && k2 == other.k1); }
 		};
 
-		struct UnorderedPairHash
+	private:
+		static constexpr unsigned int NONE = ~0u;
+		static constexpr unsigned int TOMBSTONE = ~0u - 1;
+
+		struct Entry
+		{
+			const Key* keys[2] = { nullptr, nullptr };
+			std::optional<Value> value;
+			unsigned int next[2] = { NONE, NONE };
+			unsigned int prev[2] = { NONE, NONE };
+
+			unsigned int side(const Key* k) const { return keys[0] == k ? 0 : 1; }
+			unsigned int sides() const { return keys[0] == keys[1] ? 1 : 2; }
+		};
+
+		struct Head
 		{
-			size_t operator()(const UnorderedPair& pair) const { return std::hash<const void*>{}(pair.k1) ^ std::hash<const void*>{}(pair.k2); }
+			const Key* key = nullptr;
+			unsigned int entry = NONE;
 		};
 
-		using MapType = std::unordered_map<UnorderedPair, Value, UnorderedPairHash>;
+		std::vector<Entry> entries;
+		unsigned int free_entries = NONE;
+		size_t count = 0;
 
-	private:
-		MapType map;
-		std::unordered_map<const Key*, std::unordered_set<const Key*>> lut;
+		// entry indices, or NONE/TOMBSTONE
+		std::vector<unsigned int> slots;
+		size_t used_slots = 0;
+
+		// first entry of each key's list - key == nullptr marks an empty head, and entry == TOMBSTONE a removed one
+		std::vector<Head> heads;
+		size_t used_heads = 0;
+
+		static size_t hash(const Key* k1, const Key* k2)
+		{
+			const uintptr_t a = (uintptr_t)(k1 < k2 ? k1 : k2);
+			const uintptr_t b = (uintptr_t)(k1 < k2 ? k2 : k1);
+			uint64_t h = (uint64_t)a * 0x9E3779B97F4A7C15ull;
+			h ^= (uint64_t)b + 0x632BE59BD9B4E019ull + (h << 6) + (h >> 2);
+			return (size_t)(h ^ (h >> 29));
+		}
+
+		static size_t hash(const Key* k)
+		{
+			const uint64_t h = (uint64_t)(uintptr_t)k * 0x9E3779B97F4A7C15ull;
+			return (size_t)(h ^ (h >> 29));
+		}
+
+		size_t find_slot(const Key* k1, const Key* k2) const
+		{
+			if (slots.empty())
+				return NONE;
+
+			const size_t mask = slots.size() - 1;
+			for (size_t i = hash(k1, k2) & mask;; i = (i + 1) & mask)
+			{
+				const unsigned int e = slots[i];
+				if (e == NONE)
+					return NONE;
+				else if (e != TOMBSTONE && UnorderedPair{ entries[e].keys[0], entries[e].keys[1] } == UnorderedPair{ k1, k2 })
+					return i;
+			}
+		}
+
+		size_t find_head(const Key* k) const
+		{
+			if (heads.empty())
+				return NONE;
+
+			const size_t mask = heads.size() - 1;
+			for (size_t i = hash(k) & mask;; i = (i + 1) & mask)
+			{
+				if (!heads[i].key)
+					return NONE;
+				else if (heads[i].key == k && heads[i].entry != TOMBSTONE)
+					return i;
+			}
+		}
+
+		void place_slot(unsigned int e)
+		{
+			const size_t mask = slots.size() - 1;
+			size_t i = hash(entries[e].keys[0], entries[e].keys[1]) & mask;
+			while (slots[i] != NONE && slots[i] != TOMBSTONE)
+				i = (i + 1) & mask;
+			if (slots[i] == NONE)
+				++used_slots;
+			slots[i] = e;
+		}
+
+		void place_head(const Key* k, unsigned int e)
+		{
+			const size_t mask = heads.size() - 1;
+			size_t i = hash(k) & mask;
+			while (heads[i].key && heads[i].entry != TOMBSTONE)
+				i = (i + 1) & mask;
+			if (!heads[i].key)
+				++used_heads;
+			heads[i] = { .key = k, .entry = e };
+		}
+
+		static size_t table_capacity(size_t n)
+		{
+			size_t capacity = 16;
+			while (capacity * 3 < n * 4)
+				capacity <<= 1;
+			return capacity;
+		}
+
+		// tombstones are flushed by rebuilding in place, and the table only reallocates when live entries outgrow it
+		void reserve_slot()
+		{
+			if ((used_slots + 1) * 4 < slots.size() * 3)
+				return;
 
-		void map_insert(UnorderedPair pair, const Value& value)
+			const size_t capacity = table_capacity(2 * (count + 1));
+			slots.assign(std::max(capacity, slots.size()), NONE);
+			used_slots = 0;
+			for (unsigned int e = 0; e < entries.size(); ++e)
+				if (entries[e].value)
+					place_slot(e);
+		}
+
+		void reserve_head()
+		{
+			if ((used_heads + 2) * 4 < heads.size() * 3)
+				return;
+
+			const size_t capacity = table_capacity(2 * (count + 1));
+			heads.assign(std::max(capacity, heads.size()), Head{});
+			used_heads = 0;
+			for (unsigned int e = 0; e < entries.size(); ++e)
+				if (entries[e].value)
+					for (unsigned int s = 0; s < entries[e].sides(); ++s)
+						if (entries[e].prev[s] == NONE)
+							place_head(entries[e].keys[s], e);
+		}
+
+		void link(unsigned int e, unsigned int s)
 		{
-			if constexpr (std::is_copy_assignable_v<Value>)
-				map[pair] = value;
+			const Key* k = entries[e].keys[s];
+			const size_t h = find_head(k);
+			if (h == NONE)
+				place_head(k, e);
 			else
 			{
-				auto er = map.find(pair);
-				if (er != map.end())
-					map.erase(er);
-				map.emplace(pair, value);
+				const unsigned int old = heads[h].entry;
+				entries[old].prev[entries[old].side(k)] = e;
+				entries[e].next[s] = old;
+				heads[h].entry = e;
 			}
 		}
 
+		void unlink(unsigned int e, unsigned int s)
+		{
+			Entry& entry = entries[e];
+			const Key* k = entry.keys[s];
+			if (entry.prev[s] != NONE)
+				entries[entry.prev[s]].next[entries[entry.prev[s]].side(k)] = entry.next[s];
+			else
+			{
+				const size_t h = find_head(k);
+				if (entry.next[s] != NONE)
+					heads[h].entry = entry.next[s];
+				else
+					heads[h].entry = TOMBSTONE;
+			}
+			if (entry.next[s] != NONE)
+				entries[entry.next[s]].prev[entries[entry.next[s]].side(k)] = entry.prev[s];
+			entry.next[s] = NONE;
+			entry.prev[s] = NONE;
+		}
+
+		unsigned int insert_entry(const Key* k1, const Key* k2, const Value& value)
+		{
+			reserve_slot();
+			reserve_head();
+
+			unsigned int e;
+			if (free_entries != NONE)
+			{
+				e = free_entries;
+				free_entries = entries[e].next[0];
+				entries[e].next[0] = NONE;
+			}
+			else
+			{
+				e = (unsigned int)entries.size();
+				entries.emplace_back();
+			}
+
+			entries[e].keys[0] = k1;
+			entries[e].keys[1] = k2;
+			entries[e].value.emplace(value);
+			++count;
+			place_slot(e);
+			for (unsigned int s = 0; s < entries[e].sides(); ++s)
+				link(e, s);
+			return e;
+		}
+
+		void erase_entry(size_t slot)
+		{
+			const unsigned int e = slots[slot];
+			slots[slot] = TOMBSTONE;
+			for (unsigned int s = 0; s < entries[e].sides(); ++s)
+				unlink(e, s);
+			entries[e].value.reset();
+			entries[e].keys[0] = nullptr;
+			entries[e].keys[1] = nullptr;
+			entries[e].next[0] = free_entries;
+			free_entries = e;
+			--count;
+		}
+
+		void map_insert(const Key* k1, const Key* k2, const Value& value)
+		{
+			const size_t slot = find_slot(k1, k2);
+			if (slot != NONE)
+				entries[slots[slot]].value.emplace(value);
+			else
+				insert_entry(k1, k2, value);
+		}
+
 	public:
-		void clear() { map.clear(); lut.clear(); }
+		void clear()
+		{
+			entries.clear();
+			free_entries = NONE;
+			count = 0;
+			if (used_slots)
+			{
+				std::fill(slots.begin(), slots.end(), NONE);
+				used_slots = 0;
+			}
+			if (used_heads)
+			{
+				std::fill(heads.begin(), heads.end(), Head{});
+				used_heads = 0;
+			}
+		}
+
+		size_t size() const { return count; }
 
 		std::optional<Value> get(const Key& k1, const Key& k2) const
 		{
-			auto it = map.find({ &k1, &k2 });
-			if (it != map.end())
-				return it->second;
+			const size_t slot = find_slot(&k1, &k2);
+			if (slot != NONE)
+				return entries[slots[slot]].value;
 			else
 				return std::nullopt;
 		}
 
 		Value get_or(const Key& k1, const Key& k2, const Value& default_value)
 		{
-			auto it = map.find({ &k1, &k2 });
-			if (it != map.end())
-				return it->second;
+			const size_t slot = find_slot(&k1, &k2);
+			if (slot != NONE)
+				return *entries[slots[slot]].value;
 			else
 			{
-				set(k1, k2, default_value);
+				insert_entry(&k1, &k2, default_value);
 				return default_value;
 			}
 		}
 
 		void set(const Key& k1, const Key& k2, const Value& value)
 		{
-			map_insert({ &k1, &k2 }, value);
-			lut[&k1].insert(&k2);
-			lut[&k2].insert(&k1);
+			map_insert(&k1, &k2, value);
 		}
 
 		void set(const UnorderedPair& pair, const Value& value)
 		{
-			map_insert(pair, value);
-			lut[pair.k1].insert(pair.k2);
-			lut[pair.k2].insert(pair.k1);
+			map_insert(pair.k1, pair.k2, value);
 		}
 
 		void copy_all(const Key& from, const Key& to)
 		{
-			auto it = lut.find(&from);
-			if (it != lut.end())
+			const size_t h = find_head(&from);
+			if (h == NONE)
+				return;
+
+			// new entries are linked at the head of each list, so walking forward only visits the original entries
+			for (unsigned int e = heads[h].entry; e != NONE;)
 			{
-				auto& lut_og = it->second;
-				auto& lut_copy = lut[&to];
-				for (const Key* k : lut_og)
-				{
-					lut_copy.insert(k);
-					map_insert({ &to, k }, map.find({ &from, k })->second);
-				}
+				const unsigned int s = entries[e].side(&from);
+				const Key* k = entries[e].keys[1 - s];
+				const Value value = *entries[e].value;
+				map_insert(&to, k == &from ? &to : k, value);
+				e = entries[e].next[s];
 			}
 		}
 
 		void replace_all(const Key& at, const Key& with)
 		{
-			auto it = lut.find(&with);
-			if (it != lut.end())
+			for (size_t h = find_head(&with); h != NONE; h = find_head(&with))
 			{
-				auto& lut_og = it->second;
-				auto& lut_copy = lut[&at];
-				for (const Key* k : lut_og)
-				{
-					lut_copy.insert(k);
-					map_insert({ &at, k }, map.find({ &with, k })->second);
-					map.erase({ &with, k });
-				}
-				lut.erase(&with);
+				const unsigned int e = heads[h].entry;
+				const Key* k = entries[e].keys[1 - entries[e].side(&with)];
+				const Value value = *entries[e].value;
+				erase_entry(find_slot(&with, k));
+				map_insert(&at, k == &with ? &at : k, value);
 			}
 		}
 
 		void erase_all(const Key& k)
 		{
-			auto it = lut.find(&k);
-			if (it != lut.end())
+			for (size_t h = find_head(&k); h != NONE; h = find_head(&k))
 			{
-				for (const Key* col : it->second)
-					map.erase({ &k, col });
-				lut.erase(it);
+				const unsigned int e = heads[h].entry;
+				erase_entry(find_slot(entries[e].keys[0], entries[e].keys[1]));
 			}
 		}
 	};
@@ -23,6 +23,9 @@
 #include "graphics/sprites/SpriteAtlas.h"
 #include "graphics/particles/ParticleSystem.h"
 #include "physics/dynamics/bodies/RigidBody.h"
+#include "physics/dynamics/bodies/PhysicsStepper.h"
+#include "physics/collision/scene/dispatch/CollisionDispatcher.h"
+#include "physics/collision/scene/luts/LUT.h"
 
 #include "definitions/Keys.h"
 
@@ -41,6 +44,7 @@ namespace oly::context
 		{
 			logger_parser->optional(detail::Key::UseLogfile)(options.use_logfile);
 			logger_parser->optional(detail::Key::UseConsole)(options.use_console);
+			logger_parser->optional(detail::Key::AsyncLogging)(options.async);
 			if (logger_parser->defaulted(detail::Key::EnableMaxPriorLogFiles)(false))
 				logger_parser->optional(detail::Key::MaxPriorLogFiles)(options.max_prior_log_files);
 			if (logger_parser->defaulted(detail::Key::EnableMaxPriorLogBytes)(false))
@@ -78,6 +82,14 @@ namespace oly::context
 		}
 	};
 
+	struct HeadlessTerminationFinalization
+	{
+		void operator()() const
+		{
+			oly::internal::LogAccess::end_log();
+		}
+	};
+
 	static void init(const char* project_file, const std::string& resource_root)
 	{
 		if (glfwInit() != GLFW_TRUE)
@@ -107,6 +119,7 @@ namespace oly::context
 		internal::init_viewport(toml_context);
 		internal::init_vault();
 
+		internal::init_rendering();
 		internal::init_textures();
 		internal::init_sprites();
 		internal::init_fonts();
@@ -131,6 +144,32 @@ namespace oly::context
 		active_context = false;
 	}
 
+	HeadlessContext::HeadlessContext(const LoggerOptions& logger_options)
+	{
+		if (active_context)
+			throw Error(ErrorCode::ContextInit, "Context was already initialized");
+
+		active_context = true;
+		oly::internal::LogAccess::start_log(logger_options);
+		SingletonTickService<TickPhase::None, void, TerminatePhase::Finalization, HeadlessTerminationFinalization>::instance();
+
+		col2d::internal::load_luts();
+		col2d::CollisionDispatcher::instance();
+		physics::PhysicsStepper::instance();
+	}
+
+	HeadlessContext::~HeadlessContext()
+	{
+		internal::TickServiceRegistry::instance().terminate();
+		active_context = false;
+	}
+
+	void HeadlessContext::tick(double delta) const
+	{
+		TIME.advance(delta);
+		internal::TickServiceRegistry::instance().tick();
+	}
+
 	namespace internal
 	{
 		bool render_frame()
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/base/SimpleMath.h"
+#include "core/util/Logger.h"
 
 namespace oly::context
 {
@@ -13,6 +14,20 @@ namespace oly::context
 		~Context();
 	};
 
+	// Context without a window, graphics or resources, for running collision dispatch and rigid bodies in tools and benchmarks.
+	// Game time only advances through tick(), so a scenario replays identically regardless of how long each tick takes.
+	class HeadlessContext
+	{
+	public:
+		HeadlessContext(const LoggerOptions& logger_options = { .use_logfile = false });
+		HeadlessContext(const HeadlessContext&) = delete;
+		HeadlessContext(HeadlessContext&&) noexcept = delete;
+		~HeadlessContext();
+
+		// advances game time by delta seconds and ticks every service once
+		void tick(double delta) const;
+	};
+
 	namespace internal
 	{
 		extern bool render_frame();
@@ -1,60 +1,162 @@
 #include "TickService.h"
 
+#include "core/util/Time.h"
+#include "core/util/WorkerPool.h"
+
+#include <algorithm>
+
 namespace oly
 {
+	void context::internal::TickServiceRegistry::Phase::add(ITickService* service, size_t ITickService::* slot)
+	{
+		service->*slot = services.size();
+		services.push_back(service);
+		grouped_dirty = true;
+	}
+
+	void context::internal::TickServiceRegistry::Phase::remove(size_t slot)
+	{
+		services[slot] = nullptr;
+		++holes;
+		grouped_dirty = true;
+	}
+
+	void context::internal::TickServiceRegistry::Phase::compact(size_t ITickService::* slot)
+	{
+		if (holes == 0)
+			return;
+
+		size_t live = 0;
+		for (ITickService* service : services)
+		{
+			if (service)
+			{
+				service->*slot = live;
+				services[live++] = service;
+			}
+		}
+		services.resize(live);
+		holes = 0;
+		grouped_dirty = true;
+	}
+
+	void context::internal::TickServiceRegistry::Phase::clear(size_t ITickService::* slot)
+	{
+		for (ITickService* service : services)
+			if (service)
+				service->*slot = -1;
+		services.clear();
+		holes = 0;
+		grouped_slots.clear();
+		grouped_dirty = true;
+	}
+
+	void context::internal::TickServiceRegistry::build_grouped_slots(Phase& phase)
+	{
+		std::vector<std::pair<size_t, size_t>> keyed;
+		keyed.reserve(phase.services.size());
+		for (size_t i = 0; i < phase.services.size(); ++i)
+		{
+			if (ITickService* service = phase.services[i])
+			{
+				auto group = type_groups.try_emplace(std::type_index(typeid(*service)), type_groups.size()).first->second;
+				keyed.emplace_back(group, i);
+			}
+		}
+		std::stable_sort(keyed.begin(), keyed.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+		phase.grouped_slots.clear();
+		for (const auto& [group, slot] : keyed)
+			phase.grouped_slots.push_back(slot);
+		phase.grouped_dirty = false;
+	}
+
 	void context::internal::TickServiceRegistry::tick()
 	{
-		for (auto& service_set : tick_services)
-			for (ITickService* service : service_set)
-				if (service->auto_tick) [[likely]]
-					service->on_tick();
+		Stopwatch stopwatch;
+		for (size_t p = 0; p < tick_phases.size(); ++p)
+		{
+			Phase& phase = tick_phases[p];
+			phase.compact(&ITickService::tick_slot);
+
+			if (grouped)
+			{
+				if (phase.grouped_dirty)
+					build_grouped_slots(phase);
+				// services registered during the phase are not grouped yet, and tick from the next frame
+				for (size_t slot : phase.grouped_slots)
+					if (ITickService* service = phase.services[slot]; service && service->auto_tick) [[likely]]
+						service->on_tick();
+			}
+			else
+			{
+				const size_t count = phase.services.size();
+				for (size_t slot = 0; slot < count; ++slot)
+					if (ITickService* service = phase.services[slot]; service && service->auto_tick) [[likely]]
+						service->on_tick();
+			}
+
+			// jobs the phase fanned out are joined before the next phase - phase jobs and main thread jobs can only be posted once the pool exists
+			if (WorkerPool::exists())
+				WorkerPool::instance().join_phase((TickPhase)p);
+
+			if (profiling)
+				profile.phase_seconds[p] += stopwatch.lap();
+		}
+		if (profiling)
+			++profile.ticks;
 	}
 
 	void context::internal::TickServiceRegistry::terminate()
 	{
-		for (auto& service_set : terminate_services)
-			for (ITickService* service : service_set)
-				service->on_terminate();
+		for (Phase& phase : terminate_phases)
+		{
+			phase.compact(&ITickService::terminate_slot);
+			const size_t count = phase.services.size();
+			for (size_t slot = 0; slot < count; ++slot)
+				if (ITickService* service = phase.services[slot])
+					service->on_terminate();
+		}
 
-		for (auto& service_set : tick_services)
-			service_set.clear();
+		for (Phase& phase : tick_phases)
+			phase.clear(&ITickService::tick_slot);
 
-		for (auto& service_set : terminate_services)
-			service_set.clear();
+		for (Phase& phase : terminate_phases)
+			phase.clear(&ITickService::terminate_slot);
 	}
 
 	ITickService::ITickService(TickPhase tick_phase, TerminatePhase terminate_phase)
 		: tick_phase(tick_phase), terminate_phase(terminate_phase)
 	{
 		if (tick_phase != TickPhase::None)
-			context::internal::TickServiceRegistry::instance().tick_services[(size_t)tick_phase].insert(this);
+			context::internal::TickServiceRegistry::instance().tick_phases[(size_t)tick_phase].add(this, &ITickService::tick_slot);
 		if (terminate_phase != TerminatePhase::None)
-			context::internal::TickServiceRegistry::instance().terminate_services[(size_t)terminate_phase].insert(this);
+			context::internal::TickServiceRegistry::instance().terminate_phases[(size_t)terminate_phase].add(this, &ITickService::terminate_slot);
 	}
 
 	ITickService::ITickService(const ITickService& other)
 		: tick_phase(other.tick_phase), terminate_phase(other.terminate_phase)
 	{
 		if (tick_phase != TickPhase::None)
-			context::internal::TickServiceRegistry::instance().tick_services[(size_t)tick_phase].insert(this);
+			context::internal::TickServiceRegistry::instance().tick_phases[(size_t)tick_phase].add(this, &ITickService::tick_slot);
 		if (terminate_phase != TerminatePhase::None)
-			context::internal::TickServiceRegistry::instance().terminate_services[(size_t)terminate_phase].insert(this);
+			context::internal::TickServiceRegistry::instance().terminate_phases[(size_t)terminate_phase].add(this, &ITickService::terminate_slot);
 	}
 
 	ITickService::ITickService(ITickService&& other) noexcept
 		: tick_phase(other.tick_phase), terminate_phase(other.terminate_phase)
 	{
 		if (tick_phase != TickPhase::None)
-			context::internal::TickServiceRegistry::instance().tick_services[(size_t)tick_phase].insert(this);
+			context::internal::TickServiceRegistry::instance().tick_phases[(size_t)tick_phase].add(this, &ITickService::tick_slot);
 		if (terminate_phase != TerminatePhase::None)
-			context::internal::TickServiceRegistry::instance().terminate_services[(size_t)terminate_phase].insert(this);
+			context::internal::TickServiceRegistry::instance().terminate_phases[(size_t)terminate_phase].add(this, &ITickService::terminate_slot);
 	}
 
 	ITickService::~ITickService()
 	{
-		if (tick_phase != TickPhase::None)
-			context::internal::TickServiceRegistry::instance().tick_services[(size_t)tick_phase].erase(this);
-		if (terminate_phase != TerminatePhase::None)
-			context::internal::TickServiceRegistry::instance().terminate_services[(size_t)terminate_phase].erase(this);
+		if (tick_slot != size_t(-1))
+			context::internal::TickServiceRegistry::instance().tick_phases[(size_t)tick_phase].remove(tick_slot);
+		if (terminate_slot != size_t(-1))
+			context::internal::TickServiceRegistry::instance().terminate_phases[(size_t)terminate_phase].remove(terminate_slot);
 	}
 }
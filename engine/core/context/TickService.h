@@ -2,7 +2,9 @@
 
 #include "core/types/AutoRegistry.h"
 
-#include <unordered_set>
+#include <unordered_map>
+#include <typeindex>
+#include <vector>
 #include <array>
 #include <functional>
 
@@ -39,21 +41,63 @@ namespace oly
 		{
 			friend class Singleton<TickServiceRegistry>;
 
-			friend struct ITickService;
-			std::array<std::unordered_set<ITickService*>, (size_t)TickPhase::None> tick_services;
-			std::array<std::unordered_set<ITickService*>, (size_t)TerminatePhase::None> terminate_services;
+			// Services are kept in registration order. Unregistering nulls the service's slot through its stored index, and the slots are compacted
+			// before the phase next runs, so services may be created or destroyed while a phase is ticking.
+			struct Phase
+			{
+				std::vector<ITickService*> services;
+				size_t holes = 0;
+				std::vector<size_t> grouped_slots;
+				bool grouped_dirty = true;
+
+				void add(ITickService* service, size_t ITickService::* slot);
+				void remove(size_t slot);
+				void compact(size_t ITickService::* slot);
+				void clear(size_t ITickService::* slot);
+				size_t size() const { return services.size() - holes; }
+			};
+
+			friend struct oly::ITickService;
+			std::array<Phase, (size_t)TickPhase::None> tick_phases;
+			std::array<Phase, (size_t)TerminatePhase::None> terminate_phases;
+			std::unordered_map<std::type_index, size_t> type_groups;
 
 		public:
+			// Tick services of the same concrete type back to back within each phase, with types in order of their first registration.
+			bool grouped = false;
+
+			// Wall-clock seconds spent in each tick phase, accumulated over ticks while profiling is enabled.
+			struct Profile
+			{
+				std::array<double, (size_t)TickPhase::None> phase_seconds = {};
+				size_t ticks = 0;
+			};
+
+			bool profiling = false;
+			const Profile& get_profile() const { return profile; }
+			void reset_profile() { profile = {}; }
+
+			size_t service_count(TickPhase phase) const { return tick_phases[(size_t)phase].size(); }
+			size_t service_count(TerminatePhase phase) const { return terminate_phases[(size_t)phase].size(); }
+
 			void tick();
 			void terminate();
+
+		private:
+			Profile profile;
+
+			void build_grouped_slots(Phase& phase);
 		};
 	}
 
 	struct ITickService
 	{
 	private:
+		friend class context::internal::TickServiceRegistry;
 		TickPhase tick_phase;
 		TerminatePhase terminate_phase;
+		size_t tick_slot = -1;
+		size_t terminate_slot = -1;
 
 	public:
 		bool auto_tick = true;
@@ -62,6 +106,9 @@ namespace oly
 		ITickService(const ITickService&);
 		ITickService(ITickService&&) noexcept;
 		~ITickService();
+		// registration stays with the assigned-to service
+		ITickService& operator=(const ITickService& other) { auto_tick = other.auto_tick; return *this; }
+		ITickService& operator=(ITickService&& other) noexcept { auto_tick = other.auto_tick; return *this; }
 
 		virtual void on_tick() {}
 		virtual void on_terminate() {}
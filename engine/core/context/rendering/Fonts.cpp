@@ -49,6 +49,7 @@ namespace oly::context
 			internal::font_atlases.clear();
 			internal::raster_fonts.clear();
 			internal::font_families.clear();
+			rendering::GlyphAtlas::instance().clear();
 		}
 	};
 
@@ -166,6 +167,7 @@ namespace oly::context
 		parser.required(detail::Key::MinFilter)(options.min_filter);
 		parser.required(detail::Key::MagFilter)(options.mag_filter);
 		parser.optional(detail::Key::GenerateMipmaps)(options.auto_generate_mipmaps);
+		parser.optional(detail::Key::SignedDistanceField)(options.sdf);
 
 		utf::String common_buffer;
 		auto _common_buffer = parser.optional<std::string>(detail::Key::CommonBuffer)();
@@ -1,6 +1,9 @@
 #include "Rendering.h"
 
 #include "core/context/rendering/Sprites.h"
+#include "core/context/TickService.h"
+#include "core/base/Transforms.h"
+#include "graphics/backend/basic/FenceSync.h"
 
 namespace oly::context
 {
@@ -9,6 +12,19 @@ namespace oly::context
 		const IRenderPipeline* pipeline = nullptr;
 	}
 
+	struct RenderingOnTerminate
+	{
+		void operator()() const
+		{
+			graphics::FrameFenceRing::instance().clear();
+		}
+	};
+
+	void internal::init_rendering()
+	{
+		SingletonTickService<TickPhase::None, void, TerminatePhase::Graphics, RenderingOnTerminate>::instance();
+	}
+
 	void set_render_pipeline(const IRenderPipeline* pipeline)
 	{
 		internal::pipeline = pipeline;
@@ -16,9 +32,13 @@ namespace oly::context
 
 	void internal::render_pipeline()
 	{
+		graphics::FrameFenceRing& frame_fences = graphics::FrameFenceRing::instance();
+		frame_fences.begin_frame();
+		oly::internal::Transformer2DRegistry::instance().update_globals();
 		if (internal::pipeline)
 			internal::pipeline->render();
 		render_sprites();
+		frame_fences.end_frame();
 	}
 
 	bool blend_enabled()
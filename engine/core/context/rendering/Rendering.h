@@ -16,6 +16,7 @@ namespace oly::context
 	
 	namespace internal
 	{
+		extern void init_rendering();
 		extern void render_pipeline();
 	}
 
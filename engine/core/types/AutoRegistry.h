@@ -18,10 +18,13 @@ namespace oly
 
 			friend class AutoRegistrable<T>;
 			std::unordered_set<T*> _tracked;
+			unsigned long long _version = 0;
 
 		public:
-			void clear() { _tracked.clear(); }
+			void clear() { _tracked.clear(); ++_version; }
 			const std::unordered_set<T*>& tracked() const { return _tracked; }
+			// changes whenever an object is registered or unregistered
+			unsigned long long version() const { return _version; }
 		};
 	}
 
@@ -32,21 +35,25 @@ namespace oly
 		AutoRegistrable()
 		{
 			registry()._tracked.insert(static_cast<T*>(this));
+			++registry()._version;
 		}
 
 		AutoRegistrable(const AutoRegistrable&)
 		{
 			registry()._tracked.insert(static_cast<T*>(this));
+			++registry()._version;
 		}
 
 		AutoRegistrable(AutoRegistrable&&) noexcept
 		{
 			registry()._tracked.insert(static_cast<T*>(this));
+			++registry()._version;
 		}
 
 		~AutoRegistrable()
 		{
 			registry()._tracked.erase(static_cast<T*>(this));
+			++registry()._version;
 		}
 
 		static internal::AutoRegistry<T>& registry() { return internal::AutoRegistry<T>::instance(); }
@@ -5,9 +5,9 @@
 #include "core/algorithms/STLUtils.h"
 #include "core/context/TickService.h"
 
-#include <stack>
-#include <unordered_set>
+#include <vector>
 #include <memory>
+#include <cstdint>
 
 namespace oly
 {
@@ -68,186 +68,186 @@ namespace oly
 			}
 		};
 
-		struct SmartReferenceLink
-		{
-			SmartReferenceLink* prev = nullptr;
-			SmartReferenceLink* next = nullptr;
-		};
-
+		// Objects of exactly the pool's type are constructed in fixed-size slabs that never move, and derived objects sharing the pool are allocated
+		// individually. References are handles whose generation must match their slot's, so freeing a slot invalidates every reference to it at once.
 		// TODO v13 multi-threading and thread safety: smart reference should have some kind of lock() similar to Issuer<T>::Handle.
 		template<typename Object>
 		class SmartReferencePool final : public Singleton<SmartReferencePool<Object>>, public IPool
 		{
 			friend class Singleton<SmartReferencePool<Object>>;
 
-			std::vector<std::unique_ptr<Object>> objects;
-			std::stack<size_t> unoccupied;
-			std::unordered_set<size_t> marked_for_deletion;
-			std::vector<SmartReferenceLink*> reference_heads;
-			std::vector<std::pair<void(*)(Object&, void*), void*>> on_delete_callbacks;
+			static constexpr size_t SLAB_SIZE = 64;
+
+			struct alignas(Object) Storage
+			{
+				std::byte bytes[sizeof(Object)];
+			};
+
+			// checked on every dereference and copy, so kept apart from the rest of the slot
+			struct Header
+			{
+				std::uint32_t generation = 0;
+				std::uint32_t references = 0;
+			};
+
+			struct Slot
+			{
+				Object* object = nullptr;
+				bool in_slab = false;
+				bool marked = false;
+				void(*on_delete)(Object&, void*) = nullptr;
+				void* on_delete_usr = nullptr;
+			};
+
+			std::vector<std::unique_ptr<Storage[]>> slabs;
+			std::vector<Header> headers;
+			std::vector<Slot> slots;
+			std::vector<size_t> unoccupied;
+			std::vector<size_t> marked_for_deletion;
+			std::vector<size_t> cleaning;
 
 			~SmartReferencePool() { clear(); }
 
 		public:
 			void clean() override
 			{
-				for (size_t idx : marked_for_deletion)
-				{
-					while (reference_heads[idx])
-					{
-						reference_heads[idx]->prev = nullptr;
-						SmartReferenceLink* next = reference_heads[idx]->next;
-						reference_heads[idx]->next = nullptr;
-						reference_heads[idx] = next;
-					}
-					objects[idx] = nullptr;
-					on_delete_callbacks[idx] = { nullptr, nullptr };
-				}
-
-				marked_for_deletion.clear();
+				// marked slots are freed regardless of their references, which become invalid through the generation bump. Slots marked by
+				// destructors during the sweep go to the other buffer, and both buffers keep their capacity across ticks.
+				cleaning.swap(marked_for_deletion);
+				for (size_t idx : cleaning)
+					if (slots[idx].marked)
+						free_slot(idx);
+				cleaning.clear();
 			}
 
 			void clear() override;
 
 		private:
 			template<typename>
-			friend struct SmartReference;
+			friend struct oly::SmartReference;
 
 			template<typename>
-			friend struct WeakReference;
+			friend struct oly::WeakReference;
 
-			size_t init_slot()
+			bool valid(size_t idx, std::uint32_t generation) const
 			{
-				return init_slot(std::make_unique<Object>());
+				return idx < headers.size() && headers[idx].generation == generation;
+			}
+
+			size_t init_slot() requires (std::is_default_constructible_v<Object>)
+			{
+				const size_t idx = next_slot();
+				slots[idx].object = new (slab_storage(idx)) Object();
+				slots[idx].in_slab = true;
+				return idx;
 			}
 
 			template<typename T, typename = std::enable_if_t<shares_smart_pool_base<Object, T>>>
 			size_t init_slot(const T& obj)
 			{
-				return init_slot(std::make_unique<T>(obj));
+				const size_t idx = next_slot();
+				if constexpr (std::is_same_v<std::remove_cv_t<T>, std::remove_cv_t<Object>>)
+				{
+					slots[idx].object = new (slab_storage(idx)) Object(obj);
+					slots[idx].in_slab = true;
+				}
+				else
+					slots[idx].object = new T(obj);
+				return idx;
 			}
 
 			template<typename T, typename = std::enable_if_t<shares_smart_pool_base<Object, T>>>
 			size_t init_slot(T&& obj)
 			{
-				return init_slot(std::make_unique<T>(std::move(obj)));
+				using Type = std::remove_cvref_t<T>;
+				const size_t idx = next_slot();
+				if constexpr (std::is_same_v<Type, std::remove_cv_t<Object>>)
+				{
+					slots[idx].object = new (slab_storage(idx)) Object(std::forward<T>(obj));
+					slots[idx].in_slab = true;
+				}
+				else
+					slots[idx].object = new Type(std::forward<T>(obj));
+				return idx;
 			}
 
 			template<typename T, typename = std::enable_if_t<shares_smart_pool_base<Object, T>>>
 			size_t init_slot(std::unique_ptr<T>&& obj_ptr)
+			{
+				const size_t idx = next_slot();
+				slots[idx].object = obj_ptr.release();
+				return idx;
+			}
+
+			size_t next_slot()
 			{
 				if (unoccupied.empty())
 				{
-					objects.push_back(std::move(obj_ptr));
-					on_delete_callbacks.push_back({ nullptr, nullptr });
-					reference_heads.push_back(nullptr);
-					return objects.size() - 1;
+					if (slots.size() % SLAB_SIZE == 0)
+						slabs.push_back(std::make_unique<Storage[]>(SLAB_SIZE));
+					slots.emplace_back();
+					headers.emplace_back();
+					return slots.size() - 1;
 				}
 				else
 				{
-					size_t next_slot = unoccupied.top();
-					objects[next_slot] = std::move(obj_ptr);
-					on_delete_callbacks[next_slot] = { nullptr, nullptr };
-					unoccupied.pop();
-					return next_slot;
+					const size_t idx = unoccupied.back();
+					unoccupied.pop_back();
+					return idx;
 				}
 			}
 
+			void* slab_storage(size_t idx)
+			{
+				return slabs[idx / SLAB_SIZE][idx % SLAB_SIZE].bytes;
+			}
+
+			void free_slot(size_t idx)
+			{
+				if (slots[idx].on_delete)
+					(*slots[idx].on_delete)(*slots[idx].object, slots[idx].on_delete_usr);
+
+				// the slot is released before the object is destroyed, since its destructor may release other references into this pool
+				Object* object = slots[idx].object;
+				const bool in_slab = slots[idx].in_slab;
+				slots[idx] = {};
+				headers[idx] = { .generation = headers[idx].generation + 1 };
+
+				if (in_slab)
+					std::destroy_at(object);
+				else
+					delete object;
+				unoccupied.push_back(idx);
+			}
+
 			void mark_for_deletion(size_t idx)
 			{
-				marked_for_deletion.insert(idx);
+				if (!slots[idx].marked)
+				{
+					slots[idx].marked = true;
+					marked_for_deletion.push_back(idx);
+				}
 			}
 			
 			void unmark_for_deletion(size_t idx)
 			{
-				marked_for_deletion.erase(idx);
+				slots[idx].marked = false;
 			}
 			
 			bool is_marked_for_deletion(size_t idx) const
 			{
-				return marked_for_deletion.count(idx);
+				return slots[idx].marked;
 			}
 			
-			void increment_references(size_t idx, SmartReferenceLink* link)
+			void increment_references(size_t idx)
 			{
-				if (reference_heads[idx])
-				{
-					auto* next = reference_heads[idx]->next;
-					reference_heads[idx]->next = link;
-					link->prev = reference_heads[idx];
-					if (next)
-					{
-						link->next = next;
-						next->prev = link;
-					}
-					else
-					{
-						link->next = reference_heads[idx];
-						reference_heads[idx]->prev = link;
-					}
-				}
-				else
-					reference_heads[idx] = link;
+				++headers[idx].references;
 			}
 
-			void decrement_references(size_t idx, SmartReferenceLink* link)
+			void decrement_references(size_t idx)
 			{
-				std::unique_ptr<Object>& object = objects[idx];
-				SmartReferenceLink* prev = link->prev;
-				SmartReferenceLink* next = link->next;
-
-				if (next == prev)
-				{
-					if (next)
-					{
-						next->prev = nullptr;
-						next->next = nullptr;
-					}
-				}
-				else
-				{
-					if (next)
-						next->prev = prev;
-					if (prev)
-						prev->next = next;
-				}
-
-				if (reference_heads[idx] == link)
-					reference_heads[idx] = next;
-
-				link->prev = nullptr;
-				link->next = nullptr;
-
-				if (!reference_heads[idx])
-				{
-					if (on_delete_callbacks[idx].first)
-						(*on_delete_callbacks[idx].first)(*object, on_delete_callbacks[idx].second);
-					on_delete_callbacks[idx] = { nullptr, nullptr };
-
-					marked_for_deletion.erase(idx);
-					object.reset();
-					unoccupied.push(idx);
-				}
-			}
-
-			void replace_references(size_t idx, SmartReferenceLink* existing, SmartReferenceLink* with)
-			{
-				SmartReferenceLink* prev = existing->prev;
-				SmartReferenceLink* next = existing->next;
-
-				existing->prev = nullptr;
-				existing->next = nullptr;
-
-				with->prev = prev;
-				with->next = next;
-
-				if (prev)
-					prev->next = with;
-				if (next)
-					next->prev = with;
-
-				if (reference_heads[idx] == existing)
-					reference_heads[idx] = with;
+				if (--headers[idx].references == 0)
+					free_slot(idx);
 			}
 		};
 
@@ -267,7 +267,7 @@ namespace oly
 
 	private:
 		size_t pool_idx = size_t(-1);
-		Object* object = nullptr;
+		std::uint32_t generation = 0;
 
 	public:
 		WeakReference(const SmartReference<Object>& smart_ref);
@@ -282,7 +282,7 @@ namespace oly
 	};
 
 	template<typename Object>
-	struct SmartReference : private internal::SmartReferenceLink
+	struct SmartReference
 	{
 		using PoolBase = SmartPoolBaseType<Object>;
 
@@ -290,6 +290,9 @@ namespace oly
 		friend class internal::SmartReferencePool<PoolBase>;
 		friend struct WeakReference<Object>;
 
+		template<typename>
+		friend struct SmartReference;
+
 		static inline bool default_valid = false;
 
 		static SmartReference<Object>& default_ref() requires (std::is_default_constructible_v<Object>)
@@ -300,9 +303,9 @@ namespace oly
 		}
 
 		size_t pool_idx = size_t(-1);
-
-		const SmartReferenceLink* link() const { return static_cast<const SmartReferenceLink*>(this); }
-		SmartReferenceLink* link() { return static_cast<SmartReferenceLink*>(this); }
+		std::uint32_t generation = 0;
+		// objects never move while their slot is live, so dereferencing only has to check the generation
+		PoolBase* object = nullptr;
 
 		template<typename T>
 		struct IsSmartReferenceWithSharedPoolBase : public std::false_type {};
@@ -355,8 +358,7 @@ namespace oly
 		
 		SmartReference(internal::RefDefault) requires (std::is_default_constructible_v<Object>)
 		{
-			pool_idx = default_ref().pool_idx;
-			increment();
+			acquire(default_ref().pool_idx);
 		}
 
 		SmartReference(const Object& obj)
@@ -376,158 +378,54 @@ namespace oly
 		}
 
 		SmartReference(const SmartReference<Object>& other)
-			: pool_idx(other.pool_idx)
 		{
 			if (other.valid())
-				increment();
+				share(other);
 		}
 
 		template<typename T, typename = SharesPoolBase<T>, typename = PreventUnconstFrom<T>>
 		SmartReference(const SmartReference<T>& other)
-			: pool_idx(other.pool_idx)
 		{
 			if (other.valid())
-				increment();
+				share(other);
 		}
 
 		SmartReference(SmartReference<Object>&& other) noexcept
-			: pool_idx(other.pool_idx)
+			: pool_idx(other.pool_idx), generation(other.generation), object(other.object)
 		{
-			if (other.valid())
-				replace(other);
+			other.pool_idx = size_t(-1);
 		}
 
 		template<typename T, typename = SharesPoolBase<T>, typename = PreventUnconstFrom<T>>
 		SmartReference(SmartReference<T>&& other) noexcept
-			: pool_idx(other.pool_idx)
+			: pool_idx(other.pool_idx), generation(other.generation), object(other.object)
 		{
-			if (other.valid())
-				replace(other);
+			other.pool_idx = size_t(-1);
 		}
 
 		SmartReference<Object>& operator=(const SmartReference<Object>& other)
 		{
-			if (this != &other)
-			{
-				if (valid())
-				{
-					if (other.valid())
-					{
-						if (pool_idx != other.pool_idx)
-						{
-							decrement();
-							pool_idx = other.pool_idx;
-							increment();
-						}
-					}
-					else
-						decrement();
-				}
-				else
-				{
-					if (other.valid())
-					{
-						pool_idx = other.pool_idx;
-						increment();
-					}
-				}
-			}
+			assign(other);
 			return *this;
 		}
 
 		template<typename T, typename = SharesPoolBase<T>, typename = PreventUnconstFrom<T>>
 		SmartReference<Object>& operator=(const SmartReference<T>& other)
 		{
-			if (this != &other)
-			{
-				if (valid())
-				{
-					if (other.valid())
-					{
-						if (pool_idx != other.pool_idx)
-						{
-							decrement();
-							pool_idx = other.pool_idx;
-							increment();
-						}
-					}
-					else
-						decrement();
-				}
-				else
-				{
-					if (other.valid())
-					{
-						pool_idx = other.pool_idx;
-						increment();
-					}
-				}
-			}
+			assign(other);
 			return *this;
 		}
 
 		SmartReference<Object>& operator=(SmartReference<Object>&& other) noexcept
 		{
-			if (this != &other)
-			{
-				if (valid())
-				{
-					if (other.valid())
-					{
-						if (pool_idx != other.pool_idx)
-						{
-							decrement();
-							pool_idx = other.pool_idx;
-							replace(other);
-						}
-						else
-							other.decrement();
-					}
-					else
-						decrement();
-				}
-				else
-				{
-					if (other.valid())
-					{
-						pool_idx = other.pool_idx;
-						replace(other);
-					}
-				}
-			}
+			assign(std::move(other));
 			return *this;
 		}
 
 		template<typename T, typename = SharesPoolBase<T>, typename = PreventUnconstFrom<T>>
 		SmartReference<Object>& operator=(SmartReference<T>&& other) noexcept
 		{
-			if (this != &other)
-			{
-				if (valid())
-				{
-					if (other.valid())
-					{
-						if (pool_idx != other.pool_idx)
-						{
-							decrement();
-							pool_idx = other.pool_idx;
-							replace(other);
-						}
-						else
-							other.decrement();
-					}
-					else
-						decrement();
-				}
-				else
-				{
-					if (other.valid())
-					{
-						pool_idx = other.pool_idx;
-						replace(other);
-					}
-				}
-			}
+			assign(std::move(other));
 			return *this;
 		}
 
@@ -545,7 +443,7 @@ namespace oly
 		const Object& operator*() const
 		{
 			if (valid())
-				return *static_cast<const Object*>(pool().objects[pool_idx].get());
+				return *static_cast<const Object*>(object);
 			else
 				throw Error(ErrorCode::NullPointer);
 		}
@@ -553,7 +451,7 @@ namespace oly
 		Object& operator*()
 		{
 			if (valid())
-				return *static_cast<Object*>(pool().objects[pool_idx].get());
+				return *static_cast<Object*>(object);
 			else
 				throw Error(ErrorCode::NullPointer);
 		}
@@ -561,7 +459,7 @@ namespace oly
 		const Object* operator->() const
 		{
 			if (valid())
-				return static_cast<const Object*>(pool().objects[pool_idx].get());
+				return static_cast<const Object*>(object);
 			else
 				throw Error(ErrorCode::NullPointer);
 		}
@@ -569,7 +467,7 @@ namespace oly
 		Object* operator->()
 		{
 			if (valid())
-				return static_cast<Object*>(pool().objects[pool_idx].get());
+				return static_cast<Object*>(object);
 			else
 				throw Error(ErrorCode::NullPointer);
 		}
@@ -578,7 +476,7 @@ namespace oly
 		const PoolBase* base() const
 		{
 			if (valid())
-				return pool().objects[pool_idx].get();
+				return object;
 			else
 				return nullptr;
 		}
@@ -586,7 +484,7 @@ namespace oly
 		PoolBase* base()
 		{
 			if (valid())
-				return pool().objects[pool_idx].get();
+				return object;
 			else
 				return nullptr;
 		}
@@ -610,44 +508,32 @@ namespace oly
 		
 		bool valid() const
 		{
-			return next || (pool_idx < pool().reference_heads.size() ? pool().reference_heads[pool_idx] == link() : false);
+			return pool().valid(pool_idx, generation);
 		}
 
 		void init() requires (std::is_default_constructible_v<Object>)
 		{
-			if (valid())
-				decrement();
-
-			pool_idx = pool().init_slot();
-			pool().increment_references(pool_idx, link());
+			invalidate();
+			acquire(pool().init_slot());
 		}
 		
 		void init(const Object& obj)
 		{
-			if (valid())
-				decrement();
-
-			pool_idx = pool().init_slot(obj);
-			increment();
+			invalidate();
+			acquire(pool().init_slot(obj));
 		}
 
 		void init(Object&& obj)
 		{
-			if (valid())
-				decrement();
-
-			pool_idx = pool().init_slot(std::move(obj));
-			increment();
+			invalidate();
+			acquire(pool().init_slot(std::move(obj)));
 		}
 
 		template<typename... Args, typename = EnableObjectArgs<Args...>>
 		void init(Args&&... args)
 		{
-			if (valid())
-				decrement();
-
-			pool_idx = pool().init_slot(Object(std::forward<Args>(args)...));
-			increment();
+			invalidate();
+			acquire(pool().init_slot(Object(std::forward<Args>(args)...)));
 		}
 		
 		void init_toml(TOMLNode node)
@@ -659,10 +545,9 @@ namespace oly
 		{
 			if (valid())
 			{
-				Object copy = *pool().objects[pool_idx];
-				decrement();
-				pool_idx = pool().init_slot(std::move(copy));
-				increment();
+				Object copy = **this;
+				invalidate();
+				acquire(pool().init_slot(std::move(copy)));
 			}
 		}
 		
@@ -670,10 +555,7 @@ namespace oly
 		{
 			SmartReference<Object> cloned;
 			if (valid())
-			{
-				cloned.pool_idx = pool().init_slot(*pool().objects[pool_idx]);
-				cloned.increment();
-			}
+				cloned.acquire(pool().init_slot(**this));
 			return cloned;
 		}
 		
@@ -704,7 +586,10 @@ namespace oly
 		void set_on_delete(void(*callback)(Object&, void*), void* usr = nullptr)
 		{
 			if (valid())
-				pool().on_delete_callbacks[pool_idx] = { callback, usr };
+			{
+				pool().slots[pool_idx].on_delete = callback;
+				pool().slots[pool_idx].on_delete_usr = usr;
+			}
 			else
 				throw Error(ErrorCode::NullPointer);
 		}
@@ -712,7 +597,8 @@ namespace oly
 		void invalidate()
 		{
 			if (valid())
-				decrement();
+				pool().decrement_references(pool_idx);
+			pool_idx = size_t(-1);
 		}
 
 		WeakReference<Object> weak() const
@@ -739,20 +625,57 @@ namespace oly
 			return internal::SmartReferencePool<PoolBase>::instance();
 		}
 
-		void increment()
+		void acquire(size_t idx)
 		{
-			pool().increment_references(pool_idx, link());
+			pool_idx = idx;
+			generation = pool().headers[idx].generation;
+			object = pool().slots[idx].object;
+			pool().increment_references(idx);
 		}
 
-		void decrement()
+		template<typename T>
+		void share(const SmartReference<T>& other)
 		{
-			pool().decrement_references(pool_idx, link());
+			pool_idx = other.pool_idx;
+			generation = other.generation;
+			object = other.object;
+			pool().increment_references(pool_idx);
 		}
 
-		template<typename T, typename = SharesPoolBase<T>>
-		void replace(SmartReference<T>& other)
+		template<typename T>
+		void assign(const SmartReference<T>& other)
 		{
-			pool().replace_references(pool_idx, other.link(), link());
+			if (other.valid())
+			{
+				if (!valid() || pool_idx != other.pool_idx)
+				{
+					// the other reference is acquired first, in case releasing this one destroys the object that holds it
+					const size_t idx = other.pool_idx;
+					pool().increment_references(idx);
+					invalidate();
+					pool_idx = idx;
+					generation = other.generation;
+					object = other.object;
+				}
+			}
+			else
+				invalidate();
+		}
+
+		template<typename T>
+		void assign(SmartReference<T>&& other)
+		{
+			if (static_cast<void*>(this) != static_cast<void*>(&other))
+			{
+				const size_t idx = other.pool_idx;
+				const std::uint32_t gen = other.generation;
+				PoolBase* obj = other.object;
+				other.pool_idx = size_t(-1);
+				invalidate();
+				pool_idx = idx;
+				generation = gen;
+				object = obj;
+			}
 		}
 
 	public:
@@ -764,18 +687,18 @@ namespace oly
 
 	template<typename Object>
 	WeakReference<Object>::WeakReference(const SmartReference<Object>& smart_ref)
-		: pool_idx(smart_ref.pool_idx)
+		: pool_idx(smart_ref.pool_idx), generation(smart_ref.generation)
 	{
-		object = pool().objects[pool_idx].get();
 	}
 
 	template<typename Object>
 	SmartReference<Object> WeakReference<Object>::lock() const
 	{
-		if (internal::SmartReferenceLink* head = pool().reference_heads[pool_idx])
+		if (pool().valid(pool_idx, generation))
 		{
-			if (pool().objects[pool_idx].get() == object)
-				return *static_cast<SmartReference<Object>*>(head);
+			SmartReference<Object> ref;
+			ref.acquire(pool_idx);
+			return ref;
 		}
 
 		throw Error(ErrorCode::BadReference);
@@ -797,25 +720,11 @@ namespace oly
 				}
 			}
 
-			for (size_t i = 0; i < on_delete_callbacks.size(); ++i)
-				if (on_delete_callbacks[i].first)
-					(*on_delete_callbacks[i].first)(*objects[i], on_delete_callbacks[i].second);
-			on_delete_callbacks.clear();
-
-			algo::clear_stack(unoccupied);
+			// slots and slabs are kept so that the generation bump invalidates outstanding references
+			for (size_t i = 0; i < slots.size(); ++i)
+				if (slots[i].object)
+					free_slot(i);
 			marked_for_deletion.clear();
-			for (SmartReferenceLink* reference_head : reference_heads)
-			{
-				while (reference_head)
-				{
-					reference_head->prev = nullptr;
-					SmartReferenceLink* next = reference_head->next;
-					reference_head->next = nullptr;
-					reference_head = next;
-				}
-			}
-			reference_heads.clear();
-			objects.clear();
 		}
 	}
 
@@ -0,0 +1,52 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <algorithm>
+
+namespace oly::alloc
+{
+	static std::atomic<size_t> allocations = 0;
+
+	size_t count()
+	{
+		return allocations.load(std::memory_order_relaxed);
+	}
+
+	void* internal::allocate(size_t size)
+	{
+		allocations.fetch_add(1, std::memory_order_relaxed);
+		if (void* ptr = std::malloc(size > 0 ? size : 1))
+			return ptr;
+		throw std::bad_alloc();
+	}
+
+	void* internal::allocate(size_t size, std::align_val_t alignment)
+	{
+		allocations.fetch_add(1, std::memory_order_relaxed);
+		const size_t align = (size_t)alignment;
+#ifdef _MSC_VER
+		if (void* ptr = _aligned_malloc(size > 0 ? size : 1, align))
+			return ptr;
+#else
+		// aligned_alloc requires the size to be a multiple of the alignment
+		if (void* ptr = std::aligned_alloc(align, (std::max(size, size_t(1)) + align - 1) / align * align))
+			return ptr;
+#endif
+		throw std::bad_alloc();
+	}
+
+	void internal::deallocate(void* ptr) noexcept
+	{
+		std::free(ptr);
+	}
+
+	void internal::deallocate(void* ptr, std::align_val_t) noexcept
+	{
+#ifdef _MSC_VER
+		_aligned_free(ptr);
+#else
+		std::free(ptr);
+#endif
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace oly::alloc
+{
+	// Number of calls made to the global allocation functions, across all threads. Stays at zero unless one translation unit of the program
+	// expands OLY_COUNT_ALLOCATIONS() at global scope, which replaces the global operator new and delete with counting versions.
+	size_t count();
+
+	namespace internal
+	{
+		void* allocate(size_t size);
+		void* allocate(size_t size, std::align_val_t alignment);
+		void deallocate(void* ptr) noexcept;
+		void deallocate(void* ptr, std::align_val_t alignment) noexcept;
+
+		template<typename... Args>
+		void* try_allocate(size_t size, Args... args) noexcept
+		{
+			try
+			{
+				return allocate(size, args...);
+			}
+			catch (...)
+			{
+				return nullptr;
+			}
+		}
+	}
+}
+
+#define OLY_COUNT_ALLOCATIONS()\
+	void* operator new(std::size_t size) { return oly::alloc::internal::allocate(size); }\
+	void* operator new[](std::size_t size) { return oly::alloc::internal::allocate(size); }\
+	void* operator new(std::size_t size, std::align_val_t alignment) { return oly::alloc::internal::allocate(size, alignment); }\
+	void* operator new[](std::size_t size, std::align_val_t alignment) { return oly::alloc::internal::allocate(size, alignment); }\
+	void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return oly::alloc::internal::try_allocate(size); }\
+	void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return oly::alloc::internal::try_allocate(size); }\
+	void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return oly::alloc::internal::try_allocate(size, alignment); }\
+	void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return oly::alloc::internal::try_allocate(size, alignment); }\
+	void operator delete(void* ptr) noexcept { oly::alloc::internal::deallocate(ptr); }\
+	void operator delete[](void* ptr) noexcept { oly::alloc::internal::deallocate(ptr); }\
+	void operator delete(void* ptr, std::size_t) noexcept { oly::alloc::internal::deallocate(ptr); }\
+	void operator delete[](void* ptr, std::size_t) noexcept { oly::alloc::internal::deallocate(ptr); }\
+	void operator delete(void* ptr, const std::nothrow_t&) noexcept { oly::alloc::internal::deallocate(ptr); }\
+	void operator delete[](void* ptr, const std::nothrow_t&) noexcept { oly::alloc::internal::deallocate(ptr); }\
+	void operator delete(void* ptr, std::align_val_t alignment) noexcept { oly::alloc::internal::deallocate(ptr, alignment); }\
+	void operator delete[](void* ptr, std::align_val_t alignment) noexcept { oly::alloc::internal::deallocate(ptr, alignment); }\
+	void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept { oly::alloc::internal::deallocate(ptr, alignment); }\
+	void operator delete[](void* ptr, std::size_t, std::align_val_t alignment) noexcept { oly::alloc::internal::deallocate(ptr, alignment); }\
+	void operator delete(void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept { oly::alloc::internal::deallocate(ptr, alignment); }\
+	void operator delete[](void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept { oly::alloc::internal::deallocate(ptr, alignment); }
@@ -5,18 +5,33 @@
 #include "core/util/IO.h"
 
 #include <iostream>
+#include <algorithm>
 
 // TODO v10 simplify log macros -> separate prefix and always pass timestamp
 
 namespace oly
 {
+	Logger::~Logger()
+	{
+		stop_writer();
+	}
+
+	Logger::Staging::~Staging()
+	{
+		LOG.flush(*this);
+	}
+
+	Logger::Staging& Logger::staging()
+	{
+		thread_local Staging s;
+		return s;
+	}
+
 	void Logger::start_log(const LoggerOptions& options)
 	{
 		target.logfile = options.use_logfile;
 		target.console = options.use_console;
 
-		// TODO v10 use options max files/bytes to remove old logs here
-
 		if (target.logfile)
 		{
 			std::stringstream ss;
@@ -24,16 +39,30 @@ namespace oly
 			ss << "../logs/Tester_" << std::put_time(&time, "%Y-%m-%d %H-%M-%S") << ".log";
 			detail::ResourcePath logfile(ss.str());
 			logfile.create_parents();
+			remove_prior_logs(logfile.get_absolute().parent_path(), options);
 			file.open(logfile.get_absolute());
 		}
 
 		const char* prefix = "<<< LOG started at ";
 		const char* postfix = " >>>";
 		auto setw = std::setw(sizeof(prefix) - 1 + 32 + sizeof(postfix) - 1);
+		begin_record(nullptr, false, {});
+		std::stringstream& stream = staging().stream;
 		stream << std::setfill('-') << setw << "" << '\n' << prefix;
 		pass_timestamp();
 		stream << postfix << '\n' << std::setfill('-') << setw << "" << '\n';
 		flush();
+
+		if (options.async)
+		{
+			async.capacity = std::max(options.async_buffer_records, size_t(1));
+			async.overflow = options.async_overflow;
+			async.interval = options.async_write_interval;
+			async.stopping = false;
+			async.generation.fetch_add(1, std::memory_order_relaxed);
+			async.running.store(true, std::memory_order_release);
+			async.writer = std::thread([this]() { writer_loop(); });
+		}
 	}
 
 	void Logger::end_log()
@@ -43,15 +72,93 @@ namespace oly
 		const char* prefix = "<<<< LOG ended at ";
 		const char* postfix = " >>>>";
 		auto setw = std::setw(sizeof(prefix) - 1 + 32 + sizeof(postfix) - 1);
+		begin_record(nullptr, false, {});
+		std::stringstream& stream = staging().stream;
 		stream << std::setfill('-') << setw << "" << '\n' << prefix;
 		pass_timestamp();
 		stream << postfix << '\n' << std::setfill('-') << setw << "" << '\n';
 		flush();
+
+		stop_writer();
 	}
 
 	void Logger::flush()
 	{
-		const std::string buf = stream.str();
+		flush(staging());
+	}
+
+	void Logger::flush(Staging& s)
+	{
+		seal_record(s);
+		if (s.records.empty())
+			return;
+
+		if (is_async())
+			publish(s);
+		else
+			write(s.records);
+		s.records.clear();
+	}
+
+	void Logger::pass_timestamp()
+	{
+		time::pass_timestamp(staging().stream) << '.' << std::setfill('0') << std::setw(3) << time::mod_epoch_milliseconds();
+	}
+
+	void Logger::begin_record(const char* level, bool timestamp, std::string&& tag)
+	{
+		Staging& s = staging();
+		seal_record(s);
+		Record record{ .level = level, .tag = std::move(tag), .urgent = level && std::string_view(level) == "FATAL" };
+		if (timestamp)
+			record.time = std::chrono::system_clock::now();
+		s.records.push_back(std::move(record));
+	}
+
+	void Logger::seal_record(Staging& s)
+	{
+		std::string payload = s.stream.str();
+		if (payload.empty())
+			return;
+
+		// text streamed outside of a started record, such as after an endl, is kept as untagged
+		if (s.records.empty() || !s.records.back().payload.empty())
+			s.records.emplace_back();
+		s.records.back().payload = std::move(payload);
+		s.stream.str(std::string());
+		s.stream.clear();
+	}
+
+	void Logger::format(std::string& out, const Record& record)
+	{
+		if (record.time)
+		{
+			std::stringstream ss;
+			const auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(record.time->time_since_epoch()).count() % 1000;
+			time::pass_timestamp(ss, *record.time) << '.' << std::setfill('0') << std::setw(3) << millis << ' ';
+			out += ss.str();
+		}
+		if (record.level)
+		{
+			out += '[';
+			out += record.level;
+			if (!record.tag.empty())
+			{
+				out += " - ";
+				out += record.tag;
+			}
+			out += "] ";
+		}
+		out += record.payload;
+	}
+
+	void Logger::write(const std::vector<Record>& records)
+	{
+		std::string buf;
+		for (const Record& record : records)
+			format(buf, record);
+
+		std::lock_guard<std::mutex> lock(io_mutex);
 		if (target.console)
 		{
 			std::cout << buf;
@@ -62,47 +169,201 @@ namespace oly
 			file << buf;
 			file.flush();
 		}
-		stream.str(std::string());
-		stream.clear();
 	}
 
-	void Logger::pass_timestamp()
+	void Logger::publish(Staging& s)
+	{
+		const size_t generation = async.generation.load(std::memory_order_relaxed);
+		if (!s.ring || s.ring_generation != generation)
+		{
+			s.ring = std::make_shared<Ring>(async.capacity);
+			s.ring_generation = generation;
+			std::lock_guard<std::mutex> lock(async.mutex);
+			async.rings.push_back(s.ring);
+		}
+
+		bool urgent = false;
+		for (Record& record : s.records)
+		{
+			urgent |= record.urgent;
+			record.sequence = async.next_sequence.fetch_add(1, std::memory_order_relaxed);
+			while (!s.ring->records.try_push(std::move(record)))
+			{
+				if (async.overflow == LogOverflow::Drop)
+				{
+					s.ring->dropped.fetch_add(1, std::memory_order_relaxed);
+					break;
+				}
+				signal_writer();
+				std::this_thread::yield();
+			}
+		}
+
+		if (urgent)
+		{
+			// fatal records are written before returning, since the program may not survive to the next write
+			std::unique_lock<std::mutex> lock(async.mutex);
+			async.signaled = true;
+			async.wake.notify_one();
+			const std::shared_ptr<Ring> ring = s.ring;
+			async.written.wait(lock, [this, &ring]() { return (ring->records.empty() && !async.writing) || async.stopping; });
+		}
+		else if (2 * s.ring->records.size() >= s.ring->records.capacity())
+			signal_writer();
+	}
+
+	void Logger::signal_writer()
 	{
-		time::pass_timestamp(stream) << '.' << std::setfill('0') << std::setw(3) << time::mod_epoch_milliseconds();
+		{
+			std::lock_guard<std::mutex> lock(async.mutex);
+			async.signaled = true;
+		}
+		async.wake.notify_one();
 	}
 
-	void Logger::start(const char* level, bool timestamp, const char* prefix)
+	void Logger::drain(const std::vector<std::shared_ptr<Ring>>& rings, std::vector<Record>& batch)
 	{
-		if (timestamp)
+		size_t dropped = 0;
+		for (const std::shared_ptr<Ring>& ring : rings)
 		{
-			pass_timestamp();
-			stream << " ";
+			Record record;
+			while (ring->records.try_pop(record))
+				batch.push_back(std::move(record));
+			dropped += ring->dropped.exchange(0, std::memory_order_relaxed);
 		}
-		if (prefix)
-			stream << "[" << level << " - " << prefix << "] ";
-		else
-			stream << "[" << level << "] ";
+
+		if (dropped > 0)
+		{
+			async.dropped.fetch_add(dropped, std::memory_order_relaxed);
+			batch.push_back(Record{ .payload = "<<< " + std::to_string(dropped) + " log records dropped >>>\n",
+				.sequence = async.next_sequence.fetch_add(1, std::memory_order_relaxed) });
+		}
+
+		if (!batch.empty())
+		{
+			std::sort(batch.begin(), batch.end(), [](const Record& a, const Record& b) { return a.sequence < b.sequence; });
+			write(batch);
+			batch.clear();
+		}
+	}
+
+	void Logger::writer_loop()
+	{
+		std::vector<Record> batch;
+		std::vector<std::shared_ptr<Ring>> rings;
+		while (true)
+		{
+			bool stopping;
+			{
+				std::unique_lock<std::mutex> lock(async.mutex);
+				async.wake.wait_for(lock, async.interval, [this]() { return async.signaled || async.stopping; });
+				async.signaled = false;
+				async.writing = true;
+				stopping = async.stopping;
+				// rings of threads that have exited are dropped once they are drained
+				std::erase_if(async.rings, [](const std::shared_ptr<Ring>& ring) { return ring.use_count() == 1 && ring->records.empty(); });
+				rings = async.rings;
+			}
+
+			drain(rings, batch);
+			rings.clear();
+
+			{
+				std::lock_guard<std::mutex> lock(async.mutex);
+				async.writing = false;
+			}
+			async.written.notify_all();
+
+			if (stopping)
+				return;
+		}
+	}
+
+	void Logger::stop_writer()
+	{
+		if (!async.writer.joinable())
+			return;
+
+		// records flushed from here on are written synchronously, so none are stranded in a ring after the writer's last pass
+		async.running.store(false, std::memory_order_release);
+		{
+			std::lock_guard<std::mutex> lock(async.mutex);
+			async.stopping = true;
+		}
+		async.wake.notify_one();
+		async.writer.join();
+
+		// the writer is gone, so this thread consumes whatever was published between its last pass and running being cleared
+		std::vector<std::shared_ptr<Ring>> rings;
+		{
+			std::lock_guard<std::mutex> lock(async.mutex);
+			rings.swap(async.rings);
+		}
+		std::vector<Record> batch;
+		drain(rings, batch);
+	}
+
+	void Logger::remove_prior_logs(const std::filesystem::path& directory, const LoggerOptions& options) const
+	{
+		if (!options.max_prior_log_files && !options.max_prior_log_bytes)
+			return;
+
+		struct PriorLog
+		{
+			std::filesystem::path path;
+			std::filesystem::file_time_type modified;
+			uintmax_t bytes;
+		};
+		std::vector<PriorLog> logs;
+		uintmax_t total_bytes = 0;
+
+		std::error_code ec;
+		for (const auto& entry : std::filesystem::directory_iterator(directory, ec))
+		{
+			if (!entry.is_regular_file(ec) || entry.path().extension() != ".log" || !entry.path().filename().string().starts_with("Tester_"))
+				continue;
+			PriorLog log{ .path = entry.path(), .modified = entry.last_write_time(ec), .bytes = entry.file_size(ec) };
+			if (ec)
+				continue;
+			total_bytes += log.bytes;
+			logs.push_back(std::move(log));
+		}
+
+		// oldest first
+		std::sort(logs.begin(), logs.end(), [](const PriorLog& a, const PriorLog& b) { return a.modified < b.modified; });
+		size_t remaining = logs.size();
+		for (const PriorLog& log : logs)
+		{
+			const bool too_many = options.max_prior_log_files && remaining > *options.max_prior_log_files;
+			const bool too_large = options.max_prior_log_bytes && total_bytes > *options.max_prior_log_bytes;
+			if (!too_many && !too_large)
+				break;
+			if (std::filesystem::remove(log.path, ec))
+			{
+				--remaining;
+				total_bytes -= log.bytes;
+			}
+		}
+	}
+
+	void Logger::start(const char* level, bool timestamp, const char* prefix)
+	{
+		begin_record(level, timestamp, prefix ? std::string(prefix) : std::string());
 	}
 
 	void Logger::start(const char* level, Logger::_opengl g)
 	{
-		pass_timestamp();
-		stream << " [" << level << " - GL" << g.code << "] ";
+		begin_record(level, true, "GL" + std::to_string(g.code));
 	}
 
 	void Logger::start(const char* level, Logger::_glfw g)
 	{
-		pass_timestamp();
-		stream << " [" << level << " - GLFW" << g.code << "] ";
+		begin_record(level, true, "GLFW" + std::to_string(g.code));
 	}
 
 	Logger::Impl Logger::untagged(bool timestamp)
 	{
-		if (timestamp)
-		{
-			pass_timestamp();
-			stream << " ";
-		}
+		begin_record(nullptr, timestamp, {});
 		return Impl(true);
 	}
 
@@ -322,7 +583,11 @@ namespace oly
 
 	Logger::Impl operator<<(Logger::Impl impl, Logger::_nl)
 	{
-		return impl.stream('\n');
+		impl.stream('\n');
+		// completed lines are published in async mode, so that they reach the writer without waiting for an endl
+		if (LOG.is_async())
+			LOG.flush();
+		return impl;
 	}
 
 	Logger::Impl operator<<(Logger::Impl impl, Logger::_endl)
@@ -4,11 +4,20 @@
 #include <fstream>
 #include <string_view>
 #include <source_location>
+#include <chrono>
+#include <filesystem>
+#include <optional>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 
 #include "external/GL.h"
 #include "external/GLM.h"
 #include "core/types/Meta.h"
 #include "core/types/Singleton.h"
+#include "core/containers/SPSCRing.h"
 #include "core/util/StringParam.h"
 #include "core/util/LogLevel.h"
 
@@ -21,19 +30,63 @@ namespace oly
 
 	// TODO v10 string formatting and buffer elements for logger
 
+	enum class LogOverflow
+	{
+		// drop records that don't fit, counting them
+		Drop,
+		// wait for the writer to make room
+		Block
+	};
+
 	struct LoggerOptions
 	{
 		bool use_console = true;
 		bool use_logfile = true;
 		std::optional<size_t> max_prior_log_files = 20;
 		std::optional<size_t> max_prior_log_bytes = std::nullopt;
+		// Hand flushed records to a background writer through a ring buffer per logging thread, instead of writing them on the logging thread.
+		bool async = false;
+		size_t async_buffer_records = 1024;
+		LogOverflow async_overflow = LogOverflow::Drop;
+		std::chrono::milliseconds async_write_interval = std::chrono::milliseconds(50);
 	};
 
 	class Logger final : public Singleton<Logger>
 	{
 		friend class Singleton<Logger>;
 
-		std::stringstream stream;
+		// Records are formatted when written, so that logging threads only pay for the payload.
+		struct Record
+		{
+			std::optional<std::chrono::system_clock::time_point> time;
+			const char* level = nullptr;
+			std::string tag;
+			std::string payload;
+			size_t sequence = 0;
+			bool urgent = false;
+		};
+
+		struct Ring
+		{
+			SPSCRing<Record> records;
+			std::atomic<size_t> dropped = 0;
+
+			Ring(size_t capacity) : records(capacity) {}
+		};
+
+		struct Staging
+		{
+			std::stringstream stream;
+			std::vector<Record> records;
+			std::shared_ptr<Ring> ring;
+			size_t ring_generation = 0;
+
+			// publishes whatever a thread staged but never flushed before exiting
+			~Staging();
+		};
+		static Staging& staging();
+
+		std::mutex io_mutex;
 		std::ofstream file;
 
 		struct
@@ -42,15 +95,52 @@ namespace oly
 			bool logfile = true;
 		} target;
 
+		struct
+		{
+			std::thread writer;
+			std::mutex mutex;
+			std::condition_variable wake;
+			std::condition_variable written;
+			std::vector<std::shared_ptr<Ring>> rings;
+			std::atomic<bool> running = false;
+			std::atomic<size_t> generation = 0;
+			std::atomic<size_t> next_sequence = 0;
+			std::atomic<size_t> dropped = 0;
+			bool stopping = false;
+			bool signaled = false;
+			bool writing = false;
+			size_t capacity = 1024;
+			LogOverflow overflow = LogOverflow::Drop;
+			std::chrono::milliseconds interval = std::chrono::milliseconds(50);
+		} async;
+
+		Logger() = default;
+
 		friend struct internal::LogAccess;
 		void start_log(const LoggerOptions& options);
 		void end_log();
 
 	public:
+		~Logger();
+
 		void flush();
+		bool is_async() const { return async.running.load(std::memory_order_acquire); }
+		// records dropped by async logging because their ring buffer was full
+		size_t dropped_records() const { return async.dropped.load(std::memory_order_relaxed); }
 
 	private:
 		void pass_timestamp();
+		void begin_record(const char* level, bool timestamp, std::string&& tag);
+		static void seal_record(Staging& s);
+		void flush(Staging& s);
+		void write(const std::vector<Record>& records);
+		static void format(std::string& out, const Record& record);
+		void publish(Staging& s);
+		void signal_writer();
+		void drain(const std::vector<std::shared_ptr<Ring>>& rings, std::vector<Record>& batch);
+		void writer_loop();
+		void stop_writer();
+		void remove_prior_logs(const std::filesystem::path& directory, const LoggerOptions& options) const;
 
 	public:
 		class Impl
@@ -62,7 +152,7 @@ namespace oly
 
 		public:
 			template<typename T>
-			Impl stream(T&& obj) { if (enabled) Logger::instance().stream << std::forward<T>(obj); return *this; }
+			Impl stream(T&& obj) { if (enabled) Logger::staging().stream << std::forward<T>(obj); return *this; }
 		};
 		friend class Impl;
 
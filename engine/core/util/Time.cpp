@@ -8,17 +8,26 @@ namespace oly
 	{
 		tm time_struct()
 		{
-			const auto now = std::chrono::system_clock::now();
-			const auto time = std::chrono::system_clock::to_time_t(now);
+			return time_struct(std::chrono::system_clock::now());
+		}
+
+		tm time_struct(std::chrono::system_clock::time_point time)
+		{
+			const auto t = std::chrono::system_clock::to_time_t(time);
 #pragma warning(suppress : 4996)
-			const auto current_time = std::localtime(&time);
+			const auto current_time = std::localtime(&t);
 			return *current_time;
 		}
 
 		std::ostream& pass_timestamp(std::ostream& os)
 		{
-			tm time = time_struct();
-			return os << std::put_time(&time, "%Y-%m-%d %H:%M:%S");
+			return pass_timestamp(os, std::chrono::system_clock::now());
+		}
+
+		std::ostream& pass_timestamp(std::ostream& os, std::chrono::system_clock::time_point time)
+		{
+			tm t = time_struct(time);
+			return os << std::put_time(&t, "%Y-%m-%d %H:%M:%S");
 		}
 
 		std::string timestamp()
@@ -91,6 +100,20 @@ namespace oly
 
 	namespace internal
 	{
+		void TimeImpl::begin_fixed_step(double step)
+		{
+			_frame_delta = _processed_delta;
+			_inv_frame_delta = _inv_processed_delta;
+			_processed_delta = step;
+			_inv_processed_delta = 1.0 / step;
+		}
+
+		void TimeImpl::end_fixed_step()
+		{
+			_processed_delta = _frame_delta;
+			_inv_processed_delta = _inv_frame_delta;
+		}
+
 		void TimeImpl::process()
 		{
 			_processed_now = _raw_now * time_scale;
@@ -115,6 +138,13 @@ namespace oly
 			process();
 		}
 
+		void TimeImpl::advance(double raw_delta)
+		{
+			_raw_delta = raw_delta;
+			_raw_now += raw_delta;
+			process();
+		}
+
 		void RealTimeImpl::process()
 		{
 			_inv_now = 1.0 / _now;
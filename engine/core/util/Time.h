@@ -37,7 +37,9 @@ namespace oly
 		};
 
 		extern tm time_struct();
+		extern tm time_struct(std::chrono::system_clock::time_point time);
 		extern std::ostream& pass_timestamp(std::ostream& os);
+		extern std::ostream& pass_timestamp(std::ostream& os, std::chrono::system_clock::time_point time);
 		extern std::string timestamp();
 		extern int years_since_1900();
 		extern Month current_month();
@@ -63,6 +65,8 @@ namespace oly
 			double _raw_delta = 0.0;
 			double _processed_delta = 0.0;
 			double _inv_processed_delta = 0.0;
+			double _frame_delta = 0.0;
+			double _inv_frame_delta = 0.0;
 
 		public:
 			double frame_length_clip = 0.2;
@@ -77,12 +81,18 @@ namespace oly
 			template<numeric T = float>
 			T inverse_delta() const { return (T)_inv_processed_delta; }
 
+			// Replaces delta() with a fixed step until end_fixed_step(), so that code integrating with delta() can run in fixed-timestep substeps.
+			void begin_fixed_step(double step);
+			void end_fixed_step();
+
 		private:
 			void process();
 
 		public:
 			void init();
 			void sync();
+			// Advances the clock by raw_delta seconds instead of reading the platform clock, for simulating without a window.
+			void advance(double raw_delta);
 		};
 	}
 	
@@ -117,4 +127,20 @@ namespace oly
 	}
 
 	inline internal::RealTimeImpl REAL_TIME;
+
+	// Measures wall-clock intervals for profiling, independently of TIME.
+	class Stopwatch
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	public:
+		// seconds since construction or the last lap
+		double lap()
+		{
+			const auto now = std::chrono::steady_clock::now();
+			const double elapsed = std::chrono::duration<double>(now - start).count();
+			start = now;
+			return elapsed;
+		}
+	};
 }
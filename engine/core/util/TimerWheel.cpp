@@ -0,0 +1,182 @@
+#include "TimerWheel.h"
+
+#include <cmath>
+#include <bit>
+#include <algorithm>
+
+namespace oly
+{
+	TimerWheel::TimerWheel()
+	{
+		buckets.fill(NONE);
+	}
+
+	TimerHandle TimerWheel::schedule_at(double time, Callback&& callback)
+	{
+		std::uint32_t index;
+		if (free_entries.empty())
+		{
+			index = (std::uint32_t)entries.size();
+			entries.emplace_back();
+		}
+		else
+		{
+			index = free_entries.back();
+			free_entries.pop_back();
+		}
+
+		Entry& entry = entries[index];
+		entry.deadline = deadline_tick(time);
+		entry.callback = std::move(callback);
+		link(index);
+		++scheduled;
+		return { .index = index, .generation = entry.generation };
+	}
+
+	bool TimerWheel::cancel(TimerHandle handle)
+	{
+		if (!is_scheduled(handle))
+			return false;
+
+		unlink(handle.index);
+		release(handle.index);
+		return true;
+	}
+
+	bool TimerWheel::reschedule_at(TimerHandle handle, double time)
+	{
+		if (!is_scheduled(handle))
+			return false;
+
+		unlink(handle.index);
+		entries[handle.index].deadline = deadline_tick(time);
+		link(handle.index);
+		return true;
+	}
+
+	bool TimerWheel::is_scheduled(TimerHandle handle) const
+	{
+		return handle.index < entries.size() && entries[handle.index].generation == handle.generation && entries[handle.index].bucket != NONE;
+	}
+
+	void TimerWheel::advance(double delta)
+	{
+		clock += delta;
+		const std::uint64_t target = std::uint64_t(std::clamp(std::floor(clock / RESOLUTION + TICK_TOLERANCE), 0.0, TICK_LIMIT));
+		while (current < target)
+		{
+			// jump to the next occupied level-0 slot, or to the end of the rotation where coarser slots cascade
+			const std::uint32_t offset = current & (SLOTS - 1);
+			const std::uint64_t ahead = offset + 1 < SLOTS ? occupied[0] & (~std::uint64_t(0) << (offset + 1)) : 0;
+			const std::uint64_t next = ahead ? (current & ~std::uint64_t(SLOTS - 1)) + std::countr_zero(ahead) : (current | (SLOTS - 1)) + 1;
+			if (next > target)
+			{
+				current = target;
+				break;
+			}
+
+			current = next;
+			if ((current & (SLOTS - 1)) == 0)
+			{
+				for (std::uint32_t level = 1; level < LEVELS; ++level)
+				{
+					cascade(level);
+					if (((current >> (SLOT_BITS * level)) & (SLOTS - 1)) != 0)
+						break;
+				}
+			}
+			fire(current & (SLOTS - 1));
+		}
+	}
+
+	void TimerWheel::clear()
+	{
+		for (std::uint32_t index = 0; index < entries.size(); ++index)
+			if (entries[index].bucket != NONE)
+				release(index);
+		for (Entry& entry : entries)
+			entry.prev = entry.next = entry.bucket = NONE;
+		buckets.fill(NONE);
+		occupied = {};
+	}
+
+	std::uint64_t TimerWheel::deadline_tick(double time) const
+	{
+		const double ticks = std::min(std::ceil(time / RESOLUTION - TICK_TOLERANCE), TICK_LIMIT);
+		return ticks > double(current) ? std::uint64_t(ticks) : current + 1;
+	}
+
+	void TimerWheel::link(std::uint32_t index)
+	{
+		Entry& entry = entries[index];
+		// deadlines out of range wait in the coarsest level, and are placed again each time they cascade
+		const std::uint64_t delta = std::min(entry.deadline - current, RANGE - 1);
+		std::uint32_t level = 0;
+		while (delta >> (SLOT_BITS * (level + 1)))
+			++level;
+
+		const std::uint32_t slot = ((current + delta) >> (SLOT_BITS * level)) & (SLOTS - 1);
+		entry.bucket = level * SLOTS + slot;
+		entry.prev = NONE;
+		entry.next = buckets[entry.bucket];
+		if (entry.next != NONE)
+			entries[entry.next].prev = index;
+		buckets[entry.bucket] = index;
+		occupied[level] |= std::uint64_t(1) << slot;
+	}
+
+	void TimerWheel::unlink(std::uint32_t index)
+	{
+		Entry& entry = entries[index];
+		if (entry.prev != NONE)
+			entries[entry.prev].next = entry.next;
+		else
+		{
+			buckets[entry.bucket] = entry.next;
+			if (entry.next == NONE)
+				occupied[entry.bucket / SLOTS] &= ~(std::uint64_t(1) << (entry.bucket % SLOTS));
+		}
+		if (entry.next != NONE)
+			entries[entry.next].prev = entry.prev;
+		entry.prev = entry.next = entry.bucket = NONE;
+	}
+
+	void TimerWheel::release(std::uint32_t index)
+	{
+		Entry& entry = entries[index];
+		entry.callback = {};
+		++entry.generation;
+		free_entries.push_back(index);
+		--scheduled;
+	}
+
+	void TimerWheel::cascade(std::uint32_t level)
+	{
+		const std::uint32_t slot = (current >> (SLOT_BITS * level)) & (SLOTS - 1);
+		const std::uint32_t bucket = level * SLOTS + slot;
+		std::uint32_t index = buckets[bucket];
+		buckets[bucket] = NONE;
+		occupied[level] &= ~(std::uint64_t(1) << slot);
+
+		while (index != NONE)
+		{
+			const std::uint32_t next = entries[index].next;
+			link(index);
+			index = next;
+		}
+	}
+
+	void TimerWheel::fire(std::uint32_t bucket)
+	{
+		// callbacks cannot schedule into this bucket, since new deadlines are at least a tick ahead
+		while (buckets[bucket] != NONE)
+		{
+			const std::uint32_t index = buckets[bucket];
+			unlink(index);
+			Callback callback = std::move(entries[index].callback);
+			release(index);
+			if (callback)
+				callback();
+		}
+	}
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <functional>
+#include <cstdint>
+
+namespace oly
+{
+	struct TimerHandle
+	{
+		std::uint32_t index = -1;
+		std::uint32_t generation = 0;
+
+		bool operator==(const TimerHandle&) const = default;
+	};
+
+	// Hierarchical timing wheel with millisecond ticks. Scheduling, cancelling and rescheduling are O(1), and advancing the clock only visits
+	// timers that are due, plus the occasional cascade of a coarser slot into finer ones.
+	class TimerWheel
+	{
+	public:
+		using Callback = std::function<void()>;
+
+		static constexpr double RESOLUTION = 0.001;
+
+	private:
+		static constexpr std::uint32_t SLOT_BITS = 6;
+		static constexpr std::uint32_t SLOTS = 1 << SLOT_BITS;
+		static constexpr std::uint32_t LEVELS = 5;
+		static constexpr std::uint64_t RANGE = std::uint64_t(1) << (SLOT_BITS * LEVELS);
+		static constexpr std::uint32_t NONE = -1;
+		// far enough that a deadline never arrives, without overflowing
+		static constexpr double TICK_LIMIT = double(std::uint64_t(1) << 62);
+		// absorbs rounding when converting seconds to ticks, so that a deadline equal to the clock is due
+		static constexpr double TICK_TOLERANCE = 1e-6;
+
+		struct Entry
+		{
+			std::uint64_t deadline = 0;
+			Callback callback;
+			std::uint32_t prev = NONE;
+			std::uint32_t next = NONE;
+			std::uint32_t bucket = NONE;
+			std::uint32_t generation = 0;
+		};
+
+		std::vector<Entry> entries;
+		std::vector<std::uint32_t> free_entries;
+		std::array<std::uint32_t, LEVELS * SLOTS> buckets;
+		std::array<std::uint64_t, LEVELS> occupied = {};
+		std::uint64_t current = 0;
+		double clock = 0.0;
+		size_t scheduled = 0;
+
+	public:
+		TimerWheel();
+		TimerWheel(const TimerWheel&) = delete;
+		TimerWheel(TimerWheel&&) = delete;
+
+		// seconds advanced since construction
+		double now() const { return clock; }
+		size_t size() const { return scheduled; }
+
+		// The callback runs once, during advance(), and the handle is invalid from then on. Callbacks may schedule, cancel or reschedule timers.
+		TimerHandle schedule(double delay, Callback&& callback) { return schedule_at(clock + delay, std::move(callback)); }
+		TimerHandle schedule_at(double time, Callback&& callback);
+		bool cancel(TimerHandle handle);
+		bool reschedule(TimerHandle handle, double delay) { return reschedule_at(handle, clock + delay); }
+		bool reschedule_at(TimerHandle handle, double time);
+		bool is_scheduled(TimerHandle handle) const;
+
+		void advance(double delta);
+		void clear();
+
+	private:
+		std::uint64_t deadline_tick(double time) const;
+		void link(std::uint32_t index);
+		void unlink(std::uint32_t index);
+		void release(std::uint32_t index);
+		void cascade(std::uint32_t level);
+		void fire(std::uint32_t bucket);
+	};
+}
@@ -26,45 +26,81 @@ namespace oly
 		}
 	}
 
-	static float delta_time(TimeMode mode)
+	static double delta_time(TimeMode mode)
 	{
 		if (mode == TimeMode::Processed) [[likely]]
-			return TIME.delta();
+			return TIME.delta<double>();
 		else
-			return REAL_TIME.delta();
+			return REAL_TIME.delta<double>();
+	}
+
+	void internal::TimerService::on_tick()
+	{
+		processed.advance(TIME.delta<double>());
+		real.advance(REAL_TIME.delta<double>());
 	}
 
 	StateTimer::StateTimer(float interval, bool one_shot, bool playing, TimeMode mode)
-		: ITickService(TickPhase::TimerPoll), cumulative_intervals({interval}), one_shot(one_shot), playing(playing), mode(mode)
+		: cumulative_intervals({interval}), one_shot(one_shot), playing(playing), mode(mode)
 	{
 		init_intervals(cumulative_intervals, total_length);
+		start = clock();
 	}
 
 	StateTimer::StateTimer(const std::vector<float>& intervals, bool one_shot, bool playing, TimeMode mode)
-		: ITickService(TickPhase::TimerPoll), cumulative_intervals(intervals), one_shot(one_shot), playing(playing), mode(mode)
+		: cumulative_intervals(intervals), one_shot(one_shot), playing(playing), mode(mode)
 	{
 		init_intervals(cumulative_intervals, total_length);
+		start = clock();
 	}
 
 	StateTimer::StateTimer(std::vector<float>&& intervals, bool one_shot, bool playing, TimeMode mode)
-		: ITickService(TickPhase::TimerPoll), cumulative_intervals(std::move(intervals)), one_shot(one_shot), playing(playing), mode(mode)
+		: cumulative_intervals(std::move(intervals)), one_shot(one_shot), playing(playing), mode(mode)
 	{
 		init_intervals(cumulative_intervals, total_length);
+		start = clock();
 	}
 
-	void StateTimer::poll() const
+	float StateTimer::elapsed_time() const
 	{
+		sync_clock();
 		if (playing)
 		{
-			elapsed += delta_time(mode);
-			if (one_shot && elapsed >= total_length)
-				playing = false;
+			const float elapsed = float(clock() - start);
+			if (!one_shot || elapsed < total_length)
+				return elapsed;
+
+			playing = false;
+			paused_elapsed = elapsed;
+		}
+		return paused_elapsed;
+	}
+
+	void StateTimer::pause()
+	{
+		paused_elapsed = elapsed_time();
+		playing = false;
+	}
+
+	void StateTimer::resume()
+	{
+		sync_clock();
+		if (!playing)
+		{
+			start = clock() - paused_elapsed;
+			playing = true;
 		}
 	}
 
+	bool StateTimer::is_playing() const
+	{
+		elapsed_time();
+		return playing;
+	}
+
 	StateTimer::State StateTimer::state() const
 	{
-		float local_time = fmod(elapsed, total_length);
+		float local_time = fmod(elapsed_time(), total_length);
 		if (local_time < cumulative_intervals[_state])
 		{
 			if (_state == 0 || local_time >= cumulative_intervals[_state - 1]) // still at _state
@@ -96,96 +132,268 @@ namespace oly
 		throw Error(ErrorCode::UnreachableCode);
 	}
 
+	void StateTimer::on_tick()
+	{
+		sync_clock();
+		if (!clock_auto)
+		{
+			manual_clock += delta_time(mode);
+			manual_mark = internal::TimerService::instance().wheel(mode).now();
+		}
+	}
+
+	double StateTimer::clock() const
+	{
+		return clock_auto ? internal::TimerService::instance().wheel(mode).now() : manual_clock;
+	}
+
+	void StateTimer::sync_clock() const
+	{
+		// switching clocks keeps the elapsed time - the switch back to the wheel's clock is only noticed when queried, so it is taken to happen
+		// at the last manual tick
+		if (auto_tick != clock_auto)
+		{
+			if (clock_auto)
+				start += manual_clock - internal::TimerService::instance().wheel(mode).now();
+			else
+				start += manual_mark - manual_clock;
+			clock_auto = auto_tick;
+		}
+	}
+
 	CallbackTimer::CallbackTimer(float interval, const Callback& callback, bool one_shot, bool playing, bool continuous, TimeMode mode)
-		: ITickService(TickPhase::TimerPoll), callback(callback), cumulative_intervals({ interval }), one_shot(one_shot), playing(playing), continuous(continuous), mode(mode)
+		: callback(callback), cumulative_intervals({ interval }), one_shot(one_shot), playing(playing), continuous(continuous), mode(mode)
 	{
 		init_intervals(cumulative_intervals, total_length);
+		start = clock();
+		if (playing)
+			schedule();
 	}
 
 	CallbackTimer::CallbackTimer(const std::vector<float>& intervals, const Callback& callback, bool one_shot, bool playing, bool continuous, TimeMode mode)
-		: ITickService(TickPhase::TimerPoll), callback(callback), cumulative_intervals(intervals), one_shot(one_shot), playing(playing), continuous(continuous), mode(mode)
+		: callback(callback), cumulative_intervals(intervals), one_shot(one_shot), playing(playing), continuous(continuous), mode(mode)
 	{
 		init_intervals(cumulative_intervals, total_length);
+		start = clock();
+		if (playing)
+			schedule();
 	}
 
 	CallbackTimer::CallbackTimer(std::vector<float>&& intervals, Callback&& callback, bool one_shot, bool playing, bool continuous, TimeMode mode)
-		: ITickService(TickPhase::TimerPoll), callback(std::move(callback)), cumulative_intervals(std::move(intervals)), one_shot(one_shot), playing(playing), continuous(continuous), mode(mode)
+		: callback(std::move(callback)), cumulative_intervals(std::move(intervals)), one_shot(one_shot), playing(playing), continuous(continuous), mode(mode)
 	{
 		init_intervals(cumulative_intervals, total_length);
+		start = clock();
+		if (playing)
+			schedule();
 	}
 
-	void CallbackTimer::poll() const
+	CallbackTimer::CallbackTimer(const CallbackTimer& other)
+		: callback(other.callback), auto_tick(other.auto_tick), cumulative_intervals(other.cumulative_intervals), total_length(other.total_length), start(other.start), paused_elapsed(other.paused_elapsed),
+		one_shot(other.one_shot), playing(other.playing), continuous(other.continuous), mode(other.mode), _state(other._state), cycle(other.cycle),
+		manual_clock(other.manual_clock), clock_auto(other.clock_auto)
 	{
-		if (!playing)
-			return;
+		if (playing)
+			schedule();
+	}
+
+	CallbackTimer::CallbackTimer(CallbackTimer&& other) noexcept
+		: callback(std::move(other.callback)), auto_tick(other.auto_tick), cumulative_intervals(std::move(other.cumulative_intervals)), total_length(other.total_length),
+		start(other.start), paused_elapsed(other.paused_elapsed), one_shot(other.one_shot), playing(other.playing), continuous(other.continuous), mode(other.mode),
+		_state(other._state), cycle(other.cycle), manual_clock(other.manual_clock), clock_auto(other.clock_auto)
+	{
+		other.wheel().cancel(other.handle);
+		other.handle = {};
+		other.playing = false;
+		if (playing)
+			schedule();
+	}
+
+	CallbackTimer::~CallbackTimer()
+	{
+		wheel().cancel(handle);
+	}
 
-		elapsed += delta_time(mode);
-		if (one_shot && elapsed >= total_length)
+	CallbackTimer& CallbackTimer::operator=(const CallbackTimer& other)
+	{
+		if (this != &other)
 		{
+			wheel().cancel(handle);
+			handle = {};
+			callback = other.callback;
+			cumulative_intervals = other.cumulative_intervals;
+			total_length = other.total_length;
+			start = other.start;
+			paused_elapsed = other.paused_elapsed;
+			one_shot = other.one_shot;
+			playing = other.playing;
+			continuous = other.continuous;
+			mode = other.mode;
+			_state = other._state;
+			cycle = other.cycle;
+			auto_tick = other.auto_tick;
+			manual_clock = other.manual_clock;
+			clock_auto = other.clock_auto;
+			if (playing)
+				schedule();
+		}
+		return *this;
+	}
+
+	CallbackTimer& CallbackTimer::operator=(CallbackTimer&& other) noexcept
+	{
+		if (this != &other)
+		{
+			wheel().cancel(handle);
+			handle = {};
+			other.wheel().cancel(other.handle);
+			other.handle = {};
+			callback = std::move(other.callback);
+			cumulative_intervals = std::move(other.cumulative_intervals);
+			total_length = other.total_length;
+			start = other.start;
+			paused_elapsed = other.paused_elapsed;
+			one_shot = other.one_shot;
+			playing = other.playing;
+			continuous = other.continuous;
+			mode = other.mode;
+			_state = other._state;
+			cycle = other.cycle;
+			auto_tick = other.auto_tick;
+			manual_clock = other.manual_clock;
+			clock_auto = other.clock_auto;
+			other.playing = false;
+			if (playing)
+				schedule();
+		}
+		return *this;
+	}
+
+	float CallbackTimer::elapsed_time() const
+	{
+		return playing ? float(clock() - start) : paused_elapsed;
+	}
+
+	void CallbackTimer::pause()
+	{
+		sync_clock();
+		if (playing)
+		{
+			paused_elapsed = elapsed_time();
+			wheel().cancel(handle);
+			handle = {};
 			playing = false;
-			return;
 		}
+	}
 
-		const float local_time = fmod(elapsed, total_length);
-		if (local_time < cumulative_intervals[_state])
+	void CallbackTimer::resume()
+	{
+		sync_clock();
+		if (!playing)
 		{
-			if (_state != 0 && local_time < cumulative_intervals[_state - 1]) // earlier than _state
-			{
-				if (continuous)
-				{
-					for (GLuint i = _state; i < cumulative_intervals.size(); ++i)
-						callback(i);
+			start = clock() - paused_elapsed;
+			playing = true;
+			schedule();
+		}
+	}
 
-					for (GLuint i = 0; i < _state; ++i)
-					{
-						callback(i);
-						if (local_time < cumulative_intervals[i])
-						{
-							_state = i;
-							return;
-						}
-					}
-				}
-				else
-				{
-					for (GLuint i = 0; i < _state; ++i)
-					{
-						if (local_time < cumulative_intervals[i])
-						{
-							callback(i);
-							_state = i;
-							return;
-						}
-					}
-				}
-			}
+	TimerWheel& CallbackTimer::wheel() const
+	{
+		return internal::TimerService::instance().wheel(mode);
+	}
+
+	void CallbackTimer::on_tick()
+	{
+		sync_clock();
+		if (clock_auto || !playing)
+			return;
+
+		manual_clock += delta_time(mode);
+		if (total_length > 0.0f && next_boundary() <= manual_clock)
+			on_boundary();
+	}
+
+	double CallbackTimer::clock() const
+	{
+		return clock_auto ? wheel().now() : manual_clock;
+	}
+
+	void CallbackTimer::sync_clock()
+	{
+		// switching clocks keeps the elapsed time
+		if (auto_tick != clock_auto)
+		{
+			const double from = clock();
+			clock_auto = auto_tick;
+			start += clock() - from;
+			if (playing)
+				schedule();
 		}
-		else // later than _state
+	}
+
+	double CallbackTimer::next_boundary() const
+	{
+		return start + double(cycle) * total_length + cumulative_intervals[_state];
+	}
+
+	void CallbackTimer::schedule()
+	{
+		wheel().cancel(handle);
+		handle = {};
+		if (!clock_auto)
+			handle = wheel().schedule(0.0, [this]() { on_watch(); });
+		// a timer without length has no boundaries to cross
+		else if (total_length > 0.0f)
+			handle = wheel().schedule_at(next_boundary(), [this]() { on_boundary(); });
+	}
+
+	void CallbackTimer::on_boundary()
+	{
+		handle = {};
+		sync_clock();
+		const double now = clock();
+		const GLuint first = _state;
+		size_t crossed = 0;
+		while (next_boundary() <= now)
 		{
-			if (continuous)
+			if (_state + 1 < cumulative_intervals.size())
+				++_state;
+			else if (one_shot)
 			{
-				for (GLuint i = _state + 1; i < cumulative_intervals.size(); ++i)
-				{
-					callback(i);
-					if (local_time < cumulative_intervals[i])
-					{
-						_state = i;
-						return;
-					}
-				}
+				playing = false;
+				paused_elapsed = float(now - start);
+				break;
 			}
 			else
 			{
-				for (GLuint i = _state + 1; i < cumulative_intervals.size(); ++i)
-				{
-					if (local_time < cumulative_intervals[i])
-					{
-						callback(i);
-						_state = i;
-						return;
-					}
-				}
+				_state = 0;
+				++cycle;
 			}
+			++crossed;
 		}
+
+		// rescheduled before the callbacks, which may pause or resume the timer
+		if (playing)
+			schedule();
+
+		if (!callback)
+			return;
+
+		if (continuous)
+		{
+			for (size_t i = 1; i <= crossed; ++i)
+				callback(GLuint((first + i) % cumulative_intervals.size()));
+		}
+		else if (crossed > 0)
+			callback(_state);
+	}
+
+	void CallbackTimer::on_watch()
+	{
+		handle = {};
+		if (auto_tick)
+			sync_clock();
+		else
+			schedule();
 	}
 }
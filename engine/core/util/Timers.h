@@ -1,10 +1,11 @@
 #pragma once
 
 #include "core/util/Time.h"
+#include "core/util/TimerWheel.h"
 #include "core/context/TickService.h"
+#include "core/types/Singleton.h"
 
 #include <vector>
-#include <unordered_set>
 #include <functional>
 
 namespace oly
@@ -15,31 +16,52 @@ namespace oly
 		Real
 	};
 
-	class StateTimer : public ITickService
+	namespace internal
+	{
+		// Owns one timer wheel per time mode, advanced once per frame in the timer poll phase.
+		class TimerService final : public Singleton<TimerService>, public ITickService
+		{
+			friend class Singleton<TimerService>;
+
+			TimerWheel processed;
+			TimerWheel real;
+
+			TimerService() : ITickService(TickPhase::TimerPoll) {}
+
+		public:
+			TimerWheel& wheel(TimeMode mode) { return mode == TimeMode::Processed ? processed : real; }
+
+			void on_tick() override;
+		};
+	}
+
+	// Computes its state from the timer wheel's clock when queried, so it costs nothing per frame. With auto_tick off, the timer instead follows a
+	// clock of its own that only advances by a frame's delta on each call to on_tick(), as when timers were ticked individually.
+	class StateTimer
 	{
 		std::vector<float> cumulative_intervals;
 		float total_length = 0.0f;
-		mutable float elapsed = 0.0f;
+		mutable double start = 0.0;
+		mutable float paused_elapsed = 0.0f;
 		bool one_shot = false;
 		mutable bool playing = true;
 		TimeMode mode = TimeMode::Processed;
 		mutable GLuint _state = 0;
+		double manual_clock = 0.0;
+		double manual_mark = 0.0;
+		mutable bool clock_auto = true;
 
 	public:
+		bool auto_tick = true;
+
 		StateTimer(float interval, bool one_shot = false, bool playing = true, TimeMode mode = TimeMode::Processed);
 		StateTimer(const std::vector<float>& intervals, bool one_shot = false, bool playing = true, TimeMode mode = TimeMode::Processed);
 		StateTimer(std::vector<float>&& intervals, bool one_shot = false, bool playing = true, TimeMode mode = TimeMode::Processed);
 		
-		float elapsed_time() const { return elapsed; }
-		void pause() { playing = false; }
-		void resume() { playing = true; }
-		bool is_playing() const { return playing; }
-
-	private:
-		void poll() const;
-
-	public:
-		void on_tick() override { poll(); }
+		float elapsed_time() const;
+		void pause();
+		void resume();
+		bool is_playing() const;
 
 		struct State
 		{
@@ -48,39 +70,64 @@ namespace oly
 		};
 
 		State state() const;
+
+		void on_tick();
+
+	private:
+		double clock() const;
+		void sync_clock() const;
 	};
 
-	class CallbackTimer : public ITickService
+	// Scheduled on the timer wheel at its next interval boundary, so it is only visited on frames where it calls back. Every boundary crossed
+	// since the last call back is reported if continuous, and only the latest otherwise. With auto_tick off, the timer only advances on calls to
+	// on_tick(), and is visited by the wheel each frame just to notice auto_tick being switched back on.
+	class CallbackTimer
 	{
 	public:
 		using Callback = std::function<void(GLuint)>;
 
 		std::function<void(GLuint)> callback;
+		bool auto_tick = true;
 
 	private:
 		std::vector<float> cumulative_intervals;
 		float total_length = 0.0f;
-		mutable float elapsed = 0.0f;
+		double start = 0.0;
+		float paused_elapsed = 0.0f;
 		bool one_shot = false;
-		mutable bool playing = true;
+		bool playing = true;
 		bool continuous;
 		TimeMode mode = TimeMode::Processed;
-		mutable GLuint _state = 0;
+		GLuint _state = 0;
+		size_t cycle = 0;
+		TimerHandle handle;
+		double manual_clock = 0.0;
+		bool clock_auto = true;
 
 	public:
 		CallbackTimer(float interval, const Callback& callback = {}, bool one_shot = false, bool playing = true, bool continuous = true, TimeMode mode = TimeMode::Processed);
 		CallbackTimer(const std::vector<float>& intervals, const Callback& callback, bool one_shot = false, bool playing = true, bool continuous = true, TimeMode mode = TimeMode::Processed);
 		CallbackTimer(std::vector<float>&& intervals, Callback&& callback, bool one_shot = false, bool playing = true, bool continuous = true, TimeMode mode = TimeMode::Processed);
-
-		float elapsed_time() const { return elapsed; }
-		void pause() { playing = false; }
-		void resume() { playing = true; }
+		CallbackTimer(const CallbackTimer&);
+		CallbackTimer(CallbackTimer&&) noexcept;
+		~CallbackTimer();
+		CallbackTimer& operator=(const CallbackTimer&);
+		CallbackTimer& operator=(CallbackTimer&&) noexcept;
+
+		float elapsed_time() const;
+		void pause();
+		void resume();
 		bool is_playing() const { return playing; }
 
-	private:
-		void poll() const;
+		void on_tick();
 
-	public:
-		void on_tick() override { poll(); }
+	private:
+		TimerWheel& wheel() const;
+		double clock() const;
+		void sync_clock();
+		double next_boundary() const;
+		void schedule();
+		void on_boundary();
+		void on_watch();
 	};
 }
@@ -0,0 +1,285 @@
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+namespace oly
+{
+	// threads outside the pool share deque 0
+	static thread_local size_t local_deque = 0;
+
+	TaskGroup::~TaskGroup()
+	{
+		if (!idle())
+		{
+			try
+			{
+				WorkerPool::instance().wait(*this, false);
+			}
+			catch (...)
+			{
+			}
+		}
+	}
+
+	void TaskGroup::run(std::function<void()>&& fn)
+	{
+		WorkerPool::instance().spawn(*this, std::move(fn));
+	}
+
+	void TaskGroup::wait()
+	{
+		if (!idle())
+			WorkerPool::instance().wait(*this, false);
+		else
+		{
+			std::exception_ptr rethrow = nullptr;
+			{
+				std::lock_guard<std::mutex> lock(exception_mutex);
+				std::swap(rethrow, exception);
+			}
+			if (rethrow)
+				std::rethrow_exception(rethrow);
+		}
+	}
+
+	WorkerPool::WorkerPool()
+	{
+		const size_t hardware = std::thread::hardware_concurrency();
+		const size_t num_threads = hardware > 1 ? hardware - 1 : 0;
+		deques.reserve(num_threads + 1);
+		for (size_t i = 0; i < num_threads + 1; ++i)
+			deques.push_back(std::make_unique<Deque>());
+		threads.reserve(num_threads);
+		for (size_t i = 0; i < num_threads; ++i)
+			threads.emplace_back([this, i]() { worker_loop(i + 1); });
+		alive.store(true, std::memory_order_release);
+	}
+
+	WorkerPool::~WorkerPool()
+	{
+		alive.store(false, std::memory_order_release);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		wake.notify_all();
+		for (std::thread& thread : threads)
+			thread.join();
+
+		// jobs still queued at shutdown are dropped, so that their groups don't wait on them
+		for (const auto& deque : deques)
+			for (const Job& job : deque->jobs)
+				job.group->pending.fetch_sub(1, std::memory_order_acq_rel);
+	}
+
+	void WorkerPool::parallel_for(size_t count, size_t grain, const RangeFunction& fn)
+	{
+		if (count == 0)
+			return;
+
+		grain = std::max(grain, size_t(1));
+		if (threads.empty() || count <= grain)
+		{
+			fn(0, count);
+			return;
+		}
+
+		TaskGroup group;
+		try
+		{
+			split(group, fn, 0, count, grain);
+		}
+		catch (...)
+		{
+			// the spawned chunks reference fn and the group, so they must finish before unwinding
+			try
+			{
+				wait(group, false);
+			}
+			catch (...)
+			{
+			}
+			throw;
+		}
+		wait(group, false);
+	}
+
+	void WorkerPool::join_phase(TickPhase phase)
+	{
+		TaskGroup& group = phase_groups[(size_t)phase];
+		if (!group.idle())
+			wait(group, true);
+		if (main_queued.load(std::memory_order_acquire) > 0)
+			run_main_jobs();
+	}
+
+	void WorkerPool::post_main(std::function<void()>&& fn)
+	{
+		{
+			std::lock_guard<std::mutex> lock(main_mutex);
+			main_jobs.push_back(std::move(fn));
+			main_queued.fetch_add(1);
+		}
+		notify_sleepers();
+	}
+
+	size_t WorkerPool::run_main_jobs()
+	{
+		size_t ran = 0;
+		while (true)
+		{
+			std::function<void()> fn;
+			{
+				std::lock_guard<std::mutex> lock(main_mutex);
+				if (main_jobs.empty())
+					return ran;
+				fn = std::move(main_jobs.front());
+				main_jobs.pop_front();
+				main_queued.fetch_sub(1);
+			}
+			fn();
+			++ran;
+		}
+	}
+
+	void WorkerPool::spawn(TaskGroup& group, std::function<void()>&& fn)
+	{
+		group.pending.fetch_add(1, std::memory_order_relaxed);
+		Deque& deque = *deques[local_deque];
+		{
+			std::lock_guard<std::mutex> lock(deque.mutex);
+			deque.jobs.push_back({ .fn = std::move(fn), .group = &group });
+			queued.fetch_add(1);
+		}
+		notify_sleepers();
+	}
+
+	void WorkerPool::wait(TaskGroup& group, bool drain_main)
+	{
+		while (!group.idle())
+		{
+			if (drain_main && main_queued.load() > 0)
+			{
+				run_main_jobs();
+				continue;
+			}
+			if (run_one())
+				continue;
+
+			// the group's remaining jobs are running on other threads
+			std::unique_lock<std::mutex> lock(mutex);
+			sleepers.fetch_add(1);
+			wake.wait(lock, [this, &group, drain_main]() { return group.idle() || queued.load() > 0 || (drain_main && main_queued.load() > 0); });
+			sleepers.fetch_sub(1);
+		}
+
+		std::exception_ptr rethrow = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(group.exception_mutex);
+			std::swap(rethrow, group.exception);
+		}
+		if (rethrow)
+			std::rethrow_exception(rethrow);
+	}
+
+	bool WorkerPool::run_one()
+	{
+		Job job;
+		if (!pop(job) && !steal(job))
+			return false;
+
+		execute(job);
+		return true;
+	}
+
+	bool WorkerPool::pop(Job& job)
+	{
+		Deque& deque = *deques[local_deque];
+		std::lock_guard<std::mutex> lock(deque.mutex);
+		if (deque.jobs.empty())
+			return false;
+
+		job = std::move(deque.jobs.back());
+		deque.jobs.pop_back();
+		queued.fetch_sub(1);
+		return true;
+	}
+
+	bool WorkerPool::steal(Job& job)
+	{
+		for (size_t i = 1; i < deques.size(); ++i)
+		{
+			Deque& deque = *deques[(local_deque + i) % deques.size()];
+			std::lock_guard<std::mutex> lock(deque.mutex);
+			if (!deque.jobs.empty())
+			{
+				job = std::move(deque.jobs.front());
+				deque.jobs.pop_front();
+				queued.fetch_sub(1);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void WorkerPool::execute(Job& job)
+	{
+		try
+		{
+			job.fn();
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(job.group->exception_mutex);
+			if (!job.group->exception)
+				job.group->exception = std::current_exception();
+		}
+
+		// the job's captures are released before the group is seen idle, since the group and what they reference may then be destroyed
+		job.fn = nullptr;
+		if (job.group->pending.fetch_sub(1) == 1)
+			notify_sleepers();
+	}
+
+	void WorkerPool::notify_sleepers()
+	{
+		// sleepers register before checking their wake condition, so a sleeper that is missed here has yet to check it
+		if (sleepers.load() > 0)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+			}
+			wake.notify_all();
+		}
+	}
+
+	void WorkerPool::worker_loop(size_t deque)
+	{
+		local_deque = deque;
+		while (true)
+		{
+			if (run_one())
+				continue;
+
+			std::unique_lock<std::mutex> lock(mutex);
+			sleepers.fetch_add(1);
+			wake.wait(lock, [this]() { return stopping || queued.load() > 0; });
+			sleepers.fetch_sub(1);
+			if (stopping)
+				return;
+		}
+	}
+
+	void WorkerPool::split(TaskGroup& group, const RangeFunction& fn, size_t begin, size_t end, size_t grain)
+	{
+		// the upper half is left to thieves while this thread keeps splitting the lower half, on chunk boundaries
+		while (end - begin > grain)
+		{
+			const size_t chunks = (end - begin + grain - 1) / grain;
+			const size_t mid = begin + (chunks / 2) * grain;
+			spawn(group, [this, &group, &fn, mid, end, grain]() { split(group, fn, mid, end, grain); });
+			end = mid;
+		}
+		fn(begin, end);
+	}
+}
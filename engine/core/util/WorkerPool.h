@@ -0,0 +1,116 @@
+#pragma once
+
+#include "core/types/Singleton.h"
+#include "core/context/TickService.h"
+
+#include <vector>
+#include <deque>
+#include <array>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+
+namespace oly
+{
+	class WorkerPool;
+
+	// Jobs forked with run() and joined with wait(). A waiting thread executes queued jobs instead of blocking, so groups may be nested inside jobs.
+	class TaskGroup
+	{
+		friend class WorkerPool;
+
+		std::atomic<size_t> pending = 0;
+		std::mutex exception_mutex;
+		std::exception_ptr exception = nullptr;
+
+	public:
+		TaskGroup() = default;
+		TaskGroup(const TaskGroup&) = delete;
+		TaskGroup(TaskGroup&&) = delete;
+		~TaskGroup();
+
+		void run(std::function<void()>&& fn);
+		// Rethrows the first exception thrown by the group's jobs.
+		void wait();
+		bool idle() const { return pending.load(std::memory_order_acquire) == 0; }
+	};
+
+	// Work-stealing job system. Each worker thread owns a deque that it pushes to and pops from at the back, and steals from the front of other
+	// deques when its own is empty. Threads outside the pool share one deque.
+	class WorkerPool final : public Singleton<WorkerPool>
+	{
+		friend class Singleton<WorkerPool>;
+		friend class TaskGroup;
+
+	public:
+		using RangeFunction = std::function<void(size_t begin, size_t end)>;
+
+	private:
+		struct Job
+		{
+			std::function<void()> fn;
+			TaskGroup* group = nullptr;
+		};
+
+		struct Deque
+		{
+			std::mutex mutex;
+			std::deque<Job> jobs;
+		};
+
+		std::vector<std::thread> threads;
+		std::vector<std::unique_ptr<Deque>> deques;
+		std::atomic<size_t> queued = 0;
+
+		std::mutex mutex;
+		std::condition_variable wake;
+		std::atomic<size_t> sleepers = 0;
+		bool stopping = false;
+
+		std::mutex main_mutex;
+		std::deque<std::function<void()>> main_jobs;
+		std::atomic<size_t> main_queued = 0;
+
+		std::array<TaskGroup, (size_t)TickPhase::None> phase_groups;
+
+		static inline std::atomic<bool> alive = false;
+
+		WorkerPool();
+
+	public:
+		~WorkerPool();
+
+		// Whether the pool has been created. The pool is only created on first use, so programs that never fan out work don't spawn threads.
+		static bool exists() { return alive.load(std::memory_order_acquire); }
+
+		size_t concurrency() const { return threads.size() + 1; }
+
+		// Splits [0, count) into chunks of grain indices, which are run across the pool, and returns once all have run. May be called from any
+		// thread, including from inside a job.
+		void parallel_for(size_t count, size_t grain, const RangeFunction& fn);
+
+		// Jobs run in a tick phase's group are joined by the tick service registry before the next phase starts.
+		TaskGroup& phase_jobs(TickPhase phase) { return phase_groups[(size_t)phase]; }
+		void join_phase(TickPhase phase);
+
+		// Queues work that must run on the main thread, such as GL calls. Main thread jobs run when a phase is joined, and jobs must not wait on them.
+		void post_main(std::function<void()>&& fn);
+		// Returns the number of jobs run. Must be called from the main thread.
+		size_t run_main_jobs();
+
+	private:
+		void spawn(TaskGroup& group, std::function<void()>&& fn);
+		void wait(TaskGroup& group, bool drain_main);
+		bool run_one();
+		bool pop(Job& job);
+		bool steal(Job& job);
+		void execute(Job& job);
+		void notify_sleepers();
+		void worker_loop(size_t deque);
+		void split(TaskGroup& group, const RangeFunction& fn, size_t begin, size_t end, size_t grain);
+	};
+}
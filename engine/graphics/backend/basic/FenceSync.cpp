@@ -1,5 +1,10 @@
 #include "FenceSync.h"
 
+#include "core/util/Time.h"
+#include "core/util/Logger.h"
+
+#include <algorithm>
+
 namespace oly::graphics
 {
 	FenceSync::FenceSync()
@@ -46,4 +51,63 @@ namespace oly::graphics
 		glGetSynciv(_sync, GL_SYNC_STATUS, sizeof(GLint), nullptr, &result);
 		return result == GL_SIGNALED;
 	}
+
+	void FrameFenceRing::wait(const FenceSync& fence)
+	{
+		Stopwatch stopwatch;
+		for (GLuint i = 0; i < MAX_TIMEOUT_TRIES; ++i)
+		{
+			if (fence.wait(TIMEOUT_NS))
+			{
+				const double wait = stopwatch.lap();
+				stats.wait += wait;
+				stats.max_wait = std::max(stats.max_wait, wait);
+				return;
+			}
+			// TODO v13 alt-tabbing and otherwise switching window focus causes timeout -> avoid syncing when window is not in focus?
+			_OLY_ENGINE_LOG_DEBUG("GRAPHICS") << "Timeout in frame fence sync - attempt (" << i << ")" << LOG.nl;
+		}
+		_OLY_ENGINE_LOG_ERROR("GRAPHICS") << "Timeout in frame fence sync - all attempts failed" << LOG.nl;
+		throw Error(ErrorCode::OutOfTime);
+	}
+
+	void FrameFenceRing::begin_frame()
+	{
+		fences[frame].emplace();
+		frame = (frame + 1) % FRAMES;
+		++_epoch;
+		++stats.frames;
+
+		std::optional<FenceSync>& fence = fences[frame];
+		if (fence && !fence->signaled())
+		{
+			wait(*fence);
+			++stats.stalled_frames;
+		}
+		fence.reset();
+	}
+
+	void FrameFenceRing::end_frame()
+	{
+		stats.bytes_flushed += frame_bytes_flushed;
+		stats.flushes += frame_flushes;
+		stats.last_frame_bytes_flushed = frame_bytes_flushed;
+		stats.last_frame_flushes = frame_flushes;
+		frame_bytes_flushed = 0;
+		frame_flushes = 0;
+	}
+
+	void FrameFenceRing::sync()
+	{
+		wait(FenceSync());
+		++_epoch;
+		++stats.syncs;
+	}
+
+	void FrameFenceRing::clear()
+	{
+		for (std::optional<FenceSync>& fence : fences)
+			fence.reset();
+		frame = 0;
+	}
 }
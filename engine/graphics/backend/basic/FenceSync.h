@@ -2,6 +2,10 @@
 
 #include "external/GL.h"
 #include "core/base/Errors.h"
+#include "core/types/Singleton.h"
+
+#include <array>
+#include <optional>
 
 namespace oly::graphics
 {
@@ -19,4 +23,63 @@ namespace oly::graphics
 		bool wait(GLuint64 timeout_ns) const;
 		bool signaled() const;
 	};
+
+	// Ring of fences over the frames in flight. Persistent buffers keep one region per frame of the ring, so the CPU fills the current frame's
+	// region while the GPU may still read the previous ones, and only waits on the GPU when it gets FRAMES frames ahead.
+	// A region drawn from more than once per frame, or between frames, can't be rewritten until the GPU is done with the earlier draw. Buffers
+	// detect this with epoch(), which changes whenever every region of the current frame becomes free, and wait with sync().
+	class FrameFenceRing final : public Singleton<FrameFenceRing>
+	{
+		friend class Singleton<FrameFenceRing>;
+
+	public:
+		static constexpr GLuint FRAMES = 3;
+		static constexpr GLuint64 TIMEOUT_NS = 10'000'000; // 10ms
+		static constexpr GLuint MAX_TIMEOUT_TRIES = 100; // 1s total
+
+		// wall-clock seconds the CPU spent blocked on fences, the syncs forced by regions drawn from twice per epoch, and bytes uploaded to
+		// persistent buffers with the number of flushes
+		struct Stats
+		{
+			double wait = 0.0;
+			double max_wait = 0.0;
+			size_t stalled_frames = 0;
+			size_t frames = 0;
+			size_t syncs = 0;
+
+			size_t bytes_flushed = 0;
+			size_t flushes = 0;
+			size_t last_frame_bytes_flushed = 0;
+			size_t last_frame_flushes = 0;
+		};
+
+	private:
+		std::array<std::optional<FenceSync>, FRAMES> fences;
+		GLuint frame = 0;
+		size_t _epoch = 0;
+		Stats stats;
+		size_t frame_bytes_flushed = 0;
+		size_t frame_flushes = 0;
+
+		FrameFenceRing() = default;
+
+		void wait(const FenceSync& fence);
+
+	public:
+		GLuint current() const { return frame; }
+		size_t epoch() const { return _epoch; }
+
+		// fences the commands issued since the last frame began, including draws made between frames, and advances to the next frame, waiting
+		// until the GPU is done with the last frame that used it
+		void begin_frame();
+		void end_frame();
+		// waits until the GPU is done with all commands issued so far, so that the current frame's regions may be rewritten
+		void sync();
+		void clear();
+
+		void record_flush(size_t bytes) { frame_bytes_flushed += bytes; ++frame_flushes; }
+
+		const Stats& get_stats() const { return stats; }
+		void reset_stats() { stats = {}; }
+	};
 }
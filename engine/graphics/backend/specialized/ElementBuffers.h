@@ -53,6 +53,8 @@ namespace oly::graphics
 		mutable LazyPersistentGPUBuffer<std::array<GLuint, PrimitiveIndices>> ebo;
 		mutable GLuint draw_count = 0;
 		GLuint vao = 0;
+		// frame whose buffer is bound to the VAO
+		mutable GLuint bound_frame = FrameFenceRing::FRAMES;
 
 	public:
 		GLuint offset = 0;
@@ -81,6 +83,7 @@ namespace oly::graphics
 			glBindVertexArray(vao);
 			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo.buf.get_buffer());
 			glBindVertexArray(0);
+			bound_frame = FrameFenceRing::instance().current();
 		}
 
 	public:
@@ -93,9 +96,24 @@ namespace oly::graphics
 			return ebo.buf[primitive];
 		}
 
+		std::array<GLuint, PrimitiveIndices>* draw_primitives(GLuint count) const
+		{
+			GLuint first = offset + draw_count;
+			draw_count += count;
+			while (first + count > ebo.buf.get_size())
+				grow();
+			return ebo.set(first, count);
+		}
+
+		// expects the VAO to be bound
 		void render_elements(GLenum mode) const
 		{
 			ebo.pre_draw();
+			if (bound_frame != FrameFenceRing::instance().current())
+			{
+				bind_to_vao();
+				glBindVertexArray(vao);
+			}
 			glDrawElements(mode, draw_count * PrimitiveIndices, GL_UNSIGNED_INT, (void*)(offset * PrimitiveIndices * sizeof(GLuint)));
 			draw_count = 0;
 			ebo.post_draw();
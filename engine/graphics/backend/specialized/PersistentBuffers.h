@@ -6,82 +6,78 @@
 #include "graphics/backend/basic/Buffers.h"
 #include "graphics/backend/basic/FenceSync.h"
 
+#include <vector>
+#include <tuple>
+#include <algorithm>
+
 namespace oly::graphics
 {
 	namespace internal
 	{
 		struct PersistentOptions
 		{
-			GLuint64 timeout_ns = 10'000'000; // 10ms
-			GLuint max_timeout_tries = 100; // 1s total
 			float grow_multiplier = 1.8f;
 		};
 	}
 
+	// Persistently mapped buffer with one region per frame of the FrameFenceRing. Elements are written to a CPU-side copy, and pre_draw() copies
+	// ranges of it into the current frame's region, which the GPU is no longer reading from. post_draw() marks the region as drawn from, and
+	// the next draw's sync_region() only waits on the GPU if that happened in the ring's current epoch.
 	template<typename Struct, internal::PersistentOptions options = internal::PersistentOptions{}>
 	class PersistentGPUBuffer
 	{
-		GLBuffer buf;
-		mutable bool accessible = true;
+		static constexpr GLuint FRAMES = FrameFenceRing::FRAMES;
+
+		std::array<GLBuffer, FRAMES> buf;
+		std::array<void*, FRAMES> data = {};
+		std::vector<Struct> cpudata;
 		GLuint size = 0;
-		void* data = nullptr;
+		mutable size_t drawn_epoch = size_t(-1);
 
 	public:
 		using StructAlias = Struct;
 
 		PersistentGPUBuffer(GLuint size = 0)
-			: size(size)
+			: cpudata(size), size(size)
 		{
 			if (size)
-			{
-				glNamedBufferStorage(buf, (GLsizeiptr)(size * sizeof(Struct)), nullptr, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT);
-				data = glMapNamedBufferRange(buf, 0, (GLsizeiptr)(size * sizeof(Struct)), GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_FLUSH_EXPLICIT_BIT);
-			}
+				allocate();
 		}
 
 		PersistentGPUBuffer(const PersistentGPUBuffer&) = delete;
 		PersistentGPUBuffer(PersistentGPUBuffer&&) = delete;
 
 		GLuint get_size() const { return size; }
-		
-		GLuint get_buffer() const { return buf; }
-		
-		bool is_accessible() const { return accessible; }
+
+		// buffer that the current frame draws from
+		GLuint get_buffer() const { return buf[FrameFenceRing::instance().current()]; }
 
 		const Struct& operator[](GLuint i) const
 		{
-			if (!accessible)
-				throw Error(ErrorCode::Inaccessible);
 			if (i >= size)
 				throw Error(ErrorCode::IndexOutOfRange);
-			return reinterpret_cast<const Struct*>(data)[i];
+			return cpudata[i];
 		}
 
 		Struct& operator[](GLuint i)
 		{
-			if (!accessible)
-				throw Error(ErrorCode::Inaccessible);
 			if (i >= size)
 				throw Error(ErrorCode::IndexOutOfRange);
-			return reinterpret_cast<Struct*>(data)[i];
+			return cpudata[i];
 		}
 
 		const Struct* arr(GLuint offset, GLuint length) const
 		{
-			if (!accessible)
-				throw Error(ErrorCode::Inaccessible);
 			if (offset + length > size)
 				throw Error(ErrorCode::IndexOutOfRange);
-			return reinterpret_cast<const Struct*>(data) + offset;
+			return cpudata.data() + offset;
 		}
 
 		Struct* arr(GLuint offset, GLuint length)
 		{
-			if (!accessible)
-				throw Error(ErrorCode::Inaccessible);
 			if (offset + length > size)
 				throw Error(ErrorCode::IndexOutOfRange);
-			return reinterpret_cast<Struct*>(data) + offset;
+			return cpudata.data() + offset;
 		}
 
 		void grow()
@@ -90,24 +86,29 @@ namespace oly::graphics
 			grow(new_size > size ? new_size : size + 1);
 		}
 
+		// regions are reallocated empty - they must be fully copied into again before drawing from them
 		void grow(GLuint new_size)
 		{
-			if (!accessible)
-				throw Error(ErrorCode::Inaccessible);
 			if (new_size <= size)
 				return;
 
-			GLuint old_size = size;
 			size = new_size;
-
-			GLBuffer old_buf;
-			std::swap(buf, old_buf);
-			glNamedBufferStorage(buf, (GLsizeiptr)(size * sizeof(Struct)), nullptr, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT);
-			glCopyNamedBufferSubData(old_buf, buf, 0, 0, old_size * sizeof(Struct));
-			data = glMapNamedBufferRange(buf, 0, (GLsizeiptr)(size * sizeof(Struct)), GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_FLUSH_EXPLICIT_BIT);
+			cpudata.resize(size);
+			for (GLBuffer& b : buf)
+				b = GLBuffer();
+			allocate();
+			drawn_epoch = size_t(-1);
 			// no need to unmap old data, since it uses persistent bit
 		}
 
+		void sync_region() const
+		{
+			FrameFenceRing& frame_fences = FrameFenceRing::instance();
+			if (drawn_epoch == frame_fences.epoch())
+				frame_fences.sync();
+		}
+
+		// expects sync_region() to have been called for the draw
 		void pre_draw(GLuint offset, GLuint length) const
 		{
 			if (offset + length > size)
@@ -115,41 +116,37 @@ namespace oly::graphics
 				if (offset >= size)
 					throw Error(ErrorCode::IndexOutOfRange);
 				else
-					length = size - 1 - offset;
+					length = size - offset;
 			}
-			glFlushMappedNamedBufferRange(buf, (GLintptr)(offset * sizeof(Struct)), (GLsizeiptr)(length * sizeof(Struct)));
+
+			FrameFenceRing& frame_fences = FrameFenceRing::instance();
+			const GLuint frame = frame_fences.current();
+			std::copy_n(cpudata.data() + offset, length, reinterpret_cast<Struct*>(data[frame]) + offset);
+			glFlushMappedNamedBufferRange(buf[frame], (GLintptr)(offset * sizeof(Struct)), (GLsizeiptr)(length * sizeof(Struct)));
+			frame_fences.record_flush(length * sizeof(Struct));
 		}
 
 		void pre_draw() const
 		{
-			glFlushMappedNamedBufferRange(buf, (GLintptr)0, (GLsizeiptr)(size * sizeof(Struct)));
+			sync_region();
+			if (size)
+				pre_draw(0, size);
 		}
 
-		void post_draw() const
+		void post_draw() const { drawn_epoch = FrameFenceRing::instance().epoch(); }
+
+		void bind_ssbo_base(GLuint index) const { glBindBufferBase(GL_SHADER_STORAGE_BUFFER, index, get_buffer()); }
+		void bind_ubo_base(GLuint index) const { glBindBufferBase(GL_UNIFORM_BUFFER, index, get_buffer()); }
+
+	private:
+		void allocate()
 		{
-			FenceSync sync;
-			if (sync.signaled())
-			{
-				accessible = true;
-				return;
-			}
-			for (GLuint i = 0; i < options.max_timeout_tries; ++i)
+			for (GLuint frame = 0; frame < FRAMES; ++frame)
 			{
-				if (sync.wait(options.timeout_ns))
-				{
-					accessible = true;
-					return;
-				}
-				// TODO v13 Fix sync usage: alt-tabbing and otherwise switching window focus causes timeout -> avoid syncing when window is not in focus? Also, instead of per-buffer fence, use either a buffer-level fence ring or a frame-level fence.
-				_OLY_ENGINE_LOG_DEBUG("GRAPHICS") << "Timeout in persistent buffer sync - attempt (" << i << ")" << LOG.nl;
+				glNamedBufferStorage(buf[frame], (GLsizeiptr)(size * sizeof(Struct)), nullptr, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT);
+				data[frame] = glMapNamedBufferRange(buf[frame], 0, (GLsizeiptr)(size * sizeof(Struct)), GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_FLUSH_EXPLICIT_BIT);
 			}
-			accessible = false;
-			_OLY_ENGINE_LOG_ERROR("GRAPHICS") << "Timeout in persistent buffer sync - all attempts failed" << LOG.nl;
-			throw Error(ErrorCode::OutOfTime);
 		}
-
-		void bind_ssbo_base(GLuint index) const { glBindBufferBase(GL_SHADER_STORAGE_BUFFER, index, buf); }
-		void bind_ubo_base(GLuint index) const { glBindBufferBase(GL_UNIFORM_BUFFER, index, buf); }
 	};
 
 	template<typename... Structs>
@@ -161,217 +158,94 @@ namespace oly::graphics
 		using StructAlias = std::tuple_element_t<n, std::tuple<Structs...>>;
 
 	private:
-		static constexpr internal::PersistentOptions options = {};
-		GLBufferBlock<N> buf;
-		mutable std::array<bool, N> accessible;
-		std::array<GLuint, N> size;
-		std::array<void*, N> data;
+		std::tuple<PersistentGPUBuffer<Structs>...> buf;
 
-	public:
-		PersistentGPUBufferBlock(GLuint size = 0)
+		template<size_t... Indices>
+		PersistentGPUBufferBlock(const std::array<GLuint, N>& sizes, std::index_sequence<Indices...>)
+			: buf(sizes[Indices]...)
 		{
-			accessible.fill(true);
-			this->size.fill(size);
-			data.fill(nullptr);
-			init(std::make_index_sequence<N>{});
 		}
 
-		PersistentGPUBufferBlock(const std::array<GLuint, N>& sizes)
-			: size(sizes)
+		static std::array<GLuint, N> filled(GLuint size)
 		{
-			accessible.fill(true);
-			data.fill(nullptr);
-			init(std::make_index_sequence<N>{});
+			std::array<GLuint, N> sizes;
+			sizes.fill(size);
+			return sizes;
 		}
-		
+
+	public:
+		PersistentGPUBufferBlock(GLuint size = 0) : PersistentGPUBufferBlock(filled(size)) {}
+		PersistentGPUBufferBlock(const std::array<GLuint, N>& sizes) : PersistentGPUBufferBlock(sizes, std::make_index_sequence<N>{}) {}
+
 		PersistentGPUBufferBlock(const PersistentGPUBufferBlock&) = delete;
 		PersistentGPUBufferBlock(PersistentGPUBufferBlock&&) = delete;
 
 		template<size_t n>
-		GLuint get_size() const { return size[n]; }
+		GLuint get_size() const { return std::get<n>(buf).get_size(); }
 
 		template<size_t n>
-		GLuint get_buffer() const { return buf[n]; }
-		
-		template<size_t n>
-		bool is_accessible() const { return accessible[n]; }
+		GLuint get_buffer() const { return std::get<n>(buf).get_buffer(); }
 
 		template<size_t n>
-		const StructAlias<n>& at(GLuint i) const
-		{
-			static_assert(n < N);
-			if (!accessible[n])
-				throw Error(ErrorCode::Inaccessible);
-			if (i >= size[n])
-				throw Error(ErrorCode::IndexOutOfRange);
-			return reinterpret_cast<const StructAlias<n>*>(data[n])[i];
-		}
+		const StructAlias<n>& at(GLuint i) const { return std::get<n>(buf)[i]; }
 
 		template<size_t n>
-		StructAlias<n>& at(GLuint i)
-		{
-			static_assert(n < N);
-			if (!accessible[n])
-				throw Error(ErrorCode::Inaccessible);
-			if (i >= size[n])
-				throw Error(ErrorCode::IndexOutOfRange);
-			return reinterpret_cast<StructAlias<n>*>(data[n])[i];
-		}
+		StructAlias<n>& at(GLuint i) { return std::get<n>(buf)[i]; }
 
 		template<size_t n>
-		const StructAlias<n>* arr(GLuint offset, GLuint length) const
-		{
-			static_assert(n < N);
-			if (!accessible[n])
-				throw Error(ErrorCode::Inaccessible);
-			if (offset + length > size[n])
-				throw Error(ErrorCode::IndexOutOfRange);
-			return reinterpret_cast<const StructAlias<n>*>(data[n]) + offset;
-		}
+		const StructAlias<n>* arr(GLuint offset, GLuint length) const { return std::get<n>(buf).arr(offset, length); }
 
 		template<size_t n>
-		StructAlias<n>* arr(GLuint offset, GLuint length)
-		{
-			static_assert(n < N);
-			if (!accessible[n])
-				throw Error(ErrorCode::Inaccessible);
-			if (offset + length > size[n])
-				throw Error(ErrorCode::IndexOutOfRange);
-			return reinterpret_cast<StructAlias<n>*>(data[n]) + offset;
-		}
-
-		void grow_all()
-		{
-			grow_impl(std::make_index_sequence<N>{});
-		}
+		StructAlias<n>* arr(GLuint offset, GLuint length) { return std::get<n>(buf).arr(offset, length); }
 
-	private:
-		template<size_t... Indices>
-		void grow_impl(std::index_sequence<Indices...>) const
-		{
-			(grow<Indices>(), ...);
-		}
+		void grow_all() { std::apply([](auto&... b) { (b.grow(), ...); }, buf); }
 
-	public:
 		template<size_t n>
-		void grow()
-		{
-			static_assert(n < N);
-			GLuint new_size = (GLuint)(options.grow_multiplier * size[n]);
-			grow<n>(new_size > size[n] ? new_size : size[n] + 1);
-		}
+		void grow() { std::get<n>(buf).grow(); }
 
 		template<size_t n>
-		void grow(GLuint new_size)
-		{
-			static_assert(n < N);
-			if (!accessible[n])
-				throw Error(ErrorCode::Inaccessible);
-			if (new_size <= size[n])
-				return;
-
-			GLuint old_size = size[n];
-			size[n] = new_size;
+		void grow(GLuint new_size) { std::get<n>(buf).grow(new_size); }
 
-			GLBuffer old_buf;
-			buf.swap<n>(old_buf);
-			glNamedBufferStorage(buf[n], (GLsizeiptr)(size[n] * sizeof(StructAlias<n>)), nullptr, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT);
-			glCopyNamedBufferSubData(old_buf, buf[n], 0, 0, old_size * sizeof(StructAlias<n>));
-			data[n] = glMapNamedBufferRange(buf[n], 0, (GLsizeiptr)(size[n] * sizeof(StructAlias<n>)), GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_FLUSH_EXPLICIT_BIT);
-			// no need to unmap old data, since it uses persistent bit
-		}
+		template<size_t n>
+		void sync_region() const { std::get<n>(buf).sync_region(); }
 
 		template<size_t n>
-		void pre_draw(GLuint offset, GLuint length) const
-		{
-			static_assert(n < N);
-			if (offset + length > size[n])
-			{
-				if (offset >= size[n])
-					throw Error(ErrorCode::IndexOutOfRange);
-				else
-					length = size[n] - 1 - offset;
-			}
-			glFlushMappedNamedBufferRange(buf[n], (GLintptr)(offset * sizeof(StructAlias<n>)), (GLsizeiptr)(length * sizeof(StructAlias<n>)));
-		}
+		void pre_draw(GLuint offset, GLuint length) const { std::get<n>(buf).pre_draw(offset, length); }
 
 		template<size_t n>
-		void pre_draw() const
-		{
-			static_assert(n < N);
-			glFlushMappedNamedBufferRange(buf[n], (GLintptr)0, (GLsizeiptr)(size[n] * sizeof(StructAlias<n>)));
-		}
+		void pre_draw() const { std::get<n>(buf).pre_draw(); }
 
-		void pre_draw_all() const
-		{
-			pre_draw_impl(std::make_index_sequence<N>{});
-		}
+		void pre_draw_all() const { std::apply([](const auto&... b) { (b.pre_draw(), ...); }, buf); }
 
-	private:
-		template<size_t... Indices>
-		void pre_draw_impl(std::index_sequence<Indices...>) const
-		{
-			(pre_draw<Indices>(), ...);
-		}
+		template<size_t n>
+		void post_draw() const { std::get<n>(buf).post_draw(); }
+
+		void post_draw_all() const { std::apply([](const auto&... b) { (b.post_draw(), ...); }, buf); }
 
-	public:
 		template<size_t n>
-		void post_draw() const
-		{
-			static_assert(n < N);
-			FenceSync sync;
-			if (sync.signaled())
-			{
-				accessible[n] = true;
-				return;
-			}
-			for (GLuint i = 0; i < options.max_timeout_tries; ++i)
-			{
-				if (sync.wait(options.timeout_ns))
-				{
-					accessible[n] = true;
-					return;
-				}
-				// TODO v13 Fix sync usage: alt-tabbing and otherwise switching window focus causes timeout -> avoid syncing when window is not in focus? Also, instead of per-buffer fence, use either a buffer-level fence ring or a frame-level fence.
-				_OLY_ENGINE_LOG_DEBUG("GRAPHICS") << "Timeout in persistent buffer sync - attempt (" << i << ")" << LOG.nl;
-			}
-			accessible[n] = false;
-			_OLY_ENGINE_LOG_ERROR("GRAPHICS") << "Timeout in persistent buffer sync - all attempts failed" << LOG.nl;
-			throw Error(ErrorCode::OutOfTime);
-		}
+		void bind_ssbo_base(GLuint index) const { std::get<n>(buf).bind_ssbo_base(index); }
 
-		void post_draw_all() const
-		{
-			post_draw_impl(std::make_index_sequence<N>{});
-		}
+		template<size_t n>
+		void bind_ubo_base(GLuint index) const { std::get<n>(buf).bind_ubo_base(index); }
+	};
 
-	private:
-		template<size_t... Indices>
-		void post_draw_impl(std::index_sequence<Indices...>) const
+	namespace internal
+	{
+		// Indices written since each frame's region was last brought up to date. Writes are flagged for every frame, and a frame's indices are
+		// consumed when it draws. Runs separated by a few clean elements are uploaded together, since copying them is cheaper than another flush.
+		class FrameDirtyRanges
 		{
-			(post_draw<Indices>(), ...);
-		}
+			static constexpr GLuint MERGE_GAP = 8;
+			std::array<DirtyIntervals<GLuint>, FrameFenceRing::FRAMES> dirty;
 
-		template<size_t... Indices>
-		void init(std::index_sequence<Indices...>)
-		{
-			((
-				size[Indices] > 0 ?
-				(
-					glNamedBufferStorage(buf[Indices], (GLsizeiptr)(size[Indices] * sizeof(StructAlias<Indices>)), nullptr, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT),
-					data[Indices] = glMapNamedBufferRange(buf[Indices], 0, (GLsizeiptr)(size[Indices] * sizeof(StructAlias<Indices>)), GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_FLUSH_EXPLICIT_BIT),
-					0
-				) : 0
-				), ...);
-		}
+		public:
+			FrameDirtyRanges() { dirty.fill(DirtyIntervals<GLuint>(MERGE_GAP)); }
 
-	public:
-		template<size_t n>
-		void bind_ssbo_base(GLuint index) const { glBindBufferBase(GL_SHADER_STORAGE_BUFFER, index, buf[n]); }
-		
-		template<size_t n>
-		void bind_ubo_base(GLuint index) const { glBindBufferBase(GL_UNIFORM_BUFFER, index, buf[n]); }
-	};
+			void insert(GLuint index) { for (DirtyIntervals<GLuint>& d : dirty) d.insert(index); }
+			void insert(Range<GLuint> range) { for (DirtyIntervals<GLuint>& d : dirty) d.insert(range); }
+			DirtyIntervals<GLuint>& current() { return dirty[FrameFenceRing::instance().current()]; }
+		};
+	}
 
 	template<typename Struct, internal::PersistentOptions options = internal::PersistentOptions{} >
 	struct LazyPersistentGPUBuffer
@@ -379,17 +253,18 @@ namespace oly::graphics
 		PersistentGPUBuffer<Struct, options> buf;
 
 	private:
-		mutable RangeMerger<GLuint> dirty;
+		mutable internal::FrameDirtyRanges dirty;
 
 	public:
 		LazyPersistentGPUBuffer(GLuint size = 0) : buf(size) {}
 
-		void flag(GLuint pos) const { dirty.insert({ pos, 1 }); }
+		void flag(GLuint pos) const { dirty.insert(pos); }
 
 		void pre_draw() const
 		{
-			for (Range<GLuint> range : dirty)
-			{
+			buf.sync_region();
+			DirtyIntervals<GLuint>& ranges = dirty.current();
+			ranges.for_each([this](Range<GLuint> range) {
 				try
 				{
 					buf.pre_draw(range.initial, range.length);
@@ -401,11 +276,11 @@ namespace oly::graphics
 					else
 						throw;
 				}
-			}
-			dirty.clear();
+				});
+			ranges.clear();
 		}
 		void post_draw() const { buf.post_draw(); }
-		void grow() { buf.grow(); buf.pre_draw(); dirty.clear(); }
+		void grow() { buf.grow(); dirty.insert({ 0, buf.get_size() }); }
 
 		const Struct& get(GLuint i) const
 		{
@@ -429,8 +304,7 @@ namespace oly::graphics
 		{
 			while (offset + length > buf.get_size())
 				grow();
-			for (GLuint i = 0; i < length; ++i)
-				flag(offset + i);
+			dirty.insert({ offset, length });
 			return buf.arr(offset, length);
 		}
 	};
@@ -444,7 +318,7 @@ namespace oly::graphics
 		using StructAlias = typename PersistentGPUBufferBlock<Structs...>::template StructAlias<n>;
 
 	private:
-		mutable std::array<RangeMerger<GLuint>, N> dirty;
+		mutable std::array<internal::FrameDirtyRanges, N> dirty;
 
 	public:
 		LazyPersistentGPUBufferBlock(GLuint size = 0) : buf(size) {}
@@ -454,18 +328,19 @@ namespace oly::graphics
 		void flag(GLuint pos) const
 		{
 			static_assert(n < N);
-			dirty[n].insert({ pos, 1 });
+			dirty[n].insert(pos);
 		}
 
 		template<size_t n>
 		void pre_draw() const
 		{
 			static_assert(n < N);
-			for (Range<GLuint> range : dirty[n])
-			{
+			buf.template sync_region<n>();
+			DirtyIntervals<GLuint>& ranges = dirty[n].current();
+			ranges.for_each([this](Range<GLuint> range) {
 				try
 				{
-					buf.pre_draw<n>(range.initial, range.length);
+					buf.template pre_draw<n>(range.initial, range.length);
 				}
 				catch (const Error& e)
 				{
@@ -474,8 +349,8 @@ namespace oly::graphics
 					else
 						throw;
 				}
-			}
-			dirty[n].clear();
+				});
+			ranges.clear();
 		}
 		void pre_draw_all() const { pre_draw_impl(std::make_index_sequence<N>{}); }
 
@@ -485,66 +360,59 @@ namespace oly::graphics
 
 	public:
 		template<size_t n>
-		void post_draw() const { static_assert(n < N); buf.post_draw<n>(); }
+		void post_draw() const { static_assert(n < N); buf.template post_draw<n>(); }
+		void post_draw_all() const { buf.post_draw_all(); }
 
-		void post_draw_all() const { post_draw_impl(std::make_index_sequence<N>{}); }
-
-	private:
-		template<size_t... Indices>
-		void post_draw_impl(std::index_sequence<Indices...>) const { (post_draw<Indices>(), ...); }
-
-	public:
 		template<size_t n>
-		void grow() { static_assert(n < N); buf.grow<n>(); buf.pre_draw<n>(); dirty[n].clear(); }
+		void grow() { static_assert(n < N); buf.template grow<n>(); dirty[n].insert({ 0, buf.template get_size<n>() }); }
 
-		void grow_all() const { grow_impl(std::make_index_sequence<N>{}); }
+		void grow_all() { grow_impl(std::make_index_sequence<N>{}); }
 
 	private:
 		template<size_t... Indices>
-		void grow_impl(std::index_sequence<Indices...>) const { (grow<Indices>(), ...); }
+		void grow_impl(std::index_sequence<Indices...>) { (grow<Indices>(), ...); }
 
 	public:
 		template<size_t n>
 		const StructAlias<n>& get(GLuint i) const
 		{
 			static_assert(n < N);
-			return buf.at<n>(i);
+			return buf.template at<n>(i);
 		}
 
 		template<size_t n>
 		StructAlias<n>& set(GLuint i, bool* grown = nullptr)
 		{
 			static_assert(n < N);
-			while (i >= buf.get_size<n>())
+			while (i >= buf.template get_size<n>())
 			{
 				grow<n>();
 				if (grown)
 					*grown = true;
 			}
 			flag<n>(i);
-			return buf.at<n>(i);
+			return buf.template at<n>(i);
 		}
 
 		template<size_t n>
 		const StructAlias<n>* get(GLuint offset, GLuint length) const
 		{
 			static_assert(n < N);
-			return buf.arr<n>(offset, length);
+			return buf.template arr<n>(offset, length);
 		}
 
 		template<size_t n>
 		StructAlias<n>* set(GLuint offset, GLuint length, bool* grown = nullptr)
 		{
 			static_assert(n < N);
-			while (offset + length > buf.get_size<n>())
+			while (offset + length > buf.template get_size<n>())
 			{
 				grow<n>();
 				if (grown)
 					*grown = true;
 			}
-			for (GLuint i = 0; i < length; ++i)
-				flag<n>(offset + i);
-			return buf.arr<n>(offset, length);
+			dirty[n].insert({ offset, length });
+			return buf.template arr<n>(offset, length);
 		}
 	};
 }
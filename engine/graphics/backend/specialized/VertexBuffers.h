@@ -10,6 +10,8 @@ namespace oly::graphics
 	{
 		LazyPersistentGPUBufferBlock<Structs...> buf;
 		GLuint vao;
+		// frame whose buffers are bound to the VAO
+		mutable GLuint bound_frame = FrameFenceRing::FRAMES;
 
 	public:
 		template<size_t n>
@@ -22,11 +24,12 @@ namespace oly::graphics
 
 		PersistentVertexBufferBlock(GLuint vao, const std::array<GLuint, N>& sizes) : vao(vao), buf(sizes) {}
 
-		void setup()
+		void setup() const
 		{
 			glBindVertexArray(vao);
 			setup_impl(std::make_index_sequence<N>{});
 			glBindVertexArray(0);
+			bound_frame = FrameFenceRing::instance().current();
 		}
 
 		void set_vao(const VertexArray& vao)
@@ -37,13 +40,13 @@ namespace oly::graphics
 
 	private:
 		template<size_t... Indices>
-		void setup_impl(std::index_sequence<Indices...>)
+		void setup_impl(std::index_sequence<Indices...>) const
 		{
 			(setup<Indices>(), ...);
 		}
 
 		template<size_t n>
-		void setup()
+		void setup() const
 		{
 			static_assert(n < N);
 			glBindBuffer(GL_ARRAY_BUFFER, buffer<n>());
@@ -51,7 +54,7 @@ namespace oly::graphics
 		}
 
 		template<size_t n>
-		void setup_Single()
+		void setup_Single() const
 		{
 			static_assert(n < N);
 			glBindVertexArray(vao);
@@ -66,20 +69,20 @@ namespace oly::graphics
 		template<size_t n>
 		GLuint size() const { return buf.buf.get_size<n>(); }
 		
-		template<size_t n>
-		void pre_draw() const { buf.pre_draw<n>(); }
-		
-		void pre_draw_all() const { buf.pre_draw_all(); }
-		
-		template<size_t n>
-		void post_draw() const { buf.post_draw<n>(); }
-		
+		// each frame draws from its own buffers, so the VAO is rebound when the frame changes
+		void pre_draw_all() const
+		{
+			if (bound_frame != FrameFenceRing::instance().current())
+				setup();
+			buf.pre_draw_all();
+		}
+
 		void post_draw_all() const { buf.post_draw_all(); }
 		
 		template<size_t n>
 		void grow() { buf.grow<n>(); setup_Single<n>(); }
 		
-		void grow_all() const { buf.grow_all(); setup(); }
+		void grow_all() { buf.grow_all(); setup(); }
 		
 		template<size_t n>
 		const StructAlias<n>& get(GLuint i) const { return buf.get<n>(i); }
@@ -0,0 +1,239 @@
+#include "ParticleSimulator.h"
+
+#include "graphics/particles/ShaderStructs.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace oly::particles
+{
+	namespace internal
+	{
+		static float random(GLuint n)
+		{
+			const float v = std::sin((float)n) * 43758.5453f;
+			return v - std::floor(v);
+		}
+
+		static void sample(const Sampler1D& sampler, const float* rng, float* out, size_t n)
+		{
+			const float tilt = sampler.params[0];
+			if (sampler.type == Sampler1D::Tilted && tilt > 0.0f)
+			{
+				for (size_t i = 0; i < n; ++i)
+					out[i] = (tilt + 1.0f) * rng[i] / (tilt + rng[i]);
+			}
+			else if (sampler.type == Sampler1D::Tilted && tilt < 0.0f)
+			{
+				for (size_t i = 0; i < n; ++i)
+					out[i] = -tilt * rng[i] / (-tilt + 1.0f - rng[i]);
+			}
+			else
+				std::copy_n(rng, n, out);
+		}
+
+		static void domain(const Domain1D& domain, float* values, size_t n)
+		{
+			const float p0 = domain.params[0], p1 = domain.params[1], p2 = domain.params[2];
+			switch (domain.type)
+			{
+			case Domain1D::Constant:
+				std::fill_n(values, n, p0);
+				break;
+			case Domain1D::Line:
+				for (size_t i = 0; i < n; ++i)
+					values[i] = p0 + (p1 - p0) * values[i];
+				break;
+			case Domain1D::BiLine:
+				for (size_t i = 0; i < n; ++i)
+				{
+					const float s = values[i];
+					values[i] = s < 0.5f ? p0 + (p1 - p0) * (2.0f * s) : p1 + (p2 - p1) * (2.0f * s - 1.0f);
+				}
+				break;
+			}
+		}
+
+		static void generate(const Generator1D& generator, const float* rng, float* out, size_t n)
+		{
+			sample(generator.sampler, rng, out, n);
+			domain(generator.domain, out, n);
+		}
+
+		// uniform sampling passes rng through, and constant domains ignore it
+		static void generate(const Generator2D& generator, const float* rng_x, const float* rng_y, float* out_x, float* out_y, size_t n)
+		{
+			switch (generator.domain.type)
+			{
+			case Domain2D::Constant:
+				std::fill_n(out_x, n, generator.domain.params[0]);
+				std::fill_n(out_y, n, generator.domain.params[1]);
+				break;
+			}
+		}
+
+		static void generate(const Generator4D& generator, float* out_x, float* out_y, float* out_z, float* out_w, size_t n)
+		{
+			switch (generator.domain.type)
+			{
+			case Domain4D::Constant:
+				std::fill_n(out_x, n, generator.domain.params[0]);
+				std::fill_n(out_y, n, generator.domain.params[1]);
+				std::fill_n(out_z, n, generator.domain.params[2]);
+				std::fill_n(out_w, n, generator.domain.params[3]);
+				break;
+			}
+		}
+
+		// keeps the elements whose alive flag is set, in order - the store is unconditional so that the loop has no branches
+		template<typename T>
+		static void compact(std::vector<T>& values, const unsigned char* alive, size_t n)
+		{
+			T* data = values.data();
+			size_t dst = 0;
+			for (size_t i = 0; i < n; ++i)
+			{
+				data[dst] = data[i];
+				dst += alive[i];
+			}
+		}
+	}
+
+	template<typename Func>
+	void ParticleSimulator::for_each_array(Func func)
+	{
+		for (std::vector<float>* values : { &time_elapsed, &lifetime, &m00, &m01, &m10, &m11, &tx, &ty, &r, &g, &b, &a, &vx, &vy })
+			func(*values);
+		func(attached);
+	}
+
+	void ParticleSimulator::set_capacity(size_t capacity)
+	{
+		this->capacity = capacity;
+		count = std::min(count, capacity);
+		if (time_elapsed.size() > capacity)
+			resize_storage(capacity);
+	}
+
+	void ParticleSimulator::reserve_storage()
+	{
+		if (time_elapsed.size() < capacity)
+			resize_storage(capacity);
+	}
+
+	void ParticleSimulator::resize_storage(size_t size)
+	{
+		for_each_array([size](auto& values) { values.resize(size); });
+		for (std::vector<float>* values : { &rng_x, &rng_y, &rng_z, &rng_w, &rotation, &size_x, &size_y })
+			values->resize(size);
+		alive.resize(size);
+	}
+
+	void ParticleSimulator::spawn(const internal::EmitterParams& params, GLuint spawn_count, float time, const glm::mat3& transform)
+	{
+		const size_t limit = std::min(capacity, (size_t)params.max_particles);
+		if (count >= limit || spawn_count == 0)
+			return;
+
+		reserve_storage();
+		const size_t n = std::min((size_t)spawn_count, limit - count);
+		const size_t o = count;
+
+		// same hash as random4() in spawn.comp
+		const GLuint seed = (GLuint)(time * 1000.0f);
+		for (size_t i = 0; i < n; ++i)
+		{
+			const GLuint id = (GLuint)i;
+			rng_x[i] = internal::random(id * 73856093u + seed * 19349663u);
+			rng_y[i] = internal::random(id * 19349663u + seed * 73856093u);
+			rng_z[i] = internal::random(id * 83492791u + seed * 15614557u);
+			rng_w[i] = internal::random(id * 15614557u + seed * 83492791u);
+		}
+
+		std::fill_n(time_elapsed.data() + o, n, 0.0f);
+		std::fill_n(attached.data() + o, n, params.attached);
+		internal::generate(params.lifetime, rng_x.data(), lifetime.data() + o, n);
+		internal::generate(params.position, rng_x.data(), rng_y.data(), tx.data() + o, ty.data() + o, n);
+		internal::generate(params.rotation, rng_x.data(), rotation.data(), n);
+		internal::generate(params.size, rng_x.data(), rng_y.data(), size_x.data(), size_y.data(), n);
+		internal::generate(params.color, r.data() + o, g.data() + o, b.data() + o, a.data() + o, n);
+		internal::generate(params.velocity, rng_x.data(), rng_y.data(), vx.data() + o, vy.data() + o, n);
+
+		for (size_t i = 0; i < n; ++i)
+		{
+			const float cos_r = std::cos(rotation[i]);
+			const float sin_r = std::sin(rotation[i]);
+			m00[o + i] = size_x[i] * cos_r;
+			m01[o + i] = size_x[i] * sin_r;
+			m10[o + i] = -size_y[i] * sin_r;
+			m11[o + i] = size_y[i] * cos_r;
+		}
+
+		// detached particles are spawned in world space - transform is assumed to be affine
+		if (!params.attached)
+		{
+			for (size_t i = o; i < o + n; ++i)
+			{
+				const float c00 = m00[i], c01 = m01[i], c10 = m10[i], c11 = m11[i], c20 = tx[i], c21 = ty[i];
+				m00[i] = transform[0][0] * c00 + transform[1][0] * c01;
+				m01[i] = transform[0][1] * c00 + transform[1][1] * c01;
+				m10[i] = transform[0][0] * c10 + transform[1][0] * c11;
+				m11[i] = transform[0][1] * c10 + transform[1][1] * c11;
+				tx[i] = transform[0][0] * c20 + transform[1][0] * c21 + transform[2][0];
+				ty[i] = transform[0][1] * c20 + transform[1][1] * c21 + transform[2][1];
+			}
+		}
+
+		count += n;
+	}
+
+	void ParticleSimulator::update(float delta_time)
+	{
+		const size_t n = count;
+		float* t = time_elapsed.data();
+		const float* lt = lifetime.data();
+		unsigned char* live = alive.data();
+
+		// integrating expired particles is harmless, and keeps the loop free of branches
+		float max_t = 0.0f;
+		for (size_t i = 0; i < n; ++i)
+		{
+			t[i] += delta_time;
+			live[i] = t[i] < lt[i];
+			tx[i] += vx[i] * delta_time;
+			ty[i] += vy[i] * delta_time;
+			max_t = std::max(max_t, live[i] ? t[i] : 0.0f);
+		}
+
+		for_each_array([live, n](auto& values) { internal::compact(values, live, n); });
+
+		size_t survivors = 0;
+		for (size_t i = 0; i < n; ++i)
+			survivors += live[i];
+
+		count = survivors;
+		max_time_elapsed = max_t;
+	}
+
+	internal::Particle ParticleSimulator::particle(size_t i) const
+	{
+		return internal::Particle{
+			.time_elapsed = time_elapsed[i],
+			.lifetime = lifetime[i],
+			.attached = attached[i],
+			.local_transform = {
+				glm::vec4(m00[i], m01[i], 0.0f, 0.0f),
+				glm::vec4(m10[i], m11[i], 0.0f, 0.0f),
+				glm::vec4(tx[i], ty[i], 1.0f, 0.0f)
+			},
+			.color = glm::vec4(r[i], g[i], b[i], a[i]),
+			.velocity = glm::vec2(vx[i], vy[i])
+		};
+	}
+
+	void ParticleSimulator::write(internal::Particle* particles) const
+	{
+		for (size_t i = 0; i < count; ++i)
+			particles[i] = particle(i);
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "external/GL.h"
+#include "external/GLM.h"
+
+#include <vector>
+
+namespace oly::particles
+{
+	namespace internal
+	{
+		struct Particle;
+		struct EmitterParams;
+	}
+
+	// CPU simulation of particles with the same spawn and update semantics as the particle compute shaders, so particle logic can run without a GPU.
+	// Particles are stored as structure-of-arrays, so that spawning, aging, integration and compaction are branchless loops over contiguous lanes
+	// that the compiler vectorizes. Surviving particles keep their spawn order, whereas the compute shaders compact them in arbitrary order.
+	class ParticleSimulator
+	{
+		std::vector<float> time_elapsed, lifetime;
+		std::vector<GLuint> attached;
+		// affine local transform, with columns (m00, m01), (m10, m11) and translation (tx, ty)
+		std::vector<float> m00, m01, m10, m11, tx, ty;
+		std::vector<float> r, g, b, a;
+		std::vector<float> vx, vy;
+
+		std::vector<float> rng_x, rng_y, rng_z, rng_w, rotation, size_x, size_y;
+		std::vector<unsigned char> alive;
+
+		size_t count = 0;
+		size_t capacity;
+		float max_time_elapsed = 0.0f;
+
+	public:
+		ParticleSimulator(size_t capacity = 2000) : capacity(capacity) {}
+
+		size_t size() const { return count; }
+		size_t get_capacity() const { return capacity; }
+		// particles beyond the new capacity are dropped
+		void set_capacity(size_t capacity);
+		void clear() { count = 0; max_time_elapsed = 0.0f; }
+
+		// spawns up to spawn_count particles, as spawn.comp does with uTime = time and uTransform = transform
+		void spawn(const internal::EmitterParams& params, GLuint spawn_count, float time, const glm::mat3& transform);
+		// ages particles, removes expired ones and integrates the rest, as update.comp does
+		void update(float delta_time);
+
+		// oldest time elapsed among particles alive after the last update
+		float get_max_time_elapsed() const { return max_time_elapsed; }
+
+		internal::Particle particle(size_t i) const;
+		// writes size() particles in the shader storage layout
+		void write(internal::Particle* particles) const;
+
+	private:
+		template<typename Func>
+		void for_each_array(Func func);
+		void reserve_storage();
+		void resize_storage(size_t size);
+	};
+}
@@ -5,10 +5,12 @@
 #include "graphics/backend/basic/Shader.h"
 #include "core/util/Time.h"
 
+#include <bit>
+
 namespace oly::rendering
 {
 	ParticleSystem::BufferList::ParticleDoubleBuffer::ParticleDoubleBuffer(GLuint max_particles)
-		: a(max_particles * sizeof(particles::internal::Particle), 0), b(max_particles * sizeof(particles::internal::Particle), 0)
+		: a(max_particles * sizeof(particles::internal::Particle)), b(max_particles * sizeof(particles::internal::Particle))
 	{
 	}
 
@@ -54,20 +56,23 @@ namespace oly::rendering
 	}
 
 	ParticleSystem::ParticleSystem(particles::ParticleEmitter&& emitter, GLuint particle_capacity, GLushort compute_threads)
-		: ITickService(TickPhase::Logic, TerminatePhase::Logic), buffers(particle_capacity), particle_capacity(particle_capacity), compute_threads(compute_threads)
+		: ITickService(TickPhase::Logic, TerminatePhase::Logic), buffers(particle_capacity), particle_capacity(particle_capacity), compute_threads(compute_threads),
+		cpu_simulator(particle_capacity)
 	{
 		emitters.push_back(std::move(emitter));
 		init();
 	}
 
 	ParticleSystem::ParticleSystem(std::vector<particles::ParticleEmitter>&& emitters, GLuint particle_capacity, GLushort compute_threads)
-		: ITickService(TickPhase::Logic, TerminatePhase::Logic), buffers(particle_capacity), particle_capacity(particle_capacity), compute_threads(compute_threads), emitters(std::move(emitters))
+		: ITickService(TickPhase::Logic, TerminatePhase::Logic), buffers(particle_capacity), particle_capacity(particle_capacity), compute_threads(compute_threads), emitters(std::move(emitters)),
+		cpu_simulator(particle_capacity)
 	{
 		init();
 	}
 
 	ParticleSystem::ParticleSystem(size_t emitter_count, GLuint particle_capacity, GLushort compute_threads)
-		: ITickService(TickPhase::Logic, TerminatePhase::Logic), buffers(particle_capacity), particle_capacity(particle_capacity), compute_threads(compute_threads)
+		: ITickService(TickPhase::Logic, TerminatePhase::Logic), buffers(particle_capacity), particle_capacity(particle_capacity), compute_threads(compute_threads),
+		cpu_simulator(particle_capacity)
 	{
 		init();
 		for (size_t _ = 0; _ < emitter_count; ++_)
@@ -114,6 +119,18 @@ namespace oly::rendering
 
 	void ParticleSystem::render() const
 	{
+		if (backend == Backend::CPU)
+		{
+			simulate_cpu_particles();
+			last_render_time = time_elapsed;
+			return;
+		}
+		else if (cpu_simulator.size() > 0)
+		{
+			cpu_simulator.clear();
+			buffers.draw_command.send(0, &DrawArraysIndirectCommand::primCount, GLuint(0));
+		}
+
 		for (const particles::ParticleEmitter& emitter : emitters)
 			spawn_particles(emitter);
 
@@ -166,6 +183,42 @@ namespace oly::rendering
 		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 	}
 
+	void ParticleSystem::simulate_cpu_particles() const
+	{
+		for (const particles::ParticleEmitter& emitter : emitters)
+		{
+			GLuint to_spawn = emitter.spawn_debt();
+			if (to_spawn == 0)
+				continue;
+
+			particles::internal::EmitterParams params;
+			emitter.apply(params);
+			cpu_simulator.spawn(params, to_spawn, time_elapsed, transformer.global());
+		}
+
+		if (cpu_simulator.size() == 0)
+			return;
+
+		cpu_simulator.update(time_elapsed - last_render_time);
+		const GLuint count = (GLuint)cpu_simulator.size();
+		if (count == 0)
+		{
+			buffers.draw_command.send(0, &DrawArraysIndirectCommand::primCount, GLuint(0));
+			return;
+		}
+
+		cpu_upload.resize(count);
+		cpu_simulator.write(cpu_upload.data());
+		glNamedBufferSubData(buffers.particles.out().buffer(), 0, count * sizeof(particles::internal::Particle), cpu_upload.data());
+		buffers.draw_command.send(0, &DrawArraysIndirectCommand::primCount, count);
+		buffers.ps_data.send(0, &particles::internal::ParticleSystemData::max_time_elapsed_bits, std::bit_cast<GLuint>(cpu_simulator.get_max_time_elapsed()));
+
+		glEnable(GL_DEPTH_TEST);
+		glClear(GL_DEPTH_BUFFER_BIT);
+		draw_particles();
+		glDisable(GL_DEPTH_TEST);
+	}
+
 	void ParticleSystem::draw_particles() const
 	{
 		glBindVertexArray(vao);
@@ -196,5 +249,6 @@ namespace oly::rendering
 		buffers.particles.in().force_resize(capacity * sizeof(particles::internal::Particle));
 		buffers.particles.out().force_resize(capacity * sizeof(particles::internal::Particle));
 		particle_capacity = capacity;
+		cpu_simulator.set_capacity(capacity);
 	}
 }
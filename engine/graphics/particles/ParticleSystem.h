@@ -1,6 +1,8 @@
 #pragma once
 
 #include "graphics/particles/ParticleEmitter.h"
+#include "graphics/particles/ParticleSimulator.h"
+#include "graphics/particles/ShaderStructs.h"
 #include "graphics/backend/specialized/LightweightBuffers.h"
 #include "graphics/backend/basic/VertexArrays.h"
 #include "graphics/backend/basic/Shader.h"
@@ -88,10 +90,21 @@ namespace oly::rendering
 		GLuint particle_capacity;
 		GLushort compute_threads;
 
+		mutable particles::ParticleSimulator cpu_simulator;
+		mutable std::vector<particles::internal::Particle> cpu_upload;
+
 	public:
 		bool camera_invariant = false;
 		bool auto_tick = true;
 
+		// Where particles are spawned and updated. The CPU backend runs the same simulation on the main thread and uploads the live particles
+		// for drawing each frame. Particles alive under one backend are not carried over when switching to the other.
+		enum class Backend
+		{
+			GPU,
+			CPU
+		} backend = Backend::GPU;
+
 	private:
 		float time_elapsed = 0.0f;
 		mutable float last_tick_time = 0.0f;
@@ -121,6 +134,7 @@ namespace oly::rendering
 	private:
 		void spawn_particles(const particles::ParticleEmitter& emitter) const;
 		void update_particles(GLuint in_primitive_count, float delta_time) const;
+		void simulate_cpu_particles() const;
 		void draw_particles() const;
 
 	public:
@@ -132,6 +146,8 @@ namespace oly::rendering
 		void remove_emitter(size_t i);
 
 		GLuint get_particle_capacity() const { return particle_capacity; }
+		// number of live particles, only tracked by the CPU backend
+		size_t get_cpu_particle_count() const { return cpu_simulator.size(); }
 		void set_particle_capacity(GLuint capacity);
 	};
 }
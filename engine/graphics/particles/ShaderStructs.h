@@ -5,14 +5,17 @@
 
 namespace oly::particles::internal
 {
+	// std430 layout of Particle in the particle shaders
 	struct Particle
 	{
 		float time_elapsed;
 		float lifetime;
 		GLuint attached;
-		glm::mat3 local_transform;
+		float _pad0 = 0.0f;
+		glm::vec4 local_transform[3];
 		glm::vec4 color;
 		glm::vec2 velocity;
+		float _pad1[2] = { 0.0f, 0.0f };
 	};
 
 	struct ParticleSystemData
@@ -46,6 +46,10 @@ namespace oly::rendering::internal
 
 	void internal::SpriteBatch::render() const
 	{
+		// draw calls for the next frame are culled against the camera as it is then
+		world_view.reset();
+		invariant_view.reset();
+
 		if (ebo.empty() || !camera)
 			return;
 
@@ -69,6 +73,58 @@ namespace oly::rendering::internal
 		quad_ssbo_block.post_draw_all();
 	}
 
+	static math::Rect2D unprojected_view(const glm::mat3& projection)
+	{
+		const glm::mat3 inverse = glm::inverse(projection);
+		math::Rect2D rect{ .x1 = nmax<float>(), .x2 = -nmax<float>(), .y1 = nmax<float>(), .y2 = -nmax<float>() };
+		for (glm::vec2 corner : { glm::vec2{ -1.0f, -1.0f }, glm::vec2{ 1.0f, -1.0f }, glm::vec2{ 1.0f, 1.0f }, glm::vec2{ -1.0f, 1.0f } })
+			rect.include(inverse * glm::vec3(corner, 1.0f));
+		return rect;
+	}
+
+	math::Rect2D internal::SpriteBatch::view_bounds(bool camera_invariant) const
+	{
+		std::optional<math::Rect2D>& view = camera_invariant ? invariant_view : world_view;
+		if (!view)
+			view = unprojected_view(camera_invariant ? camera->invariant_projection_matrix() : camera->projection_matrix());
+		return *view;
+	}
+
+	void internal::SpriteBatch::draw_quads(const std::array<GLuint, 6>* indices, GLuint count) const
+	{
+		if (count > 0)
+			std::copy_n(indices, count, ebo.draw_primitives(count));
+	}
+
+	const math::Rect2D& internal::SpriteBatch::get_quad_bounds(GLuint vb_pos) const
+	{
+		QuadBounds& bounds = quad_bounds[vb_pos];
+		if (bounds.dirty)
+		{
+			bounds.dirty = false;
+			glm::vec2 dimensions;
+			get_texture(vb_pos, dimensions);
+			const glm::mat3& transform = quad_ssbo_block.get<TRANSFORM>(vb_pos);
+			bounds.rect = { .x1 = nmax<float>(), .x2 = -nmax<float>(), .y1 = nmax<float>(), .y2 = -nmax<float>() };
+			for (glm::vec2 corner : { glm::vec2{ -0.5f, -0.5f }, glm::vec2{ 0.5f, -0.5f }, glm::vec2{ 0.5f, 0.5f }, glm::vec2{ -0.5f, 0.5f } })
+				bounds.rect.include(transform * glm::vec3(dimensions * corner, 1.0f));
+		}
+		return bounds.rect;
+	}
+
+	bool internal::SpriteBatch::is_visible(GLuint vb_pos) const
+	{
+		if (!culling || !camera)
+			return true;
+
+		// quads without a texture are degenerate in the vertex shader
+		const QuadInfo& quad_info = get_quad_info(vb_pos);
+		if (quad_info.tex_slot == 0)
+			return false;
+
+		return get_quad_bounds(vb_pos).overlaps(view_bounds(quad_info.flags & QuadInfo::CAM_INV_FLAG));
+	}
+
 	void internal::SpriteBatch::assert_valid_id(GLuint id)
 	{
 		if (id == NULL_ID) [[unlikely]]
@@ -83,6 +139,9 @@ namespace oly::rendering::internal
 
 		quad_ssbo_block.set<INFO>(id) = {};
 		quad_ssbo_block.set<TRANSFORM>(id) = 1.0f;
+		if (id >= quad_bounds.size())
+			quad_bounds.resize(id + 1);
+		quad_bounds[id].dirty = true;
 		return id;
 	}
 
@@ -118,6 +177,7 @@ namespace oly::rendering::internal
 	{
 		SpriteBatch::assert_valid_id(vb_pos);
 		update_texture_slot(vb_pos, quad_ssbo_block.buf.at<INFO>(vb_pos).tex_slot, texture, dimensions);
+		quad_bounds[vb_pos].dirty = true;
 	}
 
 	void internal::SpriteBatch::set_tex_coords(GLuint vb_pos, math::UVRect uvs)
@@ -150,6 +210,15 @@ namespace oly::rendering::internal
 			set_quad_info(vb_pos).flags &= ~QuadInfo::GLYPH_FLAG;
 	}
 
+	void internal::SpriteBatch::set_sdf_glyph(GLuint vb_pos, bool is_sdf_glyph)
+	{
+		SpriteBatch::assert_valid_id(vb_pos);
+		if (is_sdf_glyph)
+			set_quad_info(vb_pos).flags |= QuadInfo::SDF_FLAG;
+		else
+			set_quad_info(vb_pos).flags &= ~QuadInfo::SDF_FLAG;
+	}
+
 	void internal::SpriteBatch::set_camera_invariant(GLuint vb_pos, bool is_camera_invariant)
 	{
 		SpriteBatch::assert_valid_id(vb_pos);
@@ -172,6 +241,13 @@ namespace oly::rendering::internal
 			quad_ssbo_block.flag<INFO>(vb_pos);
 	}
 
+	void internal::SpriteBatch::set_transform(GLuint vb_pos, const glm::mat3& transform)
+	{
+		SpriteBatch::assert_valid_id(vb_pos);
+		quad_ssbo_block.set<TRANSFORM>(vb_pos) = transform;
+		quad_bounds[vb_pos].dirty = true;
+	}
+
 	graphics::BindlessTextureRef internal::SpriteBatch::get_texture(GLuint vb_pos, glm::vec2& dimensions) const
 	{
 		SpriteBatch::assert_valid_id(vb_pos);
@@ -210,6 +286,12 @@ namespace oly::rendering::internal
 		return get_quad_info(vb_pos).flags & QuadInfo::GLYPH_FLAG;
 	}
 
+	bool internal::SpriteBatch::is_sdf_glyph(GLuint vb_pos) const
+	{
+		SpriteBatch::assert_valid_id(vb_pos);
+		return get_quad_info(vb_pos).flags & QuadInfo::SDF_FLAG;
+	}
+
 	bool internal::SpriteBatch::is_camera_invariant(GLuint vb_pos) const
 	{
 		SpriteBatch::assert_valid_id(vb_pos);
@@ -274,6 +356,7 @@ namespace oly::rendering::internal
 		glm::vec4 modulation = glm::vec4(1.0f);
 		graphics::AnimFrameFormat frame_format = {};
 		bool is_text_glyph = false;
+		bool is_sdf_glyph = false;
 		bool camera_invariant = false;
 		graphics::BindlessTextureRef mod_texture = nullptr;
 		glm::vec2 mod_texture_dimensions = {};
@@ -289,6 +372,7 @@ namespace oly::rendering::internal
 		glm::vec4 modulation;
 		graphics::AnimFrameFormat frame_format;
 		bool is_text_glyph;
+		bool is_sdf_glyph;
 		bool camera_invariant;
 		graphics::BindlessTextureRef mod_texture;
 		glm::vec2 mod_texture_dimensions;
@@ -305,6 +389,7 @@ namespace oly::rendering::internal
 			.modulation = ref.get_modulation(),
 			.frame_format = ref.get_frame_format(),
 			.is_text_glyph = ref.is_text_glyph(),
+			.is_sdf_glyph = ref.is_sdf_glyph(),
 			.camera_invariant = ref.is_camera_invariant(),
 			.mod_texture = ref.get_mod_texture(mod_texture_dimensions),
 			.mod_tex_coords = ref.get_mod_tex_coords(),
@@ -324,6 +409,7 @@ namespace oly::rendering::internal
 			.modulation = ref.get_modulation(),
 			.frame_format = ref.get_frame_format(),
 			.is_text_glyph = ref.is_text_glyph(),
+			.is_sdf_glyph = ref.is_sdf_glyph(),
 			.camera_invariant = ref.is_camera_invariant(),
 			.mod_texture = ref.get_mod_texture(mod_texture_dimensions),
 			.mod_tex_coords = ref.get_mod_tex_coords(),
@@ -341,6 +427,7 @@ namespace oly::rendering::internal
 		ref.set_modulation(attr.modulation);
 		ref.set_frame_format(attr.frame_format);
 		ref.set_text_glyph(attr.is_text_glyph);
+		ref.set_sdf_glyph(attr.is_sdf_glyph);
 		ref.set_camera_invariant(attr.camera_invariant);
 		ref.set_mod_texture(attr.mod_texture, attr.mod_texture_dimensions);
 		ref.set_mod_tex_coords(attr.mod_tex_coords);
@@ -354,6 +441,7 @@ namespace oly::rendering::internal
 		ref.set_modulation(attr.modulation);
 		ref.set_frame_format(attr.frame_format);
 		ref.set_text_glyph(attr.is_text_glyph);
+		ref.set_sdf_glyph(attr.is_sdf_glyph);
 		ref.set_camera_invariant(attr.camera_invariant);
 		ref.set_mod_texture(attr.mod_texture, attr.mod_texture_dimensions);
 		ref.set_mod_tex_coords(attr.mod_tex_coords);
@@ -537,6 +625,14 @@ namespace oly::rendering::internal
 			throw Error(ErrorCode::NullPointer);
 	}
 
+	void internal::SpriteReference::set_sdf_glyph(bool is_sdf_glyph) const
+	{
+		if (auto batch = lock()) [[likely]]
+			batch->set_sdf_glyph(id, is_sdf_glyph);
+		else
+			throw Error(ErrorCode::NullPointer);
+	}
+
 	void internal::SpriteReference::set_camera_invariant(bool is_camera_invariant) const
 	{
 		if (auto batch = lock()) [[likely]]
@@ -586,7 +682,7 @@ namespace oly::rendering::internal
 	{
 		SpriteBatch::assert_valid_id(id);
 		if (auto batch = lock()) [[likely]]
-			batch->quad_ssbo_block.set<SpriteBatch::TRANSFORM>(id) = transform;
+			batch->set_transform(id, transform);
 		else
 			throw Error(ErrorCode::NullPointer);
 	}
@@ -642,6 +738,14 @@ namespace oly::rendering::internal
 			throw Error(ErrorCode::NullPointer);
 	}
 
+	bool internal::SpriteReference::is_sdf_glyph() const
+	{
+		if (auto batch = lock()) [[likely]]
+			return batch->is_sdf_glyph(id);
+		else
+			throw Error(ErrorCode::NullPointer);
+	}
+
 	bool internal::SpriteReference::is_camera_invariant() const
 	{
 		if (auto batch = lock()) [[likely]]
@@ -693,9 +797,16 @@ namespace oly::rendering::internal
 		if (auto batch = lock()) [[likely]]
 		{
 			SpriteBatch::assert_valid_id(id);
-			graphics::quad_indices(batch->ebo.draw_primitive().data(), id);
+			if (batch->is_visible(id))
+				graphics::quad_indices(batch->ebo.draw_primitive().data(), id);
 		}
 		else
 			throw Error(ErrorCode::NullPointer);
 	}
+
+	std::array<GLuint, 6> internal::SpriteReference::quad_indices() const
+	{
+		SpriteBatch::assert_valid_id(id);
+		return graphics::quad_indices(id);
+	}
 }
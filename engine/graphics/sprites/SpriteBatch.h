@@ -45,6 +45,7 @@ namespace oly::rendering
 			{
 				static const GLushort GLYPH_FLAG = 1 << 0;
 				static const GLushort CAM_INV_FLAG = 1 << 1;
+				static const GLushort SDF_FLAG = 1 << 2;
 
 				GLushort tex_slot = 0;
 				GLushort tex_coord_slot = 0;
@@ -109,6 +110,8 @@ namespace oly::rendering
 		public:
 			Camera2DRef camera = REF_DEFAULT;
 			glm::vec4 global_modulation = glm::vec4(1.0f);
+			// When enabled, draw calls skip quads whose bounds lie outside the camera's view, so that only visible quads are submitted.
+			bool culling = true;
 
 			SpriteBatch(UBOCapacity = {});
 			SpriteBatch(const SpriteBatch&) = delete;
@@ -117,7 +120,23 @@ namespace oly::rendering
 
 			void render() const;
 
+			// bounds of the area seen by the camera in the current frame - world space, or view space for camera-invariant quads
+			math::Rect2D view_bounds(bool camera_invariant = false) const;
+			// submits pre-built quad indices in one copy, without culling individual quads
+			void draw_quads(const std::array<GLuint, 6>* indices, GLuint count) const;
+
 		private:
+			struct QuadBounds
+			{
+				math::Rect2D rect;
+				bool dirty = true;
+			};
+			mutable std::vector<QuadBounds> quad_bounds;
+			mutable std::optional<math::Rect2D> world_view, invariant_view;
+
+			const math::Rect2D& get_quad_bounds(GLuint vb_pos) const;
+			bool is_visible(GLuint vb_pos) const;
+
 			SoftIDGenerator<GLuint> id_generator;
 			static const GLuint NULL_ID = GLuint(-1);
 			static void assert_valid_id(GLuint id);
@@ -152,15 +171,18 @@ namespace oly::rendering
 			void set_modulation(GLuint vb_pos, glm::vec4 modulation);
 			void set_frame_format(GLuint vb_pos, const graphics::AnimFrameFormat& anim);
 			void set_text_glyph(GLuint vb_pos, bool is_text_glyph);
+			void set_sdf_glyph(GLuint vb_pos, bool is_sdf_glyph);
 			void set_camera_invariant(GLuint vb_pos, bool is_camera_invariant);
 			void set_mod_texture(GLuint vb_pos, const graphics::BindlessTextureRef& texture, glm::vec2 dimensions);
 			void set_mod_tex_coords(GLuint vb_pos, math::UVRect uvs);
+			void set_transform(GLuint vb_pos, const glm::mat3& transform);
 
 			graphics::BindlessTextureRef get_texture(GLuint vb_pos, glm::vec2& dimensions) const;
 			math::UVRect get_tex_coords(GLuint vb_pos) const;
 			glm::vec4 get_modulation(GLuint vb_pos) const;
 			graphics::AnimFrameFormat get_frame_format(GLuint vb_pos) const;
 			bool is_text_glyph(GLuint vb_pos) const;
+			bool is_sdf_glyph(GLuint vb_pos) const;
 			bool is_camera_invariant(GLuint vb_pos) const;
 			graphics::BindlessTextureRef get_mod_texture(GLuint vb_pos, glm::vec2& dimensions) const;
 			math::UVRect get_mod_tex_coords(GLuint vb_pos) const;
@@ -204,6 +226,7 @@ namespace oly::rendering
 			void set_modulation(glm::vec4 modulation) const;
 			void set_frame_format(const graphics::AnimFrameFormat& anim) const;
 			void set_text_glyph(bool is_text_glyph) const;
+			void set_sdf_glyph(bool is_sdf_glyph) const;
 			void set_camera_invariant(bool is_camera_invariant) const;
 			void set_mod_texture(const detail::ResourcePath& texture_file, unsigned int texture_index = 0) const;
 			void set_mod_texture(const graphics::BindlessTextureRef& texture) const;
@@ -217,6 +240,7 @@ namespace oly::rendering
 			glm::vec4 get_modulation() const;
 			graphics::AnimFrameFormat get_frame_format() const;
 			bool is_text_glyph() const;
+			bool is_sdf_glyph() const;
 			bool is_camera_invariant() const;
 			graphics::BindlessTextureRef get_mod_texture() const;
 			graphics::BindlessTextureRef get_mod_texture(glm::vec2& dimensions) const;
@@ -224,6 +248,7 @@ namespace oly::rendering
 			glm::mat3 get_transform() const;
 
 			void draw_quad() const;
+			std::array<GLuint, 6> quad_indices() const;
 		};
 	}
 }
@@ -24,40 +24,142 @@ namespace oly::rendering
 	{
 	}
 
+	unsigned short& TileMapLayer::Chunk::slot(glm::ivec2 tile)
+	{
+		const glm::ivec2 cell = tile - CHUNK_SIZE * chunk_of(tile);
+		return slots[cell.y * CHUNK_SIZE + cell.x];
+	}
+
+	unsigned short TileMapLayer::Chunk::slot(glm::ivec2 tile) const
+	{
+		const glm::ivec2 cell = tile - CHUNK_SIZE * chunk_of(tile);
+		return slots[cell.y * CHUNK_SIZE + cell.x];
+	}
+
+	glm::ivec2 TileMapLayer::chunk_of(glm::ivec2 tile)
+	{
+		return { tile.x >= 0 ? tile.x / CHUNK_SIZE : (tile.x + 1) / CHUNK_SIZE - 1, tile.y >= 0 ? tile.y / CHUNK_SIZE : (tile.y + 1) / CHUNK_SIZE - 1 };
+	}
+
+	bool TileMapLayer::is_painted(glm::ivec2 tile) const
+	{
+		auto it = chunks.find(chunk_of(tile));
+		return it != chunks.end() && it->second.slot(tile) != 0;
+	}
+
 	void TileMapLayer::draw() const
 	{
-		for (const auto& [_, sprite] : sprite_map)
-			sprite.draw();
+		auto batch = lock();
+		if (!batch)
+			return;
+
+		if (transformer.flush())
+			dirty_chunks();
+
+		if (!batch->culling || !batch->camera)
+		{
+			for (const auto& [_, chunk] : chunks)
+				draw_chunk(chunk, *batch);
+			return;
+		}
+
+		// each tile is a unit quad centered on its coordinates in layer space
+		const glm::mat3 inverse = glm::inverse(transformer.global());
+		const math::Rect2D world_view = batch->view_bounds(camera_invariant);
+		math::Rect2D view{ .x1 = nmax<float>(), .x2 = -nmax<float>(), .y1 = nmax<float>(), .y2 = -nmax<float>() };
+		for (glm::vec2 corner : world_view.uvs())
+			view.include(inverse * glm::vec3(corner, 1.0f));
+
+		if (!view.valid())
+			return;
+
+		const glm::vec2 tile_limit((float)(nmax<int>() / 2));
+		const glm::vec2 lower = glm::clamp(glm::floor(glm::vec2{ view.x1, view.y1 } - 0.5f), -tile_limit, tile_limit);
+		const glm::vec2 upper = glm::clamp(glm::floor(glm::vec2{ view.x2, view.y2 } + 0.5f), -tile_limit, tile_limit);
+		const glm::ivec2 first_chunk = chunk_of(glm::ivec2(lower));
+		const glm::ivec2 last_chunk = chunk_of(glm::ivec2(upper));
+
+		// iterate over whichever is smaller - the chunks in view or the occupied chunks
+		const long long chunks_in_view = (long long)(last_chunk.x - first_chunk.x + 1) * (long long)(last_chunk.y - first_chunk.y + 1);
+		if (chunks_in_view <= (long long)chunks.size())
+		{
+			for (int y = first_chunk.y; y <= last_chunk.y; ++y)
+			{
+				for (int x = first_chunk.x; x <= last_chunk.x; ++x)
+				{
+					auto it = chunks.find({ x, y });
+					if (it != chunks.end())
+						draw_chunk(it->second, *batch);
+				}
+			}
+		}
+		else
+		{
+			for (const auto& [coords, chunk] : chunks)
+				if (coords.x >= first_chunk.x && coords.x <= last_chunk.x && coords.y >= first_chunk.y && coords.y <= last_chunk.y)
+					draw_chunk(chunk, *batch);
+		}
 	}
 
-	void TileMapLayer::set_camera_invariant(bool is_camera_invariant) const
+	void TileMapLayer::draw_chunk(const Chunk& chunk, const internal::SpriteBatch& batch) const
 	{
-		for (const auto& [_, sprite] : sprite_map)
-			sprite.set_camera_invariant(is_camera_invariant);
+		if (chunk.baked.dirty)
+		{
+			chunk.baked.dirty = false;
+			chunk.baked.indices.resize(chunk.sprites.size());
+			const glm::mat3 global = transformer.global();
+			for (size_t i = 0; i < chunk.sprites.size(); ++i)
+			{
+				chunk.sprites[i].set_transform(global * chunk.locals[i]);
+				chunk.baked.indices[i] = chunk.sprites[i].quad_indices();
+			}
+		}
+		batch.draw_quads(chunk.baked.indices.data(), (GLuint)chunk.baked.indices.size());
+	}
+
+	void TileMapLayer::dirty_chunks() const
+	{
+		for (const auto& [_, chunk] : chunks)
+			chunk.baked.dirty = true;
+	}
+
+	void TileMapLayer::set_camera_invariant(bool is_camera_invariant)
+	{
+		camera_invariant = is_camera_invariant;
+		for (const auto& [_, chunk] : chunks)
+			for (const internal::SpriteReference& sprite : chunk.sprites)
+				sprite.set_camera_invariant(is_camera_invariant);
 	}
 
 	void TileMapLayer::set_batch(Unbatched)
 	{
 		reset();
-		for (auto& [_, sprite] : sprite_map)
-			sprite.set_batch(UNBATCHED);
+		for (auto& [_, chunk] : chunks)
+			for (internal::SpriteReference& sprite : chunk.sprites)
+				sprite.set_batch(UNBATCHED);
+		dirty_chunks();
 	}
 
 	void TileMapLayer::set_batch(SpriteBatch& batch)
 	{
 		reset(*batch);
-		for (auto& [_, sprite] : sprite_map)
-			sprite.set_batch(batch);
+		for (auto& [_, chunk] : chunks)
+			for (internal::SpriteReference& sprite : chunk.sprites)
+				sprite.set_batch(batch);
+		dirty_chunks();
 	}
 
 	void TileMapLayer::paint_tile(glm::ivec2 tile)
 	{
-		if (!sprite_map.count(tile))
+		if (!is_painted(tile))
 		{
 			if (auto batch = lock())
 			{
-				auto& sprite = sprite_map.emplace(tile, *batch).first->second;
-				sprite.transformer.attach_parent(&transformer);
+				Chunk& chunk = chunks[chunk_of(tile)];
+				chunk.tiles.push_back(tile);
+				chunk.sprites.emplace_back(*batch).set_camera_invariant(camera_invariant);
+				chunk.locals.push_back(1.0f);
+				chunk.slot(tile) = (unsigned short)chunk.tiles.size();
 				update_configuration(tile);
 				update_neighbour_configurations(tile);
 			}
@@ -66,12 +168,30 @@ namespace oly::rendering
 
 	void TileMapLayer::unpaint_tile(glm::ivec2 tile)
 	{
-		auto it = sprite_map.find(tile);
-		if (it != sprite_map.end())
-		{
-			sprite_map.erase(it);
-			update_neighbour_configurations(tile);
-		}
+		auto it = chunks.find(chunk_of(tile));
+		if (it == chunks.end())
+			return;
+
+		Chunk& chunk = it->second;
+		const unsigned short slot = chunk.slot(tile);
+		if (slot == 0)
+			return;
+
+		const size_t i = slot - 1;
+		chunk.slot(chunk.tiles.back()) = slot;
+		chunk.slot(tile) = 0;
+		chunk.tiles[i] = chunk.tiles.back();
+		chunk.sprites[i] = std::move(chunk.sprites.back());
+		chunk.locals[i] = chunk.locals.back();
+		chunk.tiles.pop_back();
+		chunk.sprites.pop_back();
+		chunk.locals.pop_back();
+		chunk.baked.dirty = true;
+
+		if (chunk.tiles.empty())
+			chunks.erase(it);
+
+		update_neighbour_configurations(tile);
 	}
 
 	void TileMapLayer::update_neighbour_configurations(glm::ivec2 center)
@@ -88,50 +208,53 @@ namespace oly::rendering
 
 	void TileMapLayer::update_configuration(glm::ivec2 tile)
 	{
-		auto it = sprite_map.find(tile);
-		if (it == sprite_map.end())
+		auto it = chunks.find(chunk_of(tile));
+		if (it == chunks.end())
 			return;
 
-		Sprite& sprite = it->second;
+		Chunk& chunk = it->second;
+		const unsigned short slot = chunk.slot(tile);
+		if (slot == 0)
+			return;
 
 		detail::TileConfigGrid painted_tile{};
 		for (int y = detail::GridCoordinate::Top; y <= detail::GridCoordinate::Bottom; ++y)
 			for (int x = detail::GridCoordinate::Left; x <= detail::GridCoordinate::Right; ++x)
-				painted_tile[y][x] = sprite_map.count(tile + glm::ivec2{ 1 - y, x - 1 });
+				painted_tile[y][x] = is_painted(tile + glm::ivec2{ 1 - y, x - 1 });
 
-		auto tile_assignment = tileset->get_tile_assignment(painted_tile);
+		auto tile_assignment = tileset->get_tile_assignment(detail::tile_config_from_grid(painted_tile));
 
+		const internal::SpriteReference& sprite = chunk.sprites[slot - 1];
 		sprite.set_texture(tile_assignment.desc.file, tile_assignment.desc.file_index);
 		sprite.set_tex_coords(tile_assignment.desc.uvs);
-		sprite.set_local().position = glm::vec2(tile);
-		
-		if (static_cast<bool>(tile_assignment.transformation.reflection & detail::TileReflection::X))
-			sprite.set_local().scale.x = -glm::abs(sprite.get_local().scale.x);
-		else
-			sprite.set_local().scale.x = glm::abs(sprite.get_local().scale.x);
 
+		Transform2D local;
+		local.position = glm::vec2(tile);
+		local.scale = 1.0f / context::get_texture_dimensions(tile_assignment.desc.file);
+
+		if (static_cast<bool>(tile_assignment.transformation.reflection & detail::TileReflection::X))
+			local.scale.x = -local.scale.x;
 		if (static_cast<bool>(tile_assignment.transformation.reflection & detail::TileReflection::Y))
-			sprite.set_local().scale.y = -glm::abs(sprite.get_local().scale.y);
-		else
-			sprite.set_local().scale.y = glm::abs(sprite.get_local().scale.y);
+			local.scale.y = -local.scale.y;
 		
 		switch (tile_assignment.transformation.rotation)
 		{
 		case detail::TileRotation::By90:
-			sprite.set_local().rotation = glm::radians(90.0f);
+			local.rotation = glm::radians(90.0f);
 			break;
 		case detail::TileRotation::By180:
-			sprite.set_local().rotation = glm::radians(180.0f);
+			local.rotation = glm::radians(180.0f);
 			break;
 		case detail::TileRotation::By270:
-			sprite.set_local().rotation = glm::radians(270.0f);
+			local.rotation = glm::radians(270.0f);
 			break;
 		default:
-			sprite.set_local().rotation = 0.0f;
+			local.rotation = 0.0f;
 			break;
 		}
-		
-		sprite.set_local().scale = 1.0f / context::get_texture_dimensions(tile_assignment.desc.file);
+
+		chunk.locals[slot - 1] = local.matrix();
+		chunk.baked.dirty = true;
 	}
 
 	void TileMap::draw() const
@@ -143,7 +266,7 @@ namespace oly::rendering
 	void TileMap::set_camera_invariant(bool is_camera_invariant)
 	{
 		camera_invariant = is_camera_invariant;
-		for (const TileMapLayer& layer : layers)
+		for (TileMapLayer& layer : layers)
 			layer.set_camera_invariant(is_camera_invariant);
 	}
 
@@ -15,7 +15,41 @@ namespace oly::rendering
 		TileSetRef tileset;
 		
 	private:
-		std::unordered_map<glm::ivec2, Sprite> sprite_map;
+		// Tiles are grouped into chunks, each storing its tiles contiguously along with the quad indices they are drawn with. A chunk's indices
+		// and tile transforms are only rebuilt after one of its tiles changes or the layer moves, so drawing an unchanged chunk is a single copy.
+		static const int CHUNK_SIZE = 32;
+
+		struct Chunk
+		{
+			std::vector<glm::ivec2> tiles;
+			std::vector<internal::SpriteReference> sprites;
+			std::vector<glm::mat3> locals;
+			// 1 + index of the tile in tiles, or 0 if the cell is unpainted
+			std::array<unsigned short, CHUNK_SIZE * CHUNK_SIZE> slots = {};
+
+			struct Baked
+			{
+				std::vector<std::array<GLuint, 6>> indices;
+				bool dirty = true;
+
+				Baked() = default;
+				// copied sprites are issued new IDs
+				Baked(const Baked&) {}
+				Baked(Baked&&) noexcept = default;
+				Baked& operator=(const Baked&) { indices.clear(); dirty = true; return *this; }
+				Baked& operator=(Baked&&) noexcept = default;
+			};
+			mutable Baked baked;
+
+			unsigned short& slot(glm::ivec2 tile);
+			unsigned short slot(glm::ivec2 tile) const;
+		};
+
+		std::unordered_map<glm::ivec2, Chunk> chunks;
+		bool camera_invariant = false;
+
+		static glm::ivec2 chunk_of(glm::ivec2 tile);
+		bool is_painted(glm::ivec2 tile) const;
 		
 	public:
 		Transformer2D transformer;
@@ -31,7 +65,7 @@ namespace oly::rendering
 		const Transform2D& get_local() const { return transformer.get_local(); }
 		Transform2D& set_local() { return transformer.set_local(); }
 
-		void set_camera_invariant(bool is_camera_invariant) const;
+		void set_camera_invariant(bool is_camera_invariant);
 
 		void draw() const;
 
@@ -43,6 +77,8 @@ namespace oly::rendering
 		void unpaint_tile(glm::ivec2 tile);
 
 	private:
+		void draw_chunk(const Chunk& chunk, const internal::SpriteBatch& batch) const;
+		void dirty_chunks() const;
 		void update_neighbour_configurations(glm::ivec2 center);
 		void update_configuration(glm::ivec2 tile);
 	};
@@ -24,19 +24,21 @@ namespace oly::rendering
 			tile.transformation.apply(a.transformation);
 			this->assignments[a.config] = tile;
 		}
+		build_table();
 	}
 
 	TileSet::Assignment TileSet::get_tile_assignment(const detail::TileConfigGrid tile) const
 	{
-		std::unordered_set<detail::TileConfig> fallbacks_seen{};
-		detail::TileTransformation transformation;
-		if (auto t = get_assignment(detail::tile_config_from_grid(tile), transformation, fallbacks_seen))
-		{
-			transformation.apply(t->transformation);
-			return Assignment{ .desc = tiles[t->tex_index], .config = detail::tile_config_from_grid(tile), .transformation = transformation};
-		}
+		return get_tile_assignment(detail::tile_config_from_grid(tile));
+	}
+
+	TileSet::Assignment TileSet::get_tile_assignment(detail::TileConfig config) const
+	{
+		if (const std::optional<Tile>& t = table[config])
+			return Assignment{ .desc = tiles[t->tex_index], .config = config, .transformation = t->transformation };
 		else
 		{
+			const detail::TileConfigGrid tile = detail::grid_from_tile_config(config);
 			std::stringstream ss;
 			ss << "[" << tile[0][0] << ", " << tile[0][1] << ", " << tile[0][2] << "]";
 			ss << "[" << tile[1][0] << ", ---, " << tile[1][2] << "]";
@@ -48,6 +50,22 @@ namespace oly::rendering
 		}
 	}
 
+	void TileSet::build_table()
+	{
+		for (size_t config = 0; config < table.size(); ++config)
+		{
+			std::unordered_set<detail::TileConfig> fallbacks_seen{};
+			detail::TileTransformation transformation;
+			if (auto t = get_assignment((detail::TileConfig)config, transformation, fallbacks_seen))
+			{
+				transformation.apply(t->transformation);
+				table[config] = Tile{ .tex_index = t->tex_index, .transformation = transformation };
+			}
+			else
+				table[config].reset();
+		}
+	}
+
 	std::optional<TileSet::Tile> TileSet::get_assignment(detail::TileConfig config, detail::TileTransformation& transformation, std::unordered_set<detail::TileConfig>& fallbacks_seen) const
 	{
 		auto it = assignments.find(config);
@@ -87,6 +105,7 @@ namespace oly::rendering
 	{
 		tiles.clear();
 		this->assignments.clear();
+		table.fill(std::nullopt);
 
 		assets::Parser parser(node);
 		auto source_file = parser.optional<std::string>(detail::Key::InjectedSourceFile)();
@@ -7,6 +7,8 @@
 #include "definitions/enums/TilesetConfiguration.h"
 
 #include <unordered_set>
+#include <array>
+#include <optional>
 
 namespace oly::rendering
 {
@@ -38,15 +40,19 @@ namespace oly::rendering
 	private:
 		std::vector<TileDesc> tiles;
 		std::unordered_map<detail::TileConfig, Tile> assignments;
+		// resolved assignment of every configuration, with fallbacks already applied
+		std::array<std::optional<Tile>, 256> table;
 
 	public:
 		TileSet(const std::vector<Assignment>& assignments = {});
 
 	private:
 		void load_assignments(const std::vector<Assignment>& assignments);
+		void build_table();
 
 	public:
 		Assignment get_tile_assignment(const detail::TileConfigGrid tile) const;
+		Assignment get_tile_assignment(detail::TileConfig config) const;
 
 	private:
 		std::optional<Tile> get_assignment(detail::TileConfig config, detail::TileTransformation& transformation, std::unordered_set<detail::TileConfig>& fallbacks_seen) const;
@@ -1,5 +1,8 @@
 #include "Font.h"
 
+#include "graphics/text/GlyphAtlas.h"
+#include "graphics/text/GlyphRasterizer.h"
+
 #include "core/base/Errors.h"
 #include "core/util/IO.h"
 #include "core/util/Logger.h"
@@ -55,6 +58,19 @@ namespace oly
 			flip_pixel_buffer(buf, w, h, 1);
 		}
 
+		void FontFace::make_sdf_bitmap(unsigned char* buf, int w, int h, float scale, int glyph_index, int spread) const
+		{
+			memset(buf, 0, size_t(w) * h);
+			int sdf_w = 0, sdf_h = 0, xoff, yoff;
+			unsigned char* sdf = stbtt_GetGlyphSDF(&info, scale, glyph_index, spread, 128, 127.0f / spread, &sdf_w, &sdf_h, &xoff, &yoff);
+			if (!sdf)
+				return;
+			for (int row = 0; row < std::min(h, sdf_h); ++row)
+				memcpy(buf + row * w, sdf + row * sdf_w, std::min(w, sdf_w));
+			stbtt_FreeSDF(sdf, nullptr);
+			flip_pixel_buffer(buf, w, h, 1);
+		}
+
 		int FontFace::get_kerning(utf::Codepoint c1, utf::Codepoint c2) const
 		{
 			auto k = kerning.map.find({ c1, c2 });
@@ -96,11 +112,14 @@ namespace oly
 
 		void FontGlyph::render_on_bitmap_unique(const FontAtlas& font, unsigned char* buffer, int w, int h) const
 		{
-			font.font->make_bitmap(buffer, _box.width(), _box.height(), font.scale, index);
+			if (font.options.sdf)
+				font.font->make_sdf_bitmap(buffer, w, h, font.scale, index, font.options.sdf_spread);
+			else
+				font.font->make_bitmap(buffer, _box.width(), _box.height(), font.scale, index);
 		}
 
 		FontAtlas::FontAtlas(const FontFaceRef& font, FontOptions options, const utf::String& common_buffer)
-			: font(font), options(options)
+			: font(font), options(options), atlas_font(GlyphAtlas::instance().register_font(options.min_filter, options.mag_filter))
 		{
 			common_dim.cpp = 1;
 
@@ -118,6 +137,12 @@ namespace oly
 					continue;
 				if (glyphs.find(codepoint) != glyphs.end())
 					continue;
+				if (options.sdf)
+				{
+					// distance fields carry their own padding, so they are packed into the shared glyph atlas instead of a common texture
+					cache(codepoint);
+					continue;
+				}
 				int g = font->find_glyph_index(codepoint);
 				if (!g)
 					continue;
@@ -150,28 +175,207 @@ namespace oly
 			space_advance_width = _space_advance_width * scale;
 		}
 
+		FontAtlas::FontAtlas(const FontAtlas& other)
+			: font(other.font), glyphs(other.glyphs), options(other.options), scale(other.scale), _line_height(other._line_height), ascent(other.ascent),
+			space_advance_width(other.space_advance_width), common_dim(other.common_dim), common_texture(other.common_texture),
+			atlas_font(GlyphAtlas::instance().register_font(options.min_filter, options.mag_filter))
+		{
+			drop_shared_glyphs();
+		}
+
+		FontAtlas::FontAtlas(FontAtlas&& other) noexcept
+			: font(std::move(other.font)), glyphs(std::move(other.glyphs)), options(other.options), scale(other.scale), _line_height(other._line_height),
+			ascent(other.ascent), space_advance_width(other.space_advance_width), common_dim(other.common_dim), common_texture(std::move(other.common_texture)),
+			atlas_font(other.atlas_font), async_requests(other.async_requests)
+		{
+			other.atlas_font = 0;
+			other.async_requests = false;
+		}
+
+		FontAtlas::~FontAtlas()
+		{
+			cancel_async_requests();
+			GlyphAtlas::instance().unregister_font(atlas_font);
+		}
+
+		FontAtlas& FontAtlas::operator=(const FontAtlas& other)
+		{
+			if (this != &other)
+			{
+				cancel_async_requests();
+				GlyphAtlas::instance().unregister_font(atlas_font);
+				font = other.font;
+				glyphs = other.glyphs;
+				options = other.options;
+				scale = other.scale;
+				_line_height = other._line_height;
+				ascent = other.ascent;
+				space_advance_width = other.space_advance_width;
+				common_dim = other.common_dim;
+				common_texture = other.common_texture;
+				atlas_font = GlyphAtlas::instance().register_font(options.min_filter, options.mag_filter);
+				drop_shared_glyphs();
+			}
+			return *this;
+		}
+
+		FontAtlas& FontAtlas::operator=(FontAtlas&& other) noexcept
+		{
+			if (this != &other)
+			{
+				cancel_async_requests();
+				GlyphAtlas::instance().unregister_font(atlas_font);
+				font = std::move(other.font);
+				glyphs = std::move(other.glyphs);
+				options = other.options;
+				scale = other.scale;
+				_line_height = other._line_height;
+				ascent = other.ascent;
+				space_advance_width = other.space_advance_width;
+				common_dim = other.common_dim;
+				common_texture = std::move(other.common_texture);
+				atlas_font = other.atlas_font;
+				other.atlas_font = 0;
+				async_requests = other.async_requests;
+				other.async_requests = false;
+			}
+			return *this;
+		}
+
+		void FontAtlas::drop_shared_glyphs() const
+		{
+			std::erase_if(glyphs, [](const auto& pair) { return pair.second.key.font != 0; });
+		}
+
+		void FontAtlas::cancel_async_requests() const
+		{
+			if (async_requests)
+			{
+				GlyphRasterizer::instance().cancel(atlas_font);
+				async_requests = false;
+			}
+		}
+
 		bool FontAtlas::cache(utf::Codepoint codepoint) const
 		{
-			if (glyphs.find(codepoint) != glyphs.end())
+			if (is_cached(codepoint))
 				return true;
 			int index = font->find_glyph_index(codepoint);
 			if (!index) return false;
 
 			FontGlyph glyph(*this, index, scale, -1);
-			graphics::ImageDimensions dim = { glyph._box.width(), glyph._box.height(), 1};
+			graphics::ImageDimensions dim = bitmap_dimensions(glyph);
 			unsigned char* bmp = dim.pxnew();
-			glyph.render_on_bitmap_unique(*this, bmp, dim.w, dim.h);
-
-			graphics::Image image(bmp, dim);
-			graphics::BindlessTexture texture = load_bindless_texture_2d(image, options.auto_generate_mipmaps);
-			texture.texture().set_parameter(GL_TEXTURE_MIN_FILTER, options.min_filter);
-			texture.texture().set_parameter(GL_TEXTURE_MAG_FILTER, options.mag_filter);
-			texture.set_and_use_handle();
-			glyph._texture = graphics::BindlessTextureRef(std::move(texture));
-			glyphs.emplace(codepoint, std::move(glyph));
+			std::optional<GlyphRasterizer::Bitmap> prewarmed;
+			if (async_requests)
+				prewarmed = GlyphRasterizer::instance().claim({ .font = atlas_font, .codepoint = codepoint });
+			if (prewarmed && prewarmed->w == dim.w && prewarmed->h == dim.h && prewarmed->pixels.size() == size_t(dim.w) * dim.h)
+				std::copy(prewarmed->pixels.begin(), prewarmed->pixels.end(), bmp);
+			else
+				glyph.render_on_bitmap_unique(*this, bmp, dim.w, dim.h);
+
+			store_glyph(codepoint, std::move(glyph), bmp);
 			return true;
 		}
 
+		graphics::ImageDimensions FontAtlas::bitmap_dimensions(const FontGlyph& glyph) const
+		{
+			const int padding = bitmap_padding();
+			return { glyph._box.width() + 2 * padding, glyph._box.height() + 2 * padding, 1 };
+		}
+
+		void FontAtlas::store_glyph(utf::Codepoint codepoint, FontGlyph&& glyph, unsigned char* bmp) const
+		{
+			graphics::ImageDimensions dim = bitmap_dimensions(glyph);
+			const int padding = bitmap_padding();
+			const GlyphKey key{ .font = atlas_font, .codepoint = codepoint };
+			std::optional<GlyphAtlas::Glyph> shared;
+			if (!options.auto_generate_mipmaps)
+				shared = GlyphAtlas::instance().insert(key, bmp, dim.w, dim.h, padding);
+
+			if (shared)
+			{
+				delete[] bmp;
+				glyph._texture = std::move(shared->texture);
+				glyph._uvs = shared->uvs;
+				glyph.key = key;
+			}
+			else
+			{
+				graphics::Image image(bmp, dim);
+				graphics::BindlessTexture texture = load_bindless_texture_2d(image, options.auto_generate_mipmaps);
+				texture.texture().set_parameter(GL_TEXTURE_MIN_FILTER, options.min_filter);
+				texture.texture().set_parameter(GL_TEXTURE_MAG_FILTER, options.mag_filter);
+				texture.set_and_use_handle();
+				glyph._texture = graphics::BindlessTextureRef(std::move(texture));
+				if (padding > 0)
+				{
+					glyph._uvs = {
+						.x1 = float(padding) / dim.w,
+						.x2 = float(dim.w - padding) / dim.w,
+						.y1 = float(padding) / dim.h,
+						.y2 = float(dim.h - padding) / dim.h
+					};
+				}
+			}
+			glyphs.insert_or_assign(codepoint, std::move(glyph));
+		}
+
+		bool FontAtlas::is_cached(utf::Codepoint codepoint) const
+		{
+			auto it = glyphs.find(codepoint);
+			// shared glyphs may have been evicted from the glyph atlas, in which case they are rasterized again
+			return it != glyphs.end() && (it->second.key.font == 0 || GlyphAtlas::instance().contains(it->second.key));
+		}
+
+		void FontAtlas::prewarm(const utf::String& codepoints) const
+		{
+			auto iter = codepoints.begin();
+			while (iter)
+			{
+				utf::Codepoint codepoint = iter.advance();
+				if (codepoint == ' ' || glyphs.find(codepoint) != glyphs.end())
+					continue;
+				int index = font->find_glyph_index(codepoint);
+				if (!index)
+					continue;
+
+				const graphics::ImageDimensions dim = bitmap_dimensions(FontGlyph(*this, index, scale, -1));
+				GlyphRasterizer::instance().enqueue({ .key = { .font = atlas_font, .codepoint = codepoint }, .face = &*font, .index = index,
+					.scale = scale, .w = dim.w, .h = dim.h, .sdf_spread = bitmap_padding() });
+				async_requests = true;
+			}
+		}
+
+		size_t FontAtlas::upload_prewarmed(size_t max_glyphs) const
+		{
+			if (!async_requests)
+				return 0;
+
+			size_t uploaded = 0;
+			for (auto& [key, bitmap] : GlyphRasterizer::instance().claim_ready(atlas_font, max_glyphs))
+			{
+				if (glyphs.find(key.codepoint) != glyphs.end())
+					continue;
+
+				FontGlyph glyph(*this, font->find_glyph_index(key.codepoint), scale, -1);
+				graphics::ImageDimensions dim = bitmap_dimensions(glyph);
+				unsigned char* bmp = dim.pxnew();
+				if (bitmap.w == dim.w && bitmap.h == dim.h && bitmap.pixels.size() == size_t(dim.w) * dim.h)
+					std::copy(bitmap.pixels.begin(), bitmap.pixels.end(), bmp);
+				else
+					glyph.render_on_bitmap_unique(*this, bmp, dim.w, dim.h);
+				store_glyph(key.codepoint, std::move(glyph), bmp);
+				++uploaded;
+			}
+			return uploaded;
+		}
+
+		size_t FontAtlas::pending_glyphs() const
+		{
+			return async_requests ? GlyphRasterizer::instance().pending_count(atlas_font) : 0;
+		}
+
 		void FontAtlas::cache_all(const FontAtlas& other) const
 		{
 			for (const auto& [codepoint, glyph] : other.glyphs)
@@ -181,10 +385,11 @@ namespace oly
 		const FontGlyph& FontAtlas::get_glyph(utf::Codepoint codepoint) const
 		{
 			auto it = glyphs.find(codepoint);
-			if (it != glyphs.end())
-				return it->second;
-			else
+			if (it == glyphs.end())
+				throw Error(ErrorCode::UncachedGlyph);
+			if (it->second.key.font != 0 && !cache(codepoint))
 				throw Error(ErrorCode::UncachedGlyph);
+			return it->second;
 		}
 
 		int FontAtlas::get_glyph_index(utf::Codepoint codepoint) const
@@ -230,7 +435,7 @@ namespace oly
 				};
 			}
 			else
-				return {};
+				return glyph._uvs;
 		}
 	}
 }
@@ -7,6 +7,7 @@
 #include "core/util/UTF.h"
 
 #include "graphics/backend/basic/Textures.h"
+#include "graphics/text/GlyphCache.h"
 #include "graphics/text/Kerning.h"
 
 namespace oly::rendering
@@ -27,6 +28,9 @@ namespace oly::rendering
 		int find_glyph_index(utf::Codepoint codepoint) const;
 		void get_bitmap_box(int glyph_index, float scale, int& ch_x0, int& ch_x1, int& ch_y0, int& ch_y1) const;
 		void make_bitmap(unsigned char* buf, int w, int h, float scale, int glyph_index) const;
+		// Signed distance field of the glyph's outline, with spread pixels of padding on each side of its bitmap box. The edge maps to 128, and
+		// each pixel of distance to 127 / spread, positive inside.
+		void make_sdf_bitmap(unsigned char* buf, int w, int h, float scale, int glyph_index, int spread) const;
 		int get_kerning(utf::Codepoint c1, utf::Codepoint c2) const;
 	};
 
@@ -41,7 +45,9 @@ namespace oly::rendering
 		math::IRect2D _box;
 		int _advance_width = 0, _left_bearing = 0;
 		graphics::BindlessTextureRef _texture;
+		math::UVRect _uvs;
 		size_t buffer_pos = -1;
+		GlyphKey key;
 
 	public:
 		FontGlyph(const FontAtlas& font, int index, float scale, size_t buffer_pos);
@@ -50,6 +56,8 @@ namespace oly::rendering
 		int advance_width() const { return _advance_width; }
 		int left_bearing() const { return _left_bearing; }
 		graphics::BindlessTextureRef texture() const { return _texture; }
+		// null font if the glyph is not in the shared glyph atlas
+		GlyphKey atlas_key() const { return key; }
 
 	private:
 		friend class FontAtlas;
@@ -62,6 +70,9 @@ namespace oly::rendering
 		float font_size = 36.0f;
 		GLenum min_filter = GL_LINEAR, mag_filter = GL_LINEAR;
 		bool auto_generate_mipmaps = false;
+		// Rasterize glyphs as signed distance fields, which stay crisp when text is scaled, so one atlas can serve every size of the font.
+		bool sdf = false;
+		int sdf_spread = 4;
 	};
 
 	class FontAtlas
@@ -76,14 +87,30 @@ namespace oly::rendering
 		float space_advance_width = 0.0f;
 		graphics::ImageDimensions common_dim;
 		graphics::BindlessTextureRef common_texture;
+		glm::uint atlas_font = 0;
+		mutable bool async_requests = false;
 
 	public:
 		FontAtlas(const FontFaceRef& font, FontOptions options, const utf::String& common_buffer);
+		FontAtlas(const FontAtlas&);
+		FontAtlas(FontAtlas&&) noexcept;
+		~FontAtlas();
+		FontAtlas& operator=(const FontAtlas&);
+		FontAtlas& operator=(FontAtlas&&) noexcept;
 
 		const FontFaceRef& font_face() const { return font; }
 
+		// Rasterizes and uploads the glyph if it isn't cached yet. Only prewarmed glyphs are rasterized off the main thread - any other glyph is
+		// rasterized synchronously here, so text that may show arbitrary codepoints should prewarm its charset to avoid hitches.
 		bool cache(utf::Codepoint codepoint) const;
 		void cache_all(const FontAtlas& other) const;
+		// Rasterizes the codepoints on background threads, for example while loading a charset or localization table. Glyphs that are needed
+		// before they are uploaded are finished on demand by cache(), on the calling thread if their rasterization hasn't started yet.
+		void prewarm(const utf::String& codepoints) const;
+		// Uploads up to max_glyphs prewarmed glyphs that have finished rasterizing, and returns how many were uploaded.
+		size_t upload_prewarmed(size_t max_glyphs = -1) const;
+		size_t pending_glyphs() const;
+		bool is_cached(utf::Codepoint codepoint) const;
 		const FontGlyph& get_glyph(utf::Codepoint codepoint) const;
 		int get_glyph_index(utf::Codepoint codepoint) const;
 		bool supports(utf::Codepoint codepoint) const;
@@ -93,6 +120,14 @@ namespace oly::rendering
 		math::UVRect uvs(const FontGlyph& glyph) const;
 		float get_scale() const { return scale; }
 		float get_scaled_space_advance_width() const { return space_advance_width; }
+		bool is_sdf() const { return options.sdf; }
+
+	private:
+		int bitmap_padding() const { return options.sdf ? options.sdf_spread : 0; }
+		graphics::ImageDimensions bitmap_dimensions(const FontGlyph& glyph) const;
+		void drop_shared_glyphs() const;
+		void cancel_async_requests() const;
+		void store_glyph(utf::Codepoint codepoint, FontGlyph&& glyph, unsigned char* bmp) const;
 	};
 
 	typedef SmartReference<FontAtlas> FontAtlasRef;
@@ -0,0 +1,171 @@
+#include "GlyphAtlas.h"
+
+namespace oly::rendering
+{
+	glm::uint GlyphAtlas::register_font(GLenum min_filter, GLenum mag_filter)
+	{
+		size_t pool = 0;
+		while (pool < pools.size() && (pools[pool].min_filter != min_filter || pools[pool].mag_filter != mag_filter))
+			++pool;
+		if (pool == pools.size())
+			pools.push_back(Pool{ .min_filter = min_filter, .mag_filter = mag_filter, .cache = GlyphCache(page_size, max_pages), .pages = {} });
+
+		const glm::uint font = next_font++;
+		font_pools[font] = pool;
+		return font;
+	}
+
+	void GlyphAtlas::unregister_font(glm::uint font)
+	{
+		auto it = font_pools.find(font);
+		if (it == font_pools.end())
+			return;
+
+		pools[it->second].cache.erase_font(font);
+		font_pools.erase(it);
+	}
+
+	bool GlyphAtlas::contains(GlyphKey key)
+	{
+		Pool* pool = pool_of(key);
+		return pool && pool->cache.find(key);
+	}
+
+	std::optional<GlyphAtlas::Glyph> GlyphAtlas::insert(GlyphKey key, const unsigned char* bitmap, int w, int h, int inset)
+	{
+		Pool* pool = pool_of(key);
+		if (!pool)
+			return std::nullopt;
+
+		const std::optional<GlyphCache::Placement> placement = pool->cache.insert(key, { w + 2, h + 2 });
+		if (!placement)
+			return std::nullopt;
+
+		const glm::ivec2 size = pool->cache.get_page_size();
+		while (placement->page >= pool->pages.size())
+		{
+			graphics::Texture texture(GL_TEXTURE_2D);
+			graphics::tex::storage_2d(texture, { .w = size.x, .h = size.y, .cpp = 1 });
+			texture.set_parameter(GL_TEXTURE_MIN_FILTER, pool->min_filter);
+			texture.set_parameter(GL_TEXTURE_MAG_FILTER, pool->mag_filter);
+			graphics::BindlessTexture page(std::move(texture));
+			page.set_and_use_handle();
+			pool->pages.emplace_back(std::move(page));
+		}
+
+		// the padding is uploaded too, since the area may hold leftovers of an evicted glyph
+		std::vector<unsigned char> padded((w + 2) * (h + 2), 0);
+		for (int row = 0; row < h; ++row)
+			std::copy_n(bitmap + row * w, w, padded.data() + (row + 1) * (w + 2) + 1);
+		graphics::tex::subimage_2d(*pool->pages[placement->page], padded.data(), placement->area, 1);
+
+		const math::IArea2D area = placement->area;
+		return Glyph{
+			.texture = pool->pages[placement->page],
+			.uvs = {
+				.x1 = float(area.x + 1 + inset) / size.x,
+				.x2 = float(area.x + 1 + w - inset) / size.x,
+				.y1 = float(area.y + 1 + inset) / size.y,
+				.y2 = float(area.y + 1 + h - inset) / size.y
+			}
+		};
+	}
+
+	void GlyphAtlas::acquire(GlyphKey key)
+	{
+		if (Pool* pool = pool_of(key))
+			pool->cache.acquire(key);
+	}
+
+	void GlyphAtlas::release(GlyphKey key)
+	{
+		if (Pool* pool = pool_of(key))
+			pool->cache.release(key);
+	}
+
+	size_t GlyphAtlas::page_count() const
+	{
+		size_t count = 0;
+		for (const Pool& pool : pools)
+			count += pool.pages.size();
+		return count;
+	}
+
+	GlyphCache::Stats GlyphAtlas::get_stats() const
+	{
+		GlyphCache::Stats stats;
+		for (const Pool& pool : pools)
+		{
+			const GlyphCache::Stats& s = pool.cache.get_stats();
+			stats.hits += s.hits;
+			stats.misses += s.misses;
+			stats.insertions += s.insertions;
+			stats.evictions += s.evictions;
+			stats.rejections += s.rejections;
+		}
+		return stats;
+	}
+
+	void GlyphAtlas::reset_stats()
+	{
+		for (Pool& pool : pools)
+			pool.cache.reset_stats();
+	}
+
+	void GlyphAtlas::clear()
+	{
+		pools.clear();
+		font_pools.clear();
+	}
+
+	GlyphAtlas::Pool* GlyphAtlas::pool_of(GlyphKey key)
+	{
+		auto it = font_pools.find(key.font);
+		return it != font_pools.end() ? &pools[it->second] : nullptr;
+	}
+
+	GlyphLease::GlyphLease(GlyphKey key)
+		: key(key)
+	{
+		GlyphAtlas::instance().acquire(key);
+	}
+
+	GlyphLease::GlyphLease(const GlyphLease& other)
+		: key(other.key)
+	{
+		GlyphAtlas::instance().acquire(key);
+	}
+
+	GlyphLease::GlyphLease(GlyphLease&& other) noexcept
+		: key(other.key)
+	{
+		other.key = {};
+	}
+
+	GlyphLease::~GlyphLease()
+	{
+		GlyphAtlas::instance().release(key);
+	}
+
+	GlyphLease& GlyphLease::operator=(const GlyphLease& other)
+	{
+		if (this != &other)
+		{
+			GlyphAtlas::instance().acquire(other.key);
+			GlyphAtlas::instance().release(key);
+			key = other.key;
+		}
+		return *this;
+	}
+
+	GlyphLease& GlyphLease::operator=(GlyphLease&& other) noexcept
+	{
+		if (this != &other)
+		{
+			GlyphAtlas::instance().release(key);
+			key = other.key;
+			other.key = {};
+		}
+		return *this;
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "graphics/text/GlyphCache.h"
+#include "graphics/backend/basic/Textures.h"
+
+#include "core/types/Singleton.h"
+
+namespace oly::rendering
+{
+	// Glyphs outside of a font's common buffer are packed into texture pages shared by every FontAtlas, rather than each getting its own texture.
+	// Bindless handles bake in sampler state, so fonts with different filters use separate pools of pages.
+	class GlyphAtlas final : public Singleton<GlyphAtlas>
+	{
+		friend class Singleton<GlyphAtlas>;
+
+		struct Pool
+		{
+			GLenum min_filter, mag_filter;
+			GlyphCache cache;
+			std::vector<graphics::BindlessTextureRef> pages;
+		};
+		std::vector<Pool> pools;
+		std::unordered_map<glm::uint, size_t> font_pools;
+		glm::uint next_font = 1;
+
+		GlyphAtlas() = default;
+
+	public:
+		// applies to pools created afterwards
+		glm::ivec2 page_size = { 1024, 1024 };
+		size_t max_pages = 4;
+
+		struct Glyph
+		{
+			graphics::BindlessTextureRef texture;
+			math::UVRect uvs;
+		};
+
+		glm::uint register_font(GLenum min_filter, GLenum mag_filter);
+		void unregister_font(glm::uint font);
+
+		// marks the glyph as recently used
+		bool contains(GlyphKey key);
+		// bitmap has one channel and is w x h - it is uploaded with a pixel of padding on each side
+		// inset excludes that many pixels of the bitmap's own padding from the glyph's uvs
+		std::optional<Glyph> insert(GlyphKey key, const unsigned char* bitmap, int w, int h, int inset = 0);
+
+		void acquire(GlyphKey key);
+		void release(GlyphKey key);
+
+		size_t page_count() const;
+		GlyphCache::Stats get_stats() const;
+		void reset_stats();
+		void clear();
+
+	private:
+		Pool* pool_of(GlyphKey key);
+	};
+
+	// Keeps a glyph in the shared atlas from being evicted while text is displaying it.
+	class GlyphLease
+	{
+		GlyphKey key;
+
+	public:
+		GlyphLease() = default;
+		GlyphLease(GlyphKey key);
+		GlyphLease(const GlyphLease&);
+		GlyphLease(GlyphLease&&) noexcept;
+		~GlyphLease();
+		GlyphLease& operator=(const GlyphLease&);
+		GlyphLease& operator=(GlyphLease&&) noexcept;
+	};
+}
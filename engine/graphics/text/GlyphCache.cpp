@@ -0,0 +1,195 @@
+#include "GlyphCache.h"
+
+namespace oly::rendering
+{
+	GlyphCache::GlyphCache(glm::ivec2 page_size, size_t max_pages)
+		: page_size(page_size), max_pages(max_pages)
+	{
+	}
+
+	const GlyphCache::Placement* GlyphCache::find(GlyphKey key)
+	{
+		auto it = entries.find(key);
+		if (it == entries.end())
+		{
+			++stats.misses;
+			return nullptr;
+		}
+
+		++stats.hits;
+		Entry& entry = it->second;
+		if (entry.leases == 0)
+			lru.splice(lru.begin(), lru, entry.lru);
+		return &entry.placement;
+	}
+
+	std::optional<GlyphCache::Placement> GlyphCache::insert(GlyphKey key, glm::ivec2 size)
+	{
+		if (size.x > page_size.x || size.y > page_size.y || max_pages == 0)
+		{
+			++stats.rejections;
+			return std::nullopt;
+		}
+
+		erase(key);
+
+		Placement placement;
+		size_t shelf = 0;
+		while (!allocate(size, placement, shelf))
+		{
+			if (!evict_least_recently_used())
+			{
+				++stats.rejections;
+				return std::nullopt;
+			}
+		}
+
+		lru.push_front(key);
+		entries.emplace(key, Entry{ .placement = placement, .shelf = shelf, .leases = 0, .lru = lru.begin() });
+		++stats.insertions;
+		return placement;
+	}
+
+	void GlyphCache::erase(GlyphKey key)
+	{
+		auto it = entries.find(key);
+		if (it == entries.end())
+			return;
+
+		free(it->second);
+		if (it->second.leases == 0)
+			lru.erase(it->second.lru);
+		entries.erase(it);
+	}
+
+	void GlyphCache::erase_font(glm::uint font)
+	{
+		for (auto it = entries.begin(); it != entries.end();)
+		{
+			if (it->first.font == font)
+			{
+				free(it->second);
+				if (it->second.leases == 0)
+					lru.erase(it->second.lru);
+				it = entries.erase(it);
+			}
+			else
+				++it;
+		}
+	}
+
+	void GlyphCache::clear()
+	{
+		pages.clear();
+		entries.clear();
+		lru.clear();
+	}
+
+	void GlyphCache::acquire(GlyphKey key)
+	{
+		auto it = entries.find(key);
+		if (it != entries.end() && it->second.leases++ == 0)
+			lru.erase(it->second.lru);
+	}
+
+	void GlyphCache::release(GlyphKey key)
+	{
+		auto it = entries.find(key);
+		if (it != entries.end() && it->second.leases > 0 && --it->second.leases == 0)
+		{
+			lru.push_front(key);
+			it->second.lru = lru.begin();
+		}
+	}
+
+	glm::uint GlyphCache::leases(GlyphKey key) const
+	{
+		auto it = entries.find(key);
+		return it != entries.end() ? it->second.leases : 0;
+	}
+
+	bool GlyphCache::allocate(glm::ivec2 size, Placement& placement, size_t& shelf)
+	{
+		// a shelf fits tightly if at most a quarter of its height is wasted
+		const auto fit_existing_shelf = [this, size, &placement, &shelf](bool tight) -> bool {
+			for (glm::uint p = 0; p < pages.size(); ++p)
+			{
+				for (size_t s = 0; s < pages[p].shelves.size(); ++s)
+				{
+					const int height = pages[p].shelves[s].height;
+					if (height >= size.y && (!tight || 4 * (height - size.y) <= height) && reserve(p, s, size, placement))
+					{
+						shelf = s;
+						return true;
+					}
+				}
+			}
+			return false;
+			};
+
+		const auto open_shelf = [this, size, &placement, &shelf](glm::uint p) -> bool {
+			Page& page = pages[p];
+			if (page.top + size.y > page_size.y)
+				return false;
+
+			page.shelves.push_back(Shelf{ .y = page.top, .height = size.y, .entries = 0, .free = StrictFreeSpaceTracker<int>({ 0, page_size.x }) });
+			page.top += size.y;
+			shelf = page.shelves.size() - 1;
+			return reserve(p, shelf, size, placement);
+			};
+
+		if (fit_existing_shelf(true))
+			return true;
+
+		for (glm::uint p = 0; p < pages.size(); ++p)
+			if (open_shelf(p))
+				return true;
+
+		if (pages.size() < max_pages)
+		{
+			pages.emplace_back();
+			return open_shelf(glm::uint(pages.size() - 1));
+		}
+
+		return fit_existing_shelf(false);
+	}
+
+	bool GlyphCache::reserve(glm::uint page, size_t shelf, glm::ivec2 size, Placement& placement)
+	{
+		Shelf& s = pages[page].shelves[shelf];
+		Range<int> range;
+		if (!s.free.next_free(size.x, range))
+			return false;
+
+		s.free.reserve(range);
+		++s.entries;
+		placement = { .page = page, .area = { .x = range.initial, .y = s.y, .w = size.x, .h = size.y } };
+		return true;
+	}
+
+	bool GlyphCache::evict_least_recently_used()
+	{
+		if (lru.empty())
+			return false;
+
+		const GlyphKey key = lru.back();
+		erase(key);
+		++stats.evictions;
+		return true;
+	}
+
+	void GlyphCache::free(const Entry& entry)
+	{
+		Page& page = pages[entry.placement.page];
+		Shelf& shelf = page.shelves[entry.shelf];
+		shelf.free.release({ entry.placement.area.x, entry.placement.area.w });
+		--shelf.entries;
+
+		// trailing empty shelves give their height back to the page, so that it can be reshelved for other glyph heights
+		while (!page.shelves.empty() && page.shelves.back().entries == 0)
+		{
+			page.top = page.shelves.back().y;
+			page.shelves.pop_back();
+		}
+	}
+}
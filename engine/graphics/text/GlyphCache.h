@@ -0,0 +1,111 @@
+#pragma once
+
+#include "external/GLM.h"
+
+#include "core/containers/FreeSpaceTracker.h"
+#include "core/math/Shapes.h"
+#include "core/util/UTF.h"
+
+#include <list>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace oly::rendering
+{
+	struct GlyphKey
+	{
+		glm::uint font = 0;
+		utf::Codepoint codepoint = utf::Codepoint(0);
+
+		bool operator==(const GlyphKey&) const = default;
+	};
+
+	struct GlyphKeyHash
+	{
+		size_t operator()(const GlyphKey& k) const { return std::hash<glm::uint>{}(k.font) ^ (std::hash<utf::Codepoint>{}(k.codepoint) << 1); }
+	};
+
+	// Bookkeeping for glyph bitmaps packed into fixed-size pages. Each page is split into shelves of glyphs with similar heights, and new pages
+	// are opened up to max_pages. When nothing fits, the least recently used glyphs are evicted until the glyph fits. Leased glyphs are in use
+	// by text on screen, and are never evicted. Textures are not managed here, so packing and eviction can run without a GPU.
+	class GlyphCache
+	{
+	public:
+		struct Placement
+		{
+			glm::uint page = 0;
+			math::IArea2D area;
+		};
+
+		struct Stats
+		{
+			size_t hits = 0;
+			size_t misses = 0;
+			size_t insertions = 0;
+			size_t evictions = 0;
+			size_t rejections = 0;
+		};
+
+	private:
+		struct Shelf
+		{
+			int y = 0;
+			int height = 0;
+			glm::uint entries = 0;
+			StrictFreeSpaceTracker<int> free;
+		};
+
+		struct Page
+		{
+			std::vector<Shelf> shelves;
+			int top = 0;
+		};
+
+		struct Entry
+		{
+			Placement placement;
+			size_t shelf = 0;
+			glm::uint leases = 0;
+			std::list<GlyphKey>::iterator lru;
+		};
+
+		glm::ivec2 page_size;
+		size_t max_pages;
+		std::vector<Page> pages;
+		std::unordered_map<GlyphKey, Entry, GlyphKeyHash> entries;
+		// most recently used at the front - leased glyphs are not in the list
+		std::list<GlyphKey> lru;
+		Stats stats;
+
+	public:
+		GlyphCache(glm::ivec2 page_size = { 1024, 1024 }, size_t max_pages = 4);
+
+		glm::ivec2 get_page_size() const { return page_size; }
+		size_t get_max_pages() const { return max_pages; }
+		size_t page_count() const { return pages.size(); }
+		size_t size() const { return entries.size(); }
+
+		// Looks up a glyph and marks it as recently used. Counts as a hit or miss.
+		const Placement* find(GlyphKey key);
+		// Packs a glyph of the given size, which should include any padding. Returns nullopt if the glyph is larger than a page, or if every glyph
+		// that could make room for it is leased.
+		std::optional<Placement> insert(GlyphKey key, glm::ivec2 size);
+		void erase(GlyphKey key);
+		void erase_font(glm::uint font);
+		void clear();
+
+		void acquire(GlyphKey key);
+		void release(GlyphKey key);
+		glm::uint leases(GlyphKey key) const;
+
+		const Stats& get_stats() const { return stats; }
+		void reset_stats() { stats = {}; }
+
+	private:
+		bool allocate(glm::ivec2 size, Placement& placement, size_t& shelf);
+		bool reserve(glm::uint page, size_t shelf, glm::ivec2 size, Placement& placement);
+		bool evict_least_recently_used();
+		void free(const Entry& entry);
+	};
+}
@@ -0,0 +1,153 @@
+#include "GlyphRasterizer.h"
+
+#include "graphics/text/Font.h"
+
+#include <algorithm>
+
+namespace oly::rendering
+{
+	GlyphRasterizer::GlyphRasterizer()
+	{
+		// rasterization shares the machine with the worker pool, so only a few threads are spent on it
+		const size_t hardware = std::thread::hardware_concurrency();
+		const size_t num_threads = std::clamp(hardware / 4, size_t(1), size_t(4));
+		threads.reserve(num_threads);
+		for (size_t i = 0; i < num_threads; ++i)
+			threads.emplace_back([this]() { worker_loop(); });
+	}
+
+	GlyphRasterizer::~GlyphRasterizer()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+			queue.clear();
+			queued.clear();
+		}
+		wake.notify_all();
+		for (std::thread& thread : threads)
+			thread.join();
+	}
+
+	void GlyphRasterizer::enqueue(const Request& request)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (in_flight.contains(request.key) || ready.contains(request.key) || !queued.try_emplace(request.key, request).second)
+				return;
+			queue.push_back(request.key);
+		}
+		wake.notify_one();
+	}
+
+	bool GlyphRasterizer::pending(GlyphKey key) const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return in_flight.contains(key) || ready.contains(key) || queued.contains(key);
+	}
+
+	size_t GlyphRasterizer::pending_count(glm::uint font) const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		size_t count = std::count_if(queued.begin(), queued.end(), [font](const auto& pair) { return pair.first.font == font; });
+		count += std::count_if(in_flight.begin(), in_flight.end(), [font](GlyphKey key) { return key.font == font; });
+		count += std::count_if(ready.begin(), ready.end(), [font](const auto& pair) { return pair.first.font == font; });
+		return count;
+	}
+
+	std::optional<GlyphRasterizer::Bitmap> GlyphRasterizer::claim(GlyphKey key)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		auto request_it = queued.find(key);
+		if (request_it != queued.end())
+		{
+			const Request request = request_it->second;
+			queued.erase(request_it);
+			lock.unlock();
+			return rasterize(request);
+		}
+
+		done.wait(lock, [this, key]() { return !in_flight.contains(key); });
+		auto it = ready.find(key);
+		if (it == ready.end())
+			return std::nullopt;
+
+		Bitmap bitmap = std::move(it->second);
+		ready.erase(it);
+		return bitmap;
+	}
+
+	std::vector<std::pair<GlyphKey, GlyphRasterizer::Bitmap>> GlyphRasterizer::claim_ready(glm::uint font, size_t max_glyphs)
+	{
+		std::vector<std::pair<GlyphKey, Bitmap>> claimed;
+		std::lock_guard<std::mutex> lock(mutex);
+		for (auto it = ready.begin(); it != ready.end() && claimed.size() < max_glyphs;)
+		{
+			if (it->first.font == font)
+			{
+				claimed.emplace_back(it->first, std::move(it->second));
+				it = ready.erase(it);
+			}
+			else
+				++it;
+		}
+		return claimed;
+	}
+
+	void GlyphRasterizer::cancel(glm::uint font)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		std::erase_if(queued, [font](const auto& pair) { return pair.first.font == font; });
+		done.wait(lock, [this, font]() { return std::none_of(in_flight.begin(), in_flight.end(), [font](GlyphKey key) { return key.font == font; }); });
+		std::erase_if(ready, [font](const auto& pair) { return pair.first.font == font; });
+	}
+
+	void GlyphRasterizer::worker_loop()
+	{
+		while (true)
+		{
+			Request request;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				wake.wait(lock, [this]() { return stopping || !queue.empty(); });
+				if (stopping)
+					return;
+				auto it = queued.find(queue.front());
+				queue.pop_front();
+				if (it == queued.end())
+					continue;
+				request = it->second;
+				queued.erase(it);
+				in_flight.insert(request.key);
+			}
+
+			Bitmap bitmap;
+			try
+			{
+				bitmap = rasterize(request);
+			}
+			catch (...)
+			{
+				// an incomplete bitmap is rasterized again by the main thread
+				bitmap = {};
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				in_flight.erase(request.key);
+				ready.insert_or_assign(request.key, std::move(bitmap));
+			}
+			done.notify_all();
+		}
+	}
+
+	GlyphRasterizer::Bitmap GlyphRasterizer::rasterize(const Request& request)
+	{
+		Bitmap bitmap{ .pixels = std::vector<unsigned char>(size_t(request.w) * request.h), .w = request.w, .h = request.h };
+		if (request.sdf_spread > 0)
+			request.face->make_sdf_bitmap(bitmap.pixels.data(), request.w, request.h, request.scale, request.index, request.sdf_spread);
+		else
+			request.face->make_bitmap(bitmap.pixels.data(), request.w, request.h, request.scale, request.index);
+		return bitmap;
+	}
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "graphics/text/GlyphCache.h"
+
+#include "core/types/Singleton.h"
+
+#include <deque>
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace oly::rendering
+{
+	class FontFace;
+
+	// Rasterizes glyph bitmaps on background threads. Bitmaps are held until claimed by the main thread, which uploads them, since it owns the GL context.
+	class GlyphRasterizer final : public Singleton<GlyphRasterizer>
+	{
+		friend class Singleton<GlyphRasterizer>;
+
+	public:
+		struct Request
+		{
+			GlyphKey key;
+			const FontFace* face = nullptr;
+			int index = 0;
+			float scale = 1.0f;
+			int w = 0, h = 0;
+			// rasterizes a signed distance field if positive
+			int sdf_spread = 0;
+		};
+
+		struct Bitmap
+		{
+			std::vector<unsigned char> pixels;
+			int w = 0, h = 0;
+		};
+
+	private:
+		std::vector<std::thread> threads;
+
+		mutable std::mutex mutex;
+		std::condition_variable wake;
+		std::condition_variable done;
+
+		// requests are indexed by key, and taken by the workers in the order of their keys in the queue. Keys whose request was claimed or
+		// cancelled are left in the queue and skipped.
+		std::deque<GlyphKey> queue;
+		std::unordered_map<GlyphKey, Request, GlyphKeyHash> queued;
+		std::unordered_set<GlyphKey, GlyphKeyHash> in_flight;
+		std::unordered_map<GlyphKey, Bitmap, GlyphKeyHash> ready;
+		bool stopping = false;
+
+		GlyphRasterizer();
+
+	public:
+		~GlyphRasterizer();
+
+		// The face must outlive the request - cancel() the font before destroying it.
+		void enqueue(const Request& request);
+		bool pending(GlyphKey key) const;
+		size_t pending_count(glm::uint font) const;
+
+		// Takes the glyph's bitmap if it was requested. A glyph still in the queue is rasterized on the calling thread, and a glyph being rasterized
+		// is waited on, so that callers never have to draw a glyph that isn't ready.
+		std::optional<Bitmap> claim(GlyphKey key);
+		// Takes up to max_glyphs of the font's finished bitmaps without blocking.
+		std::vector<std::pair<GlyphKey, Bitmap>> claim_ready(glm::uint font, size_t max_glyphs = -1);
+		// Drops the font's requests and waits for any that are being rasterized.
+		void cancel(glm::uint font);
+
+	private:
+		void worker_loop();
+		static Bitmap rasterize(const Request& request);
+	};
+}
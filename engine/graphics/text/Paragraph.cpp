@@ -10,6 +10,8 @@
 
 #include "definitions/Keys.h"
 
+#include <algorithm>
+
 namespace oly::rendering
 {
 	ParagraphFormatExposure::ParagraphFormatExposure(Paragraph& paragraph)
@@ -23,7 +25,7 @@ namespace oly::rendering
 		{
 			paragraph.format.line_spacing = line_spacing;
 			if (paragraph.format.max_height > 0.0f)
-				paragraph.dirty_layout |= internal::DirtyParagraph::RebuildLayout;
+				paragraph.invalidate_layout();
 			else
 				paragraph.dirty_layout |= internal::DirtyParagraph::LineSpacing;
 		}
@@ -34,7 +36,7 @@ namespace oly::rendering
 		if (paragraph.format.tab_spaces != tab_spaces)
 		{
 			paragraph.format.tab_spaces = tab_spaces;
-			paragraph.dirty_layout |= internal::DirtyParagraph::RebuildLayout;
+			paragraph.invalidate_layout();
 		}
 	}
 	
@@ -44,7 +46,7 @@ namespace oly::rendering
 		{
 			paragraph.format.linebreak_spacing = linebreak_spacing;
 			if (paragraph.format.max_height > 0.0f)
-				paragraph.dirty_layout |= internal::DirtyParagraph::RebuildLayout;
+				paragraph.invalidate_layout();
 			else
 				paragraph.dirty_layout |= internal::DirtyParagraph::LineSpacing;
 		}
@@ -73,7 +75,7 @@ namespace oly::rendering
 		if (paragraph.format.text_wrap != text_wrap)
 		{
 			paragraph.format.text_wrap = text_wrap;
-			paragraph.dirty_layout |= internal::DirtyParagraph::RebuildLayout;
+			paragraph.invalidate_layout();
 		}
 	}
 	
@@ -82,7 +84,7 @@ namespace oly::rendering
 		if (paragraph.format.max_height != max_height)
 		{
 			paragraph.format.max_height = max_height;
-			paragraph.dirty_layout |= internal::DirtyParagraph::RebuildLayout;
+			paragraph.invalidate_layout();
 		}
 	}
 
@@ -191,9 +193,23 @@ namespace oly::rendering
 
 	internal::GlyphGroup::WriteResult internal::GlyphGroup::write_glyph_section(TypesetData& typeset, PeekData next_peek) const
 	{
+		const bool restyle = dirty & DirtyGlyphGroup::Restyle;
+		const bool recolor_all = dirty & DirtyGlyphGroup::Recolor;
 		dirty = internal::DirtyGlyphGroup(0);
-		clear_cache();
 
+		// existing glyphs are rewritten in place, and only those whose codepoint changed are given a new glyph
+		size_t count = 0;
+		const WriteResult result = write_section(typeset, next_peek, count, restyle);
+		glyphs.erase(glyphs.begin() + count, glyphs.end());
+		cached_info.resize(count);
+
+		if (recolor_all)
+			recolor();
+		return result;
+	}
+
+	internal::GlyphGroup::WriteResult internal::GlyphGroup::write_section(TypesetData& typeset, PeekData next_peek, size_t& count, bool restyle) const
+	{
 		auto iter = element.text.begin();
 		if (!iter)
 			return WriteResult::Continue;
@@ -227,7 +243,7 @@ namespace oly::rendering
 					if (!write_newline(typeset, line))
 						return WriteResult::Break;
 				}
-				write_glyph(typeset, codepoint, dx, line, paragraph->is_camera_invariant());
+				write_glyph(typeset, codepoint, dx, line, count++, restyle);
 			}
 			else
 			{
@@ -235,7 +251,6 @@ namespace oly::rendering
 			}
 		}
 
-		recolor();
 		return WriteResult::Continue;
 	}
 
@@ -379,22 +394,44 @@ namespace oly::rendering
 		return true;
 	}
 
-	void internal::GlyphGroup::write_glyph(TypesetData& typeset, utf::Codepoint c, float dx, LineAlignment line, bool is_camera_invariant) const
+	void internal::GlyphGroup::write_glyph(TypesetData& typeset, utf::Codepoint c, float dx, LineAlignment line, size_t i, bool restyle) const
 	{
-		cached_info.push_back(CachedGlyphInfo{ .typeset = typeset, .line_y_offset = line.y_offset });
-		TextGlyph glyph;
-		glyph.transformer.attach_parent(&paragraph->transformer);
-		glyph.set_camera_invariant(is_camera_invariant);
-		element.set_glyph(glyph, c, get_glyph_position(glyphs.size()));
-		glyphs.push_back(std::move(glyph));
+		const CachedGlyphInfo info{ .typeset = typeset, .line_y_offset = line.y_offset, .codepoint = c, .offset = {} };
 		typeset.x += dx;
 		++typeset.character;
+
+		if (i < glyphs.size() && !restyle && cached_info[i].codepoint == c)
+		{
+			const glm::vec2 offset = cached_info[i].offset;
+			cached_info[i] = info;
+			cached_info[i].offset = offset;
+			const glm::vec2 position = get_glyph_position(i);
+			if (glyphs[i].get_local().position != position)
+				glyphs[i].set_local().position = position;
+			return;
+		}
+
+		if (i < glyphs.size())
+			cached_info[i] = info;
+		else
+		{
+			cached_info.push_back(info);
+			TextGlyph glyph;
+			glyph.transformer.attach_parent(&paragraph->transformer);
+			glyph.set_camera_invariant(paragraph->is_camera_invariant());
+			glyph.set_text_color(element.text_color);
+			glyphs.push_back(std::move(glyph));
+		}
+
+		const glm::vec2 position = get_glyph_position(i);
+		element.set_glyph(glyphs[i], c, position);
+		cached_info[i].offset = glyphs[i].get_local().position - position;
 	}
 
 	glm::vec2 internal::GlyphGroup::get_glyph_position(size_t i) const
 	{
 		const CachedGlyphInfo& cache = cached_info[i];
-		return paragraph->alignment_cache.position(cache.typeset) + glm::vec2{ 0.0f, cache.line_y_offset } + element.jitter_offset;
+		return paragraph->alignment_cache.position(cache.typeset) + glm::vec2{ 0.0f, cache.line_y_offset } + element.jitter_offset + cache.offset;
 	}
 
 	float internal::GlyphGroup::space_width(utf::Codepoint next_codepoint) const
@@ -445,10 +482,19 @@ namespace oly::rendering
 			glyph.set_local().position += element.jitter_offset - last_jitter_offset;
 	}
 
-	void internal::GlyphGroup::reposition_glyphs() const
+	void internal::GlyphGroup::reposition_glyphs(size_t first_line) const
 	{
-		for (size_t i = 0; i < glyphs.size(); ++i)
-			glyphs[i].set_local().position = get_glyph_position(i);
+		// positions are set absolutely, so pending jitter must be applied to the glyphs that are left untouched
+		if (first_line > 0 && (dirty & DirtyGlyphGroup::JitterOffset))
+			reposition_jitter();
+		dirty &= ~DirtyGlyphGroup::JitterOffset;
+
+		for (size_t i = glyphs.size(); i > 0 && cached_info[i - 1].typeset.line >= first_line; --i)
+		{
+			CachedGlyphInfo& info = cached_info[i - 1];
+			info.line_y_offset = element.line_y_pivot * (paragraph->page_data.lines[info.typeset.line].max_height - element.line_height());
+			glyphs[i - 1].set_local().position = get_glyph_position(i - 1);
+		}
 	}
 
 	void internal::GlyphGroup::set_camera_invariant(bool is_camera_invariant) const
@@ -462,12 +508,19 @@ namespace oly::rendering
 	{
 	}
 
+	void TextElementExposure::invalidate_layout(bool restyle) const
+	{
+		if (restyle)
+			glyph_group.dirty |= internal::DirtyGlyphGroup::Restyle;
+		paragraph.invalidate_layout(&glyph_group - paragraph.glyph_groups.data());
+	}
+
 	void TextElementExposure::set_font(const FontAtlasRef& font)
 	{
 		if (glyph_group.element.font != font)
 		{
 			glyph_group.element.font = font;
-			paragraph.dirty_layout |= internal::DirtyParagraph::RebuildLayout;
+			invalidate_layout(true);
 		}
 	}
 
@@ -476,7 +529,7 @@ namespace oly::rendering
 		if (glyph_group.element.font != font)
 		{
 			glyph_group.element.font = font;
-			paragraph.dirty_layout |= internal::DirtyParagraph::RebuildLayout;
+			invalidate_layout(true);
 		}
 	}
 	
@@ -485,7 +538,7 @@ namespace oly::rendering
 		if (glyph_group.element.text != text)
 		{
 			glyph_group.element.text = std::move(text);
-			paragraph.dirty_layout |= internal::DirtyParagraph::RebuildLayout;
+			invalidate_layout(false);
 		}
 	}
 	
@@ -503,7 +556,7 @@ namespace oly::rendering
 		if (glyph_group.element.adj_offset != adj_offset)
 		{
 			glyph_group.element.adj_offset = adj_offset;
-			paragraph.dirty_layout |= internal::DirtyParagraph::RebuildLayout;
+			invalidate_layout(false);
 		}
 	}
 	
@@ -512,7 +565,7 @@ namespace oly::rendering
 		if (glyph_group.element.scale != scale)
 		{
 			glyph_group.element.scale = scale;
-			paragraph.dirty_layout |= internal::DirtyParagraph::RebuildLayout;
+			invalidate_layout(true);
 		}
 	}
 	
@@ -561,13 +614,19 @@ namespace oly::rendering
 	{
 		bkg.transformer.attach_parent(&transformer);
 		
+		// copied glyphs are attached to the other paragraph
 		for (internal::GlyphGroup& glyph_group : glyph_groups)
+		{
 			glyph_group.paragraph = this;
+			glyph_group.clear_cache();
+		}
+		invalidate_layout();
 	}
 
 	Paragraph::Paragraph(Paragraph&& other) noexcept
 		: bkg(std::move(other.bkg)), format(std::move(other.format)), dirty_layout(other.dirty_layout), glyph_groups(std::move(other.glyph_groups)),
-		page_data(std::move(other.page_data)), page_layout(std::move(other.page_layout)), transformer(std::move(other.transformer)), draw_bkg(other.draw_bkg)
+		page_data(std::move(other.page_data)), page_layout(std::move(other.page_layout)), alignment_cache(std::move(other.alignment_cache)),
+		written_glyph_groups(other.written_glyph_groups), relayout_from(other.relayout_from), transformer(std::move(other.transformer)), draw_bkg(other.draw_bkg)
 	{
 		for (internal::GlyphGroup& glyph_group : glyph_groups)
 			glyph_group.paragraph = this;
@@ -590,6 +649,9 @@ namespace oly::rendering
 			glyph_groups = std::move(other.glyph_groups);
 			page_data = std::move(other.page_data);
 			page_layout = std::move(other.page_layout);
+			alignment_cache = std::move(other.alignment_cache);
+			written_glyph_groups = other.written_glyph_groups;
+			relayout_from = other.relayout_from;
 			transformer = std::move(other.transformer);
 			draw_bkg = other.draw_bkg;
 
@@ -655,7 +717,7 @@ namespace oly::rendering
 	{
 		glyph_groups.emplace_back(std::move(element));
 		glyph_groups.back().paragraph = this;
-		dirty_layout |= internal::DirtyParagraph::RebuildLayout;
+		invalidate_layout(glyph_groups.size() - 1);
 	}
 	
 	void Paragraph::insert_element(size_t i, TextElement&& element)
@@ -665,13 +727,13 @@ namespace oly::rendering
 
 		glyph_groups.emplace(glyph_groups.begin() + i, std::move(element));
 		glyph_groups[i].paragraph = this;
-		dirty_layout |= internal::DirtyParagraph::RebuildLayout;
+		invalidate_layout(i);
 	}
 	
 	void Paragraph::erase_element(size_t i)
 	{
 		glyph_groups.erase(glyph_groups.begin() + i);
-		dirty_layout |= internal::DirtyParagraph::RebuildLayout;
+		invalidate_layout(i);
 	}
 
 	void Paragraph::draw() const
@@ -687,8 +749,16 @@ namespace oly::rendering
 	{
 		if (dirty_layout & internal::DirtyParagraph::RebuildLayout)
 		{
-			build_layout();
-			write_glyphs();
+			// any other change since the last layout may affect every line, and justified alignment spreads width or height over the whole page
+			size_t from = relayout_from;
+			if (dirty_layout != internal::DirtyParagraph::RebuildLayout || format.horizontal_alignment == ParagraphFormat::HorizontalAlignment::Justify
+				|| format.vertical_alignment == ParagraphFormat::VerticalAlignment::Justify
+				|| format.vertical_alignment == ParagraphFormat::VerticalAlignment::FullJustify)
+				from = 0;
+
+			const internal::PageLayout previous_layout = page_layout;
+			build_layout(from);
+			write_glyphs(from, previous_layout);
 
 			auto& bkg_modifier = bkg.transformer.ref_modifier<PivotTransformModifier2D>();
 			bkg_modifier.size = page_layout.fitted_size + 2.0f * format.padding;
@@ -748,17 +818,44 @@ namespace oly::rendering
 		dirty_layout = internal::DirtyParagraph(0);
 	}
 
-	void Paragraph::build_layout() const
+	void Paragraph::invalidate_layout(size_t group) const
 	{
-		dirty_layout = internal::DirtyParagraph(0);
+		// the previous group is also affected, since its last advance is kerned against the first codepoint of the group
+		dirty_layout |= internal::DirtyParagraph::RebuildLayout;
+		relayout_from = std::min(relayout_from, group > 0 ? group - 1 : 0);
+	}
 
-		page_layout = {};
-		page_data = {};
-		page_data.lines.push_back({});
+	void Paragraph::build_layout(size_t from) const
+	{
+		dirty_layout = internal::DirtyParagraph(0);
+		relayout_from = size_t(-1);
 
 		TypesetData typeset = {};
-		for (size_t i = 0; i < glyph_groups.size(); ++i)
+		if (from > 0 && from < glyph_groups.size())
+		{
+			// groups before from are unchanged, so the page is resumed from the line where group from started
+			const internal::GlyphGroup::SectionStart& start = glyph_groups[from].section_start;
+			page_data.lines.resize(start.build.line + 1);
+			page_data.current_line() = start.line;
+			page_data.linebreaks = start.linebreaks;
+			typeset = start.build;
+		}
+		else
+		{
+			from = 0;
+			page_layout = {};
+			page_data = {};
+			page_data.lines.push_back({});
+		}
+
+		for (size_t i = from; i < glyph_groups.size(); ++i)
+		{
+			internal::GlyphGroup::SectionStart& start = glyph_groups[i].section_start;
+			start.build = typeset;
+			start.line = page_data.current_line();
+			start.linebreaks = page_data.linebreaks;
 			glyph_groups[i].build_page_section(typeset, peek_next(i));
+		}
 		page_data.current_line().width = typeset.x;
 
 		recompute_content_size_x(), recompute_content_size_y();
@@ -766,15 +863,36 @@ namespace oly::rendering
 		compute_alignment_cache(AlignmentFlags(~0));
 	}
 
-	void Paragraph::write_glyphs() const
+	void Paragraph::write_glyphs(size_t from, const internal::PageLayout& previous_layout) const
 	{
+		// the last written group may have stopped at max_height, so it is rewritten together with the groups after it
+		from = std::min(from, written_glyph_groups > 0 ? written_glyph_groups - 1 : 0);
+
 		TypesetData typeset = {};
+		if (from > 0 && from < glyph_groups.size())
+		{
+			typeset = glyph_groups[from].section_start.write;
+
+			// glyphs of earlier groups only move if they share a line with the rewritten groups, unless the page size changed
+			const bool same_page = page_layout.content_size == previous_layout.content_size && page_layout.fitted_size == previous_layout.fitted_size;
+			const size_t first_line = same_page ? typeset.line : 0;
+			for (size_t i = from; i > 0; --i)
+			{
+				glyph_groups[i - 1].reposition_glyphs(first_line);
+				if (glyph_groups[i - 1].section_start.write.line < first_line)
+					break;
+			}
+		}
+		else
+			from = 0;
+
 		bool writing = true;
 		written_glyph_groups = glyph_groups.size();
-		for (size_t i = 0; i < glyph_groups.size(); ++i)
+		for (size_t i = from; i < glyph_groups.size(); ++i)
 		{
 			if (writing)
 			{
+				glyph_groups[i].section_start.write = typeset;
 				if (glyph_groups[i].write_glyph_section(typeset, peek_next(i)) == internal::GlyphGroup::WriteResult::Break)
 				{
 					written_glyph_groups = i + 1;
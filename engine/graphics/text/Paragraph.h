@@ -49,8 +49,20 @@ namespace oly::rendering
 			{
 				TypesetData typeset;
 				float line_y_offset;
+				utf::Codepoint codepoint;
+				glm::vec2 offset;
 			};
 			mutable std::vector<CachedGlyphInfo> cached_info;
+
+			// typesetting state at the start of this group, from which the page is rebuilt and rewritten when a later group changes
+			struct SectionStart
+			{
+				TypesetData build;
+				PageBuildData::Line line;
+				GLuint linebreaks = 0;
+				TypesetData write;
+			};
+			mutable SectionStart section_start;
 			mutable glm::vec2 last_jitter_offset = {};
 
 			mutable DirtyGlyphGroup dirty = ~DirtyGlyphGroup(0);
@@ -80,6 +92,7 @@ namespace oly::rendering
 			void clear_cache() const;
 
 		private:
+			WriteResult write_section(TypesetData& typeset, PeekData next_peek, size_t& count, bool restyle) const;
 			void build_adj_offset(TypesetData& typeset, PeekData next_peek) const;
 			void build_space(TypesetData& typeset, utf::Codepoint next_codepoint) const;
 			void build_tab(TypesetData& typeset, utf::Codepoint next_codepoint) const;
@@ -95,7 +108,7 @@ namespace oly::rendering
 			void write_space(TypesetData& typeset, utf::Codepoint next_codepoint) const;
 			void write_tab(TypesetData& typeset, utf::Codepoint next_codepoint) const;
 			bool write_newline(TypesetData& typeset, LineAlignment& line) const;
-			void write_glyph(TypesetData& typeset, utf::Codepoint c, float dx, LineAlignment line, bool is_camera_invariant) const;
+			void write_glyph(TypesetData& typeset, utf::Codepoint c, float dx, LineAlignment line, size_t i, bool restyle) const;
 			glm::vec2 get_glyph_position(size_t i) const;
 
 			float space_width(utf::Codepoint next_codepoint) const;
@@ -106,7 +119,7 @@ namespace oly::rendering
 			void reposition_jitter() const;
 
 		public:
-			void reposition_glyphs() const;
+			void reposition_glyphs(size_t first_line = 0) const;
 			void set_camera_invariant(bool is_camera_invariant) const;
 		};
 	}
@@ -121,6 +134,8 @@ namespace oly::rendering
 
 		TextElementExposure(Paragraph& paragraph, internal::GlyphGroup& glyph_group);
 
+		void invalidate_layout(bool restyle) const;
+
 	public:
 		void set_font(const FontAtlasRef& font);
 		void set_font(const RasterFontRef& font);
@@ -149,6 +164,7 @@ namespace oly::rendering
 		mutable internal::PageLayout page_layout;
 		mutable internal::AlignmentCache alignment_cache;
 		mutable size_t written_glyph_groups = 0;
+		mutable size_t relayout_from = 0;
 
 		mutable Transformer2D transformer;
 
@@ -202,9 +218,10 @@ namespace oly::rendering
 		void draw() const;
 
 	private:
+		void invalidate_layout(size_t group = 0) const;
 		void clean_dirty_layout() const;
-		void build_layout() const;
-		void write_glyphs() const;
+		void build_layout(size_t from) const;
+		void write_glyphs(size_t from, const internal::PageLayout& previous_layout) const;
 
 		enum AlignmentFlags
 		{
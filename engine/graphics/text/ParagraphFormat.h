@@ -32,7 +32,8 @@ namespace oly::rendering
 		{
 			Recolor = 1 << 0,
 			LineAlignment = 1 << 1,
-			JitterOffset = 1 << 2
+			JitterOffset = 1 << 2,
+			Restyle = 1 << 3
 		};
 
 		inline DirtyGlyphGroup operator~(DirtyGlyphGroup a) { return DirtyGlyphGroup(~(int)a); }
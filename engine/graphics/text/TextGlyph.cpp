@@ -16,13 +16,13 @@ namespace oly::rendering
 	}
 
 	TextGlyph::TextGlyph(const TextGlyph& other)
-		: ref(other.ref), transformer(other.transformer)
+		: ref(other.ref), lease(other.lease), transformer(other.transformer)
 	{
 		ref.set_text_glyph(true);
 	}
 
 	TextGlyph::TextGlyph(TextGlyph&& other) noexcept
-		: ref(std::move(other.ref)), transformer(std::move(other.transformer))
+		: ref(std::move(other.ref)), lease(std::move(other.lease)), transformer(std::move(other.transformer))
 	{
 		ref.set_text_glyph(true);
 	}
@@ -42,11 +42,15 @@ namespace oly::rendering
 
 	void TextGlyph::set_glyph(const FontAtlas& atlas, const FontGlyph& glyph, glm::vec2 pos, glm::vec2 scale)
 	{
+		lease = GlyphLease(glyph.atlas_key());
+		ref.set_sdf_glyph(atlas.is_sdf());
 		set_glyph(glyph.texture(), (math::Rect2D)glyph.box(), pos, scale, atlas.get_scale() * glyph.left_bearing(), atlas.get_ascent(), atlas.uvs(glyph));
 	}
 
 	void TextGlyph::set_glyph(const RasterFont& font, const RasterFontGlyph& glyph, glm::vec2 pos, glm::vec2 scale)
 	{
+		lease = GlyphLease();
+		ref.set_sdf_glyph(false);
 		set_glyph(glyph.texture(), glyph.box().get_scaled(font.get_scale()), pos, scale, font.get_scale().x * glyph.left_bearing(), font.line_height(), glyph.uvs());
 	}
 
@@ -2,6 +2,7 @@
 
 #include "graphics/sprites/SpriteBatch.h"
 #include "graphics/text/Font.h"
+#include "graphics/text/GlyphAtlas.h"
 #include "graphics/text/RasterFont.h"
 #include "core/base/Transforms.h"
 
@@ -10,6 +11,7 @@ namespace oly::rendering
 	class TextGlyph
 	{
 		internal::SpriteReference ref;
+		GlyphLease lease;
 
 	public:
 		Transformer2D transformer;
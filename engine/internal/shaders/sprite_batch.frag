@@ -4,6 +4,8 @@
 
 layout(location = 0) out vec4 oColor;
 
+const uint16_t SDF_FLAG = uint16_t(4);
+
 in vec2 tTexCoord;
 flat in uint16_t tTexSlot;
 flat in vec4 tModulation;
@@ -32,9 +34,14 @@ void main() {
 			baseColor = texture(sampler2D(uTexData[tTexSlot].handle), tTexCoord);
 		else
 			baseColor = texture(sampler2DArray(uTexData[tTexSlot].handle), vec3(tTexCoord.x, tTexCoord.y, tFramePlusOne - uint16_t(1)));
-	} else {
+	} else if ((tIsTextGlyph & SDF_FLAG) == uint16_t(0)) {
 		float alpha = texture(sampler2D(uTexData[tTexSlot].handle), tTexCoord).r;
 		baseColor = mix(vec4(0.0), vec4(1.0), alpha);
+	} else {
+		// the glyph edge is at 0.5 - antialias over about one screen pixel, whatever the glyph's scale
+		float dist = texture(sampler2D(uTexData[tTexSlot].handle), tTexCoord).r;
+		float aa = max(fwidth(dist), 1e-4);
+		baseColor = mix(vec4(0.0), vec4(1.0), smoothstep(0.5 - aa, 0.5 + aa, dist));
 	}
 	oColor = tModulation * sampleModTex() * baseColor;
 }
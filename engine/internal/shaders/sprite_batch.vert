@@ -17,6 +17,7 @@ layout(std430, binding = 0) readonly buffer TextureData {
 
 const uint16_t GLYPH_FLAG = uint16_t(1);
 const uint16_t CAM_INV_FLAG = uint16_t(2);
+const uint16_t SDF_FLAG = uint16_t(4);
 
 struct QuadInfo
 {
@@ -92,7 +93,7 @@ void main() {
 		tTexSlot = quad.texSlot;
 		tModulation = uGlobalModulation * uModulation[quad.colorSlot];
 		tFramePlusOne = quad.frameSlot > uint16_t(0) ? uint16_t(1) + calc_frame(uAnims[quad.frameSlot]) : uint16_t(0);
-		tIsTextGlyph = quad.flags & GLYPH_FLAG;
+		tIsTextGlyph = quad.flags & (GLYPH_FLAG | SDF_FLAG);
 		tModTexCoord = calc_tex_coords(uTexCoords[quad.modTexCoordSlot]);
 		tModTexSlot = quad.modTexSlot;
 	} else {
@@ -91,12 +91,12 @@ namespace oly::col2d
 
 	float ConvexHull::projection_min(const UnitVector2D& axis) const
 	{
-		return internal::polygon_projection_min(_points, axis, proj_cache);
+		return internal::polygon_projection_min(_points, axis);
 	}
 
 	float ConvexHull::projection_max(const UnitVector2D& axis) const
 	{
-		return internal::polygon_projection_max(_points, axis, proj_cache);
+		return internal::polygon_projection_max(_points, axis);
 	}
 
 	UnitVector2D ConvexHull::edge_normal(size_t i) const
@@ -106,6 +106,6 @@ namespace oly::col2d
 
 	ContactManifold ConvexHull::deepest_manifold(const UnitVector2D& axis) const
 	{
-		return internal::polygon_deepest_manifold(_points, axis, proj_cache);
+		return internal::polygon_deepest_manifold(_points, axis);
 	}
 }
@@ -15,7 +15,6 @@ namespace oly::col2d
 		std::vector<glm::vec2> _points;
 		mutable bool dirty_center = true;
 		mutable glm::vec2 _center{};
-		mutable internal::ProjectionCache proj_cache;
 
 	public:
 		ConvexHull(const std::vector<glm::vec2>& points = {}) : _points(points) {}
@@ -36,5 +35,7 @@ namespace oly::col2d
 		float projection_max(const UnitVector2D& axis) const;
 		UnitVector2D edge_normal(size_t i) const;
 		ContactManifold deepest_manifold(const UnitVector2D& axis) const;
+
+		void bake_caches() const { center(); }
 	};
 }
@@ -57,6 +57,25 @@ namespace oly::col2d
 #undef OLY_ELEMENT_PROJECTION_DEEPEST_MANIFOLD
 	}
 
+	void Element::bake_caches() const
+	{
+#define OLY_ELEMENT_BAKE_CACHES(p) p->bake_caches();
+		switch (id)
+		{
+			OLY_ELEMENT_IMPL_SWITCH_CASE(OLY_ELEMENT_BAKE_CACHES, ConvexHull);
+			OLY_ELEMENT_IMPL_SWITCH_CASE(OLY_ELEMENT_BAKE_CACHES, KDOP2);
+			OLY_ELEMENT_IMPL_SWITCH_CASE(OLY_ELEMENT_BAKE_CACHES, KDOP3);
+			OLY_ELEMENT_IMPL_SWITCH_CASE(OLY_ELEMENT_BAKE_CACHES, KDOP4);
+			OLY_ELEMENT_IMPL_SWITCH_CASE(OLY_ELEMENT_BAKE_CACHES, KDOP5);
+			OLY_ELEMENT_IMPL_SWITCH_CASE(OLY_ELEMENT_BAKE_CACHES, KDOP6);
+			OLY_ELEMENT_IMPL_SWITCH_CASE(OLY_ELEMENT_BAKE_CACHES, KDOP7);
+			OLY_ELEMENT_IMPL_SWITCH_CASE(OLY_ELEMENT_BAKE_CACHES, KDOP8);
+			default:
+				break;
+		}
+#undef OLY_ELEMENT_BAKE_CACHES
+	}
+
 	static bool only_translation_and_scale(const glm::mat3& m)
 	{
 		return (near_zero(m[0][1]) && near_zero(m[1][0])) || (near_zero(m[0][0]) && near_zero(m[1][1]));
@@ -141,6 +141,7 @@ namespace oly::col2d
 		fpair projection_interval(UnitVector2D axis) const;
 		ContactManifold deepest_manifold(UnitVector2D axis) const;
 		Element transformed(const glm::mat3& m) const;
+		void bake_caches() const;
 
 		using ConstElementVariant = Variant<
 			const Circle*,
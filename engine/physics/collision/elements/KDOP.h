@@ -163,12 +163,24 @@ namespace oly::col2d
 			return cache();
 		}
 
+		// all lazy caches are computed, including for empty k-DOPs, so that concurrent readers never write to them
+		void bake_caches() const
+		{
+			center();
+			clipped_extrema();
+		}
+
 	private:
 		const std::array<fpair, K>& clipped_extrema() const
 		{
 			if (dirty_clipped)
 			{
 				dirty_clipped = false;
+				if (cache().empty())
+				{
+					_clipped_extrema.fill({ nmax<float>(), -nmax<float>() });
+					return _clipped_extrema;
+				}
 				for (size_t i = 0; i < K; ++i)
 				{
 					fpair global_clipped_extrema = internal::polygon_projection_interval(cache(), edge_normal(i));
@@ -300,6 +312,11 @@ namespace oly::col2d
 				return c.global_offset;
 			}
 
+			static bool has_no_global(const KDOP<K>& c)
+			{
+				return c.global == glm::mat2(1.0f);
+			}
+
 			static KDOP<K> create_affine_kdop(const KDOP<K>& c, const glm::mat3x2& g)
 			{
 				KDOP<K> tc = c;
@@ -0,0 +1,303 @@
+#include "Batch.h"
+
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define _OLY_BATCH_SSE2
+#endif
+
+namespace oly::col2d::batch
+{
+	namespace internal
+	{
+		struct ScalarLanes
+		{
+			static constexpr size_t WIDTH = 1;
+			using V = float;
+			using M = bool;
+
+			static V load(const float* p) { return *p; }
+			static V set(float f) { return f; }
+			static V add(V a, V b) { return a + b; }
+			static V sub(V a, V b) { return a - b; }
+			static V mul(V a, V b) { return a * b; }
+			static V neg(V a) { return -a; }
+			static V abs(V a) { return glm::abs(a); }
+			static V min(V a, V b) { return b < a ? b : a; }
+			static V max(V a, V b) { return b > a ? b : a; }
+			static V select(M m, V a, V b) { return m ? a : b; }
+			static M lt(V a, V b) { return a < b; }
+			static M le(V a, V b) { return a <= b; }
+			static M both(M a, M b) { return a && b; }
+			static int bits(M m) { return m ? 1 : 0; }
+		};
+
+#if defined(__AVX2__)
+		struct SimdLanes
+		{
+			static constexpr size_t WIDTH = 8;
+			using V = __m256;
+			using M = __m256;
+
+			static V load(const float* p) { return _mm256_loadu_ps(p); }
+			static V set(float f) { return _mm256_set1_ps(f); }
+			static V add(V a, V b) { return _mm256_add_ps(a, b); }
+			static V sub(V a, V b) { return _mm256_sub_ps(a, b); }
+			static V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+			static V neg(V a) { return _mm256_xor_ps(_mm256_set1_ps(-0.0f), a); }
+			static V abs(V a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+			static V min(V a, V b) { return _mm256_min_ps(a, b); }
+			static V max(V a, V b) { return _mm256_max_ps(a, b); }
+			static V select(M m, V a, V b) { return _mm256_blendv_ps(b, a, m); }
+			static M lt(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+			static M le(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+			static M both(M a, M b) { return _mm256_and_ps(a, b); }
+			static int bits(M m) { return _mm256_movemask_ps(m); }
+		};
+#elif defined(_OLY_BATCH_SSE2)
+		struct SimdLanes
+		{
+			static constexpr size_t WIDTH = 4;
+			using V = __m128;
+			using M = __m128;
+
+			static V load(const float* p) { return _mm_loadu_ps(p); }
+			static V set(float f) { return _mm_set1_ps(f); }
+			static V add(V a, V b) { return _mm_add_ps(a, b); }
+			static V sub(V a, V b) { return _mm_sub_ps(a, b); }
+			static V mul(V a, V b) { return _mm_mul_ps(a, b); }
+			static V neg(V a) { return _mm_xor_ps(_mm_set1_ps(-0.0f), a); }
+			static V abs(V a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+			static V min(V a, V b) { return _mm_min_ps(a, b); }
+			static V max(V a, V b) { return _mm_max_ps(a, b); }
+			static V select(M m, V a, V b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+			static M lt(V a, V b) { return _mm_cmplt_ps(a, b); }
+			static M le(V a, V b) { return _mm_cmple_ps(a, b); }
+			static M both(M a, M b) { return _mm_and_ps(a, b); }
+			static int bits(M m) { return _mm_movemask_ps(m); }
+		};
+#else
+		using SimdLanes = ScalarLanes;
+#endif
+
+		// runs test over full SIMD lanes, then finishes the remainder one pair at a time
+		template<template<typename> typename Kernel, typename Pairs>
+		static void run(const Pairs& pairs, OverlapResult* results)
+		{
+			const size_t n = pairs.size();
+			size_t i = 0;
+			for (; i + SimdLanes::WIDTH <= n; i += SimdLanes::WIDTH)
+			{
+				const int bits = SimdLanes::bits(Kernel<SimdLanes>::test(pairs, i));
+				for (size_t j = 0; j < SimdLanes::WIDTH; ++j)
+					results[i + j] = ((bits >> j) & 1) != 0;
+			}
+			for (; i < n; ++i)
+				results[i] = Kernel<ScalarLanes>::test(pairs, i);
+		}
+
+		template<typename L>
+		struct CircleKernel
+		{
+			static typename L::M test(const CirclePairs& p, size_t i)
+			{
+				const typename L::V dx = L::sub(L::load(&p.x2[i]), L::load(&p.x1[i]));
+				const typename L::V dy = L::sub(L::load(&p.y2[i]), L::load(&p.y1[i]));
+				const typename L::V rsum = L::add(L::load(&p.r1[i]), L::load(&p.r2[i]));
+				return L::le(L::add(L::mul(dx, dx), L::mul(dy, dy)), L::mul(rsum, rsum));
+			}
+		};
+
+		template<typename L>
+		struct AABBKernel
+		{
+			static typename L::M test(const AABBPairs& p, size_t i)
+			{
+				const typename L::M x = L::both(L::le(L::load(&p.ax1[i]), L::load(&p.bx2[i])), L::le(L::load(&p.bx1[i]), L::load(&p.ax2[i])));
+				const typename L::M y = L::both(L::le(L::load(&p.ay1[i]), L::load(&p.by2[i])), L::le(L::load(&p.by1[i]), L::load(&p.ay2[i])));
+				return L::both(x, y);
+			}
+		};
+
+		// largest float that near_zero() accepts, since it compares against the tolerance in double precision
+		static const float NEAR_ZERO_BOUND = (double)(float)LINEAR_TOLERANCE <= LINEAR_TOLERANCE ? (float)LINEAR_TOLERANCE
+			: std::nextafter((float)LINEAR_TOLERANCE, 0.0f);
+
+		// Mirrors sat::overlaps() for two OBBs operation for operation, so that touching pairs resolve the same way: an axis overlaps only
+		// if the projection intervals overlap strictly, and the other box is projected as OBB::projection_interval() projects it.
+		template<typename L>
+		struct OBBKernel
+		{
+			using V = typename L::V;
+			using M = typename L::M;
+
+			struct Box
+			{
+				V cx, cy, ux, uy, hw, hh;
+				V px[4], py[4];
+			};
+
+			static Box load(const std::vector<float>& cx, const std::vector<float>& cy, const std::vector<float>& ux, const std::vector<float>& uy,
+				const std::vector<float>& hw, const std::vector<float>& hh, const std::array<std::vector<float>, 4>& px,
+				const std::array<std::vector<float>, 4>& py, size_t i)
+			{
+				Box b{ L::load(&cx[i]), L::load(&cy[i]), L::load(&ux[i]), L::load(&uy[i]), L::load(&hw[i]), L::load(&hh[i]) };
+				for (size_t k = 0; k < 4; ++k)
+				{
+					b.px[k] = L::load(&px[k][i]);
+					b.py[k] = L::load(&py[k][i]);
+				}
+				return b;
+			}
+
+			// in the same order as UnitVector2D::dot()
+			static V dot(V x, V y, V ax, V ay)
+			{
+				return L::add(L::mul(x, ax), L::mul(y, ay));
+			}
+
+			static M axis_overlaps(V center, V half, const Box& other, V ax, V ay)
+			{
+				const V tolerance = L::set(NEAR_ZERO_BOUND);
+				const M along_major = L::le(L::abs(L::sub(L::mul(other.ux, ay), L::mul(other.uy, ax))), tolerance);
+				const M along_minor = L::le(L::abs(L::sub(L::mul(L::neg(other.uy), ay), L::mul(other.ux, ax))), tolerance);
+
+				V min2 = dot(other.px[0], other.py[0], ax, ay);
+				V max2 = min2;
+				for (size_t k = 1; k < 4; ++k)
+				{
+					const V d = dot(other.px[k], other.py[k], ax, ay);
+					min2 = L::min(min2, d);
+					max2 = L::max(max2, d);
+				}
+				const V m = dot(other.cx, other.cy, ax, ay);
+				min2 = L::select(along_major, L::sub(m, other.hw), L::select(along_minor, L::sub(m, other.hh), min2));
+				max2 = L::select(along_major, L::add(m, other.hw), L::select(along_minor, L::add(m, other.hh), max2));
+
+				return L::both(L::lt(L::sub(center, half), max2), L::lt(min2, L::add(center, half)));
+			}
+
+			// the major axis of one box and its quarter turn, against the other box
+			static M box_overlaps(const Box& b, const Box& other)
+			{
+				const V minor_x = L::neg(b.uy);
+				const M major = axis_overlaps(dot(b.cx, b.cy, b.ux, b.uy), b.hw, other, b.ux, b.uy);
+				const M minor = axis_overlaps(dot(b.cx, b.cy, minor_x, b.ux), b.hh, other, minor_x, b.ux);
+				return L::both(major, minor);
+			}
+
+			static M test(const OBBPairs& p, size_t i)
+			{
+				const Box b1 = load(p.cx1, p.cy1, p.ux1, p.uy1, p.hw1, p.hh1, p.px1, p.py1, i);
+				const Box b2 = load(p.cx2, p.cy2, p.ux2, p.uy2, p.hw2, p.hh2, p.px2, p.py2, i);
+				return L::both(box_overlaps(b1, b2), box_overlaps(b2, b1));
+			}
+		};
+
+		template<size_t K>
+		struct KDOPKernelOf
+		{
+			template<typename L>
+			struct Kernel
+			{
+				static typename L::M test(const KDOPPairs<K>& p, size_t i)
+				{
+					typename L::M m = L::both(L::le(L::load(&p.min1[0][i]), L::load(&p.max2[0][i])), L::le(L::load(&p.min2[0][i]), L::load(&p.max1[0][i])));
+					for (size_t k = 1; k < K; ++k)
+						m = L::both(m, L::both(L::le(L::load(&p.min1[k][i]), L::load(&p.max2[k][i])), L::le(L::load(&p.min2[k][i]), L::load(&p.max1[k][i]))));
+					return m;
+				}
+			};
+		};
+	}
+
+	void CirclePairs::clear()
+	{
+		x1.clear(); y1.clear(); r1.clear();
+		x2.clear(); y2.clear(); r2.clear();
+	}
+
+	bool CirclePairs::push(const Circle& c1, const Circle& c2)
+	{
+		if (!col2d::internal::CircleGlobalAccess::has_no_global(c1) || !col2d::internal::CircleGlobalAccess::has_no_global(c2))
+			return false;
+
+		const glm::vec2 center1 = col2d::internal::CircleGlobalAccess::global_center(c1);
+		const glm::vec2 center2 = col2d::internal::CircleGlobalAccess::global_center(c2);
+		x1.push_back(center1.x); y1.push_back(center1.y); r1.push_back(c1.radius);
+		x2.push_back(center2.x); y2.push_back(center2.y); r2.push_back(c2.radius);
+		return true;
+	}
+
+	void AABBPairs::clear()
+	{
+		ax1.clear(); ax2.clear(); ay1.clear(); ay2.clear();
+		bx1.clear(); bx2.clear(); by1.clear(); by2.clear();
+	}
+
+	bool AABBPairs::push(const AABB& c1, const AABB& c2)
+	{
+		ax1.push_back(c1.x1); ax2.push_back(c1.x2); ay1.push_back(c1.y1); ay2.push_back(c1.y2);
+		bx1.push_back(c2.x1); bx2.push_back(c2.x2); by1.push_back(c2.y1); by2.push_back(c2.y2);
+		return true;
+	}
+
+	void OBBPairs::clear()
+	{
+		cx1.clear(); cy1.clear(); ux1.clear(); uy1.clear(); hw1.clear(); hh1.clear();
+		cx2.clear(); cy2.clear(); ux2.clear(); uy2.clear(); hw2.clear(); hh2.clear();
+		for (size_t k = 0; k < 4; ++k)
+		{
+			px1[k].clear(); py1[k].clear();
+			px2[k].clear(); py2[k].clear();
+		}
+	}
+
+	bool OBBPairs::push(const OBB& c1, const OBB& c2)
+	{
+		const UnitVector2D u1 = c1.get_major_axis();
+		const UnitVector2D u2 = c2.get_major_axis();
+		cx1.push_back(c1.center.x); cy1.push_back(c1.center.y); ux1.push_back(u1.x()); uy1.push_back(u1.y()); hw1.push_back(0.5f * c1.width); hh1.push_back(0.5f * c1.height);
+		cx2.push_back(c2.center.x); cy2.push_back(c2.center.y); ux2.push_back(u2.x()); uy2.push_back(u2.y()); hw2.push_back(0.5f * c2.width); hh2.push_back(0.5f * c2.height);
+		const std::array<glm::vec2, 4> points1 = c1.points();
+		const std::array<glm::vec2, 4> points2 = c2.points();
+		for (size_t k = 0; k < 4; ++k)
+		{
+			px1[k].push_back(points1[k].x); py1[k].push_back(points1[k].y);
+			px2[k].push_back(points2[k].x); py2[k].push_back(points2[k].y);
+		}
+		return true;
+	}
+
+	void overlaps(const CirclePairs& pairs, OverlapResult* results)
+	{
+		internal::run<internal::CircleKernel>(pairs, results);
+	}
+
+	void overlaps(const AABBPairs& pairs, OverlapResult* results)
+	{
+		internal::run<internal::AABBKernel>(pairs, results);
+	}
+
+	void overlaps(const OBBPairs& pairs, OverlapResult* results)
+	{
+		internal::run<internal::OBBKernel>(pairs, results);
+	}
+
+	template<size_t K>
+	void overlaps(const KDOPPairs<K>& pairs, OverlapResult* results)
+	{
+		internal::run<internal::KDOPKernelOf<K>::template Kernel>(pairs, results);
+	}
+
+	template void overlaps<2>(const KDOPPairs<2>&, OverlapResult*);
+	template void overlaps<3>(const KDOPPairs<3>&, OverlapResult*);
+	template void overlaps<4>(const KDOPPairs<4>&, OverlapResult*);
+	template void overlaps<5>(const KDOPPairs<5>&, OverlapResult*);
+	template void overlaps<6>(const KDOPPairs<6>&, OverlapResult*);
+	template void overlaps<7>(const KDOPPairs<7>&, OverlapResult*);
+	template void overlaps<8>(const KDOPPairs<8>&, OverlapResult*);
+}
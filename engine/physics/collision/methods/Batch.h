@@ -0,0 +1,91 @@
+#pragma once
+
+#include "physics/collision/elements/Circle.h"
+#include "physics/collision/elements/AABB.h"
+#include "physics/collision/elements/OBB.h"
+#include "physics/collision/elements/KDOP.h"
+#include "physics/collision/methods/CollisionInfo.h"
+
+#include <vector>
+#include <array>
+
+namespace oly::col2d::batch
+{
+	// Overlap tests over many pairs of the same element types at once. Pairs are stored as structure-of-arrays and tested with AVX2 when
+	// compiled with OLYMPIAN_ENABLE_AVX2, with SSE2 otherwise on x86, and with a scalar loop elsewhere.
+	// Results match the single-pair overlaps() for the shapes that each batch accepts.
+
+	struct CirclePairs
+	{
+		std::vector<float> x1, y1, r1, x2, y2, r2;
+
+		size_t size() const { return x1.size(); }
+		void clear();
+		// only circles without a global transform are accepted
+		bool push(const Circle& c1, const Circle& c2);
+	};
+
+	struct AABBPairs
+	{
+		std::vector<float> ax1, ax2, ay1, ay2, bx1, bx2, by1, by2;
+
+		size_t size() const { return ax1.size(); }
+		void clear();
+		bool push(const AABB& c1, const AABB& c2);
+	};
+
+	// Corners are stored alongside the axes, so that each box is projected exactly as the single-pair SAT projects it.
+	struct OBBPairs
+	{
+		std::vector<float> cx1, cy1, ux1, uy1, hw1, hh1, cx2, cy2, ux2, uy2, hw2, hh2;
+		std::array<std::vector<float>, 4> px1, py1, px2, py2;
+
+		size_t size() const { return cx1.size(); }
+		void clear();
+		bool push(const OBB& c1, const OBB& c2);
+	};
+
+	template<size_t K>
+	struct KDOPPairs
+	{
+		std::array<std::vector<float>, K> min1, max1, min2, max2;
+
+		size_t size() const { return min1[0].size(); }
+
+		void clear()
+		{
+			for (size_t i = 0; i < K; ++i)
+			{
+				min1[i].clear();
+				max1[i].clear();
+				min2[i].clear();
+				max2[i].clear();
+			}
+		}
+
+		// only kDOPs whose global transform is at most a translation are accepted
+		bool push(const KDOP<K>& c1, const KDOP<K>& c2)
+		{
+			if (!col2d::internal::KDOPGlobalAccess<K>::has_no_global(c1) || !col2d::internal::KDOPGlobalAccess<K>::has_no_global(c2))
+				return false;
+
+			const glm::vec2 offset1 = col2d::internal::KDOPGlobalAccess<K>::get_global_offset(c1);
+			const glm::vec2 offset2 = col2d::internal::KDOPGlobalAccess<K>::get_global_offset(c2);
+			for (size_t i = 0; i < K; ++i)
+			{
+				const UnitVector2D axis = KDOP<K>::uniform_axis(i);
+				min1[i].push_back(c1.get_clipped_minimum(i) + axis.dot(offset1));
+				max1[i].push_back(c1.get_clipped_maximum(i) + axis.dot(offset1));
+				min2[i].push_back(c2.get_clipped_minimum(i) + axis.dot(offset2));
+				max2[i].push_back(c2.get_clipped_maximum(i) + axis.dot(offset2));
+			}
+			return true;
+		}
+	};
+
+	extern void overlaps(const CirclePairs& pairs, OverlapResult* results);
+	extern void overlaps(const AABBPairs& pairs, OverlapResult* results);
+	extern void overlaps(const OBBPairs& pairs, OverlapResult* results);
+	template<size_t K>
+	extern void overlaps(const KDOPPairs<K>& pairs, OverlapResult* results);
+}
@@ -19,7 +19,59 @@ namespace oly::col2d::gjk
 		return c1.deepest_manifold(axis).pt() - c2.deepest_manifold(-axis).pt();
 	}
 
-	inline bool handle_simplex(std::vector<glm::vec2>& simplex, UnitVector2D& axis)
+	// GJK simplex in 2D never exceeds a triangle, so it is kept on the stack
+	struct Simplex
+	{
+		glm::vec2 points[3];
+		size_t count = 0;
+
+		size_t size() const { return count; }
+		void push_back(glm::vec2 p) { points[count++] = p; }
+		glm::vec2 back() const { return points[count - 1]; }
+		glm::vec2 operator[](size_t i) const { return points[i]; }
+
+		void erase(size_t i)
+		{
+			for (size_t j = i; j + 1 < count; ++j)
+				points[j] = points[j + 1];
+			--count;
+		}
+	};
+
+	// EPA polytope, kept on the stack until it outgrows INLINE_CAPACITY points
+	struct Polytope
+	{
+		static constexpr size_t INLINE_CAPACITY = 32;
+
+		glm::vec2 inline_points[INLINE_CAPACITY];
+		std::vector<glm::vec2> spilled;
+		size_t count = 0;
+
+		size_t size() const { return count; }
+		glm::vec2 operator[](size_t i) const { return spilled.empty() ? inline_points[i] : spilled[i]; }
+		void push_back(glm::vec2 p) { insert(count, p); }
+
+		void insert(size_t i, glm::vec2 p)
+		{
+			if (count == INLINE_CAPACITY && spilled.empty())
+			{
+				spilled.reserve(2 * INLINE_CAPACITY);
+				spilled.assign(inline_points, inline_points + count);
+			}
+
+			if (spilled.empty())
+			{
+				for (size_t j = count; j > i; --j)
+					inline_points[j] = inline_points[j - 1];
+				inline_points[i] = p;
+			}
+			else
+				spilled.insert(spilled.begin() + i, p);
+			++count;
+		}
+	};
+
+	inline bool handle_simplex(Simplex& simplex, UnitVector2D& axis)
 	{
 		if (simplex.size() == 2)
 		{
@@ -45,7 +97,7 @@ namespace oly::col2d::gjk
 			if (glm::dot(ab_ortho, -a) > 0.0f)
 			{
 				// remove c
-				simplex.erase(simplex.begin());
+				simplex.erase(0);
 				axis = ab_ortho;
 				return false;
 			}
@@ -54,7 +106,7 @@ namespace oly::col2d::gjk
 			if (glm::dot(ac_ortho, -a) > 0.0f)
 			{
 				// remove b
-				simplex.erase(simplex.begin() + 1);
+				simplex.erase(1);
 				axis = ac_ortho;
 				return false;
 			}
@@ -69,7 +121,7 @@ namespace oly::col2d::gjk
 	inline OverlapResult overlaps(const Shape1& c1, const Shape2& c2, size_t max_iterations = 20)
 	{
 		UnitVector2D axis;
-		std::vector<glm::vec2> simplex;
+		Simplex simplex;
 		simplex.push_back(support(c1, c2, axis));
 		axis = -simplex.back();
 
@@ -92,7 +144,7 @@ namespace oly::col2d::gjk
 	inline CollisionResult collides(const Shape1& c1, const Shape2& c2, size_t gjk_max_iterations = 20, size_t epa_max_iterations = 64, float epa_epsilon = LINEAR_TOLERANCE)
 	{
 		UnitVector2D axis;
-		std::vector<glm::vec2> simplex;
+		Simplex simplex;
 		simplex.push_back(support(c1, c2, axis));
 		axis = -simplex.back();
 		bool intersecting = false;
@@ -125,7 +177,7 @@ namespace oly::col2d::gjk
 			UnitVector2D normal;
 		};
 
-		static const auto find_closest_edge = [](const std::vector<glm::vec2>& polygon) -> Edge {
+		static const auto find_closest_edge = [](const Polytope& polygon) -> Edge {
 			float min_dist = nmax<float>();
 			Edge closest{};
 			for (size_t i = 0; i < polygon.size(); ++i)
@@ -144,16 +196,20 @@ namespace oly::col2d::gjk
 			return closest;
 			};
 
+		Polytope polytope;
+		for (size_t i = 0; i < simplex.size(); ++i)
+			polytope.push_back(simplex[i]);
+
 		for (size_t i = 0; i < epa_max_iterations; ++i)
 		{
-			Edge edge = find_closest_edge(simplex);
+			Edge edge = find_closest_edge(polytope);
 			glm::vec2 p = support(c1, c2, edge.normal);
 			float d = edge.normal.dot(p);
 
 			if (oly::near_zero(d - edge.distance, epa_epsilon))
 				return { .overlap = true, .penetration_depth = d, .unit_impulse = -edge.normal };
 
-			simplex.insert(simplex.begin() + edge.index + 1, p);
+			polytope.insert(edge.index + 1, p);
 		}
 
 		_OLY_ENGINE_LOG_WARNING("COL2D") << "EPA overflow" << LOG.nl;
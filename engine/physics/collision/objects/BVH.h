@@ -270,7 +270,25 @@ namespace oly::col2d
 
 		const Shape& root_shape() const { return *root().shape; }
 
+		void bake_caches() const
+		{
+			bake_caches(root());
+			for (const Element& element : elements)
+				element.bake_caches();
+		}
+
 	private:
+		static void bake_caches(const Node& node)
+		{
+			if (node.is_leaf())
+				return;
+
+			if constexpr (requires (const Shape& shape) { shape.bake_caches(); })
+				node.shape->bake_caches();
+			bake_caches(*node.left);
+			bake_caches(*node.right);
+		}
+
 		const Node& root() const
 		{
 			if (dirty)
@@ -571,6 +589,7 @@ namespace oly::col2d
 		const std::vector<Element>& get_baked() const { return bvh().get_elements(); }
 
 		const Shape& root_shape() const { return bvh().root_shape(); }
+		void bake_caches() const { bvh().bake_caches(); }
 
 		Mask mask() const { return _bvh.mask; }
 		Mask& mask() { return _bvh.mask; }
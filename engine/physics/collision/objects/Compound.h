@@ -63,6 +63,7 @@ namespace oly::col2d
 		const Compound& get_compound() const { return compound; }
 		Compound& set_compound() { dirty = true; return compound; }
 		const std::vector<Element>& get_baked() const { if (dirty || transformer.flush()) { bake(); } return baked; }
+		void bake_caches() const { for (const Element& element : get_baked()) element.bake_caches(); }
 
 		Mask mask() const { return compound.mask; }
 		Mask& mask() { return compound.mask; }
@@ -75,6 +75,7 @@ namespace oly::col2d
 		const Primitive& get_primitive() const { return primitive; }
 		Primitive& set_primitive() { dirty = true; return primitive; }
 		const Element& get_baked() const { if (dirty || transformer.flush()) { bake(); } return baked; }
+		void bake_caches() const { get_baked().bake_caches(); }
 
 		Mask mask() const { return primitive.mask; }
 		Mask& mask() { return primitive.mask; }
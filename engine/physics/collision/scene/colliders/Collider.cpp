@@ -6,12 +6,14 @@
 namespace oly::col2d
 {
 	Collider::Collider(const Collider& other)
-		: obj(other.obj), handles(*this, other.handles), dirty(other.dirty), dispatch_handle(*this, other.dispatch_handle), quad_wrap(other.quad_wrap)
+		: obj(other.obj), handles(*this, other.handles), dirty(other.dirty), dispatch_handle(*this, other.dispatch_handle), quad_wrap(other.quad_wrap),
+		resting(other.resting)
 	{
 	}
 
 	Collider::Collider(Collider&& other) noexcept
-		: obj(std::move(other.obj)), handles(*this, std::move(other.handles)), dirty(other.dirty), dispatch_handle(*this, std::move(other.dispatch_handle)), quad_wrap(other.quad_wrap)
+		: obj(std::move(other.obj)), handles(*this, std::move(other.handles)), dirty(other.dirty), dispatch_handle(*this, std::move(other.dispatch_handle)),
+		quad_wrap(other.quad_wrap), resting(other.resting)
 	{
 	}
 
@@ -21,8 +23,10 @@ namespace oly::col2d
 		{
 			obj = other.obj;
 			dirty = other.dirty;
+			++modifications;
 			dispatch_handle = other.dispatch_handle;
 			quad_wrap = other.quad_wrap;
+			resting = other.resting;
 			handles = other.handles;
 		}
 		return *this;
@@ -34,8 +38,10 @@ namespace oly::col2d
 		{
 			obj = std::move(other.obj);
 			dirty = other.dirty;
+			++modifications;
 			dispatch_handle = std::move(other.dispatch_handle);
 			quad_wrap = other.quad_wrap;
+			resting = other.resting;
 			handles = std::move(other.handles);
 		}
 		return *this;
@@ -52,7 +58,8 @@ namespace oly::col2d
 			return;
 
 		dirty = false;
-		internal::lut_flush(obj);
+		++modifications;
+		quad_wrap = internal::lut_flush(obj);
 		handles.flush();
 	}
 }
@@ -8,6 +8,7 @@
 #include "physics/collision/scene/luts/LUTVariant.h"
 
 namespace oly::physics { class RigidBody; };
+namespace oly::col2d::internal { class BroadPhase; };
 
 namespace oly::col2d
 {
@@ -15,14 +16,19 @@ namespace oly::col2d
 	{
 		friend class CollisionTree;
 		friend class internal::CollisionNode;
+		friend class CollisionDispatcher;
+		friend class internal::BroadPhase;
 
 	private:
 		internal::ColliderObject obj;
 
 		mutable bool dirty = true;
+		// bumped whenever the collider is flushed or assigned, so that a modification is noticed even after it has been flushed
+		mutable unsigned long long modifications = 0;
 
 		friend class physics::RigidBody;
 		physics::RigidBody* rigid_body = nullptr;
+		bool resting = false;
 
 		internal::ColliderDispatchHandle dispatch_handle;
 
@@ -44,19 +50,20 @@ namespace oly::col2d
 		template<internal::ColliderObjectShape CObj>
 		const CObj& get() const { return obj.get<CObj>(); }
 		template<internal::ColliderObjectShape CObj>
-		CObj& set() { dirty = true; return obj.set<CObj>(); }
-		void emplace(internal::ColliderObject&& obj) { dirty = true; this->obj = std::move(obj); }
+		CObj& set() { flag(); return obj.set<CObj>(); }
+		void emplace(internal::ColliderObject&& obj) { flag(); this->obj = std::move(obj); }
 		template<internal::ColliderObjectShape CObj>
-		void emplace(CObj&& obj) { dirty = true; this->obj = internal::ColliderObject(std::forward<CObj>(obj)); }
+		void emplace(CObj&& obj) { flag(); this->obj = internal::ColliderObject(std::forward<CObj>(obj)); }
 
-		void flag() { dirty = true; }
+		// marks the collider for flushing, and tells broad phases that skip flushing it, such as for colliders of static bodies
+		void flag() { dirty = true; handles.touch(); }
 
 		const Transform2D& get_local() const { return internal::lut_transformer(obj).get_local(); }
-		Transform2D& set_local() { return internal::lut_transformer(obj).set_local(); }
+		Transform2D& set_local() { handles.touch(); return internal::lut_transformer(obj).set_local(); }
 
 		Transformer2DConstExposure get_transformer() const { return internal::lut_transformer(obj); }
 		Transformer2DExposure<TExposureParams{ .local = exposure::local::Full, .chain = exposure::chain::Full, .modifier = exposure::modifier::Full }>
-			set_transformer() { return internal::lut_transformer(obj); }
+			set_transformer() { handles.touch(); return internal::lut_transformer(obj); }
 
 		Layer layer() const { return internal::lut_layer(obj); }
 		Layer& layer() { return internal::lut_layer(obj); }
@@ -66,9 +73,14 @@ namespace oly::col2d
 		std::optional<UnitVector2D> one_way_blocking;
 		bool one_way_blocks(const Collider& active) const;
 
+		// pairs of resting colliders, such as those of sleeping rigid bodies, are skipped by the collision dispatcher
+		bool is_resting() const { return resting; }
+
 	private:
 		bool is_dirty() const { return dirty || internal::lut_is_dirty(obj); }
+		unsigned long long modification_count() const { return modifications; }
 		void flush() const;
+		void bake_caches() const { internal::lut_bake_caches(obj); }
 
 	public:
 		OverlapResult point_hits(glm::vec2 test) const { return internal::lut_point_hits(obj, test); }
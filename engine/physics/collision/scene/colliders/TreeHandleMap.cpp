@@ -10,16 +10,24 @@ namespace oly::col2d::internal
 		: collider(collider), handles(other.handles)
 	{
 		for (auto& [tree, node] : handles)
-			if (node)
+		{
+			if (tree->broad_phase)
+				tree->broad_phase_insert(collider);
+			else if (node)
 				node->set_colliders().insert(&collider);
+		}
 	}
 
 	TreeHandleMap::TreeHandleMap(Collider& collider, TreeHandleMap&& other) noexcept
 		: collider(collider), handles(std::move(other.handles))
 	{
 		for (auto& [tree, node] : handles)
-			if (node)
+		{
+			if (tree->broad_phase)
+				tree->broad_phase_replace(other.collider, collider);
+			else if (node)
 				node->set_colliders().replace(&other.collider, &collider);
+		}
 	}
 
 	TreeHandleMap::~TreeHandleMap()
@@ -36,14 +44,22 @@ namespace oly::col2d::internal
 				if (other.handles.count(it->key))
 					++it;
 				else
+				{
+					if (it->key->broad_phase)
+						it->key->broad_phase_erase(collider);
+					else if (it->value)
+						it->value->set_colliders().erase(&collider);
 					it = handles.erase(it);
+				}
 			}
 
 			for (auto it = other.handles.begin(); it != other.handles.end(); ++it)
 			{
 				if (!handles.count(it->key))
 				{
-					if (it->value)
+					if (it->key->broad_phase)
+						it->key->broad_phase_insert(collider);
+					else if (it->value)
 						it->value->set_colliders().insert(&collider);
 					handles.insert(it->key, it->value);
 				}
@@ -59,8 +75,12 @@ namespace oly::col2d::internal
 			clear();
 			handles = std::move(other.handles);
 			for (auto& [tree, node] : handles)
-				if (node)
+			{
+				if (tree->broad_phase)
+					tree->broad_phase_replace(other.collider, collider);
+				else if (node)
 					node->set_colliders().replace(&other.collider, &collider);
+			}
 		}
 		return *this;
 	}
@@ -69,7 +89,9 @@ namespace oly::col2d::internal
 	{
 		for (auto& [tree, node] : handles)
 		{
-			if (node)
+			if (tree->broad_phase)
+				continue;
+			else if (node)
 				node->update(collider, node);
 			else
 			{
@@ -83,8 +105,16 @@ namespace oly::col2d::internal
 	{
 		if (!handles.count(&tree))
 		{
-			tree.root->set_colliders().insert(&collider);
-			handles.insert(&tree, tree.root.get());
+			if (tree.broad_phase)
+			{
+				tree.broad_phase_insert(collider);
+				handles.insert(&tree, nullptr);
+			}
+			else
+			{
+				tree.root->set_colliders().insert(&collider);
+				handles.insert(&tree, tree.root.get());
+			}
 		}
 	}
 
@@ -98,7 +128,9 @@ namespace oly::col2d::internal
 		auto it = handles.find(&tree);
 		if (it != handles.end())
 		{
-			if (it->value)
+			if (tree.broad_phase)
+				tree.broad_phase_erase(collider);
+			else if (it->value)
 				it->value->set_colliders().erase(&collider);
 			handles.erase(it);
 		}
@@ -114,11 +146,22 @@ namespace oly::col2d::internal
 		return is_attached(CollisionDispatcher::instance().get_tree(context_tree_index));
 	}
 
+	void TreeHandleMap::touch() const
+	{
+		for (auto& [tree, node] : handles)
+			if (tree->broad_phase)
+				tree->broad_phase_touch(collider);
+	}
+
 	void TreeHandleMap::clear()
 	{
 		for (auto& [tree, node] : handles)
-			if (node)
+		{
+			if (tree->broad_phase)
+				tree->broad_phase_erase(collider);
+			else if (node)
 				node->set_colliders().erase(&collider);
+		}
 		handles.clear();
 	}
 }
\ No newline at end of file
@@ -43,6 +43,8 @@ namespace oly::col2d::internal
 		bool is_attached(const CollisionTree& tree) const { return handles.count(&tree); }
 		bool is_attached(size_t context_tree_index = 0) const;
 		void clear();
+		// tells the broad phases of attached trees that the collider may have moved, for colliders of static bodies which they don't flush otherwise
+		void touch() const;
 		size_t size() const { return handles.size(); }
 	};
 }
@@ -0,0 +1,22 @@
+#include "BroadPhase.h"
+
+#include "physics/collision/scene/colliders/Collider.h"
+#include "physics/dynamics/bodies/RigidBody.h"
+
+namespace oly::col2d::internal
+{
+	void BroadPhase::flush_collider(const Collider& collider)
+	{
+		collider.flush();
+	}
+
+	math::Rect2D BroadPhase::collider_bounds(const Collider& collider)
+	{
+		return collider.quad_wrap;
+	}
+
+	bool BroadPhase::collider_is_static(const Collider& collider)
+	{
+		return collider.rigid_body && collider.rigid_body->is_static();
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "core/math/Shapes.h"
+
+#include <vector>
+#include <memory>
+
+namespace oly::col2d
+{
+	class Collider;
+
+	namespace internal
+	{
+		// Spatial index that backs a CollisionTree in place of the linked quadtree.
+		// Implementations own the set of attached colliders and flush them during flush().
+		class BroadPhase
+		{
+		public:
+			struct Pair
+			{
+				const Collider* first = nullptr;
+				const Collider* second = nullptr;
+			};
+
+			virtual ~BroadPhase() = default;
+
+			virtual std::unique_ptr<BroadPhase> clone_empty() const = 0;
+
+			virtual void insert(const Collider& collider) = 0;
+			virtual void erase(const Collider& collider) = 0;
+			virtual void replace(const Collider& at, const Collider& with) = 0;
+			// Implementations may skip colliders they expect to stay in place, such as those of static bodies, when flushing. touch() tells them
+			// that such a collider may have moved. Colliders touch their trees when their shape or local transform is modified, and static
+			// bodies touch their colliders when they move.
+			virtual void touch(const Collider& collider) {}
+
+			// returns whether the index changed
+			virtual bool flush() = 0;
+			virtual void set_bounds(math::Rect2D bounds) {}
+
+			virtual void get_colliders(std::vector<const Collider*>& colliders) const = 0;
+			virtual void query(math::Rect2D bounds, std::vector<const Collider*>& colliders) = 0;
+			virtual const std::vector<Pair>& pairs() = 0;
+
+		protected:
+			static void flush_collider(const Collider& collider);
+			static math::Rect2D collider_bounds(const Collider& collider);
+			static bool collider_is_static(const Collider& collider);
+		};
+	}
+}
@@ -1,5 +1,9 @@
 #include "CollisionDispatcher.h"
 
+#include "core/util/WorkerPool.h"
+#include "core/util/Time.h"
+#include "core/util/AllocationCounter.h"
+
 namespace oly::col2d
 {
 	Logger::Impl operator<<(Logger::Impl log, Phase phase)
@@ -40,13 +44,14 @@ namespace oly::col2d
 	
 	void internal::CollisionPhaseTracker::lazy_update_phase(const Collider& c1, const Collider& c2, Phase phase)
 	{
-		lazy_updates[{ &c1, &c2 }] = phase;
+		lazy_updates.push_back({ .c1 = &c1, .c2 = &c2, .phase = phase });
 	}
 	
 	void internal::CollisionPhaseTracker::flush()
 	{
-		for (const auto& [pair, phase] : lazy_updates)
-			map.set(pair, phase);
+		// updates are applied in order, so the latest update of a pair wins
+		for (const LazyUpdate& update : lazy_updates)
+			map.set(*update.c1, *update.c2, update.phase);
 		lazy_updates.clear();
 	}
 	
@@ -117,9 +122,9 @@ namespace oly::col2d
 		contacts.erase_all(c);
 	}
 
-	template<typename Result, typename EventData, typename HandlerRef>
-	static void dispatch(const Collider& c1, const Collider& c2, std::unordered_map<const Collider*, HandlerRef>& handlers,
-		Result(Collider::*method)(const Collider&) const, internal::CollisionPhaseTracker& phase_tracker, internal::CollisionCache& cache)
+	template<typename Result, typename EventData, typename HandlerRef, typename Compute>
+	static void dispatch_with(const Collider& c1, const Collider& c2, std::unordered_map<const Collider*, HandlerRef>& handlers,
+		Compute compute, internal::CollisionPhaseTracker& phase_tracker, internal::CollisionCache& cache)
 	{
 		auto it_1 = handlers.find(&c1);
 		auto it_2 = handlers.find(&c2);
@@ -127,19 +132,17 @@ namespace oly::col2d
 		if (it_1 == handlers.end() && it_2 == handlers.end())
 			return;
 
-		EventData* data = nullptr;
-		if (const std::optional<EventData>& d = cache.get<EventData>(c1, c2))
-			data = new EventData(*d);
-		else
+		std::optional<EventData> data = cache.get<EventData>(c1, c2);
+		if (!data)
 		{
 			if (!c1.one_way_blocks(c2) || !c2.one_way_blocks(c1))
-				data = new EventData(Result(), c1, c2, phase_tracker.prior_phase(c1, c2));
+				data.emplace(Result(), c1, c2, phase_tracker.prior_phase(c1, c2));
 			else
-				data = new EventData((c1.*method)(c2), c1, c2, phase_tracker.prior_phase(c1, c2));
+				data.emplace(compute(), c1, c2, phase_tracker.prior_phase(c1, c2));
 			cache.update(c1, c2, *data);
 		}
 
-		EventData& data1 = *data;
+		const EventData& data1 = *data;
 		phase_tracker.lazy_update_phase(c1, c2, data1.phase);
 		if (data1.phase != Phase::Expired)
 		{
@@ -154,13 +157,24 @@ namespace oly::col2d
 					handler->invoke(data2);
 			}
 		}
+	}
+
+	template<typename Result, typename EventData, typename HandlerRef>
+	static void dispatch(const Collider& c1, const Collider& c2, std::unordered_map<const Collider*, HandlerRef>& handlers,
+		Result(Collider::*method)(const Collider&) const, internal::CollisionPhaseTracker& phase_tracker, internal::CollisionCache& cache)
+	{
+		dispatch_with<Result, EventData>(c1, c2, handlers, [&c1, &c2, method]() { return (c1.*method)(c2); }, phase_tracker, cache);
+	}
 
-		delete data;
+	size_t CollisionDispatcher::add_tree(const math::Rect2D bounds, const glm::uvec2 degree, const size_t cell_capacity, const TreeLayout layout)
+	{
+		trees.emplace_back(bounds, degree, cell_capacity, layout);
+		return trees.size() - 1;
 	}
 
-	size_t CollisionDispatcher::add_tree(const math::Rect2D bounds, const glm::uvec2 degree, const size_t cell_capacity)
+	size_t CollisionDispatcher::add_tree(const TreeLayout layout, const float aabb_margin)
 	{
-		trees.emplace_back(bounds, degree, cell_capacity);
+		trees.emplace_back(layout, aabb_margin);
 		return trees.size() - 1;
 	}
 
@@ -220,20 +234,271 @@ namespace oly::col2d
 
 	void CollisionDispatcher::on_tick()
 	{
+		const size_t allocations = alloc::count();
 		collision_cache.clear();
 		phase_tracker.flush();
+		if (parallel_dispatch.enable)
+			parallel_tick();
+		else
+			serial_tick();
+		tick_allocations += alloc::count() - allocations;
+	}
+
+	void CollisionDispatcher::serial_tick()
+	{
+		Stopwatch stopwatch;
+		double narrow_phase = 0.0;
 		for (const CollisionTree& tree : trees)
 		{
 			tree.flush();
+			if (profiling)
+				profile.tree_flush += stopwatch.lap();
+
 			auto it = tree.iterator();
 			while (!it.done())
 			{
 				auto pair = it.next();
-				dispatch<ContactResult, ContactEventData>(*pair.first, *pair.second, contact_handler_map, &Collider::contacts, phase_tracker, collision_cache);
-				dispatch<CollisionResult, CollisionEventData>(*pair.first, *pair.second, collision_handler_map, &Collider::collides, phase_tracker, collision_cache);
-				dispatch<OverlapResult, OverlapEventData>(*pair.first, *pair.second, overlap_handler_map, &Collider::overlaps, phase_tracker, collision_cache);
+				if (profiling)
+					profile.pair_generation += stopwatch.lap();
+				if (pair.first->is_resting() && pair.second->is_resting())
+					continue;
+
+				const Collider& c1 = *pair.first;
+				const Collider& c2 = *pair.second;
+				auto compute = [&]<typename Result>(Result(Collider::*method)(const Collider&) const) {
+					return [&, method]() -> Result {
+						if (!profiling)
+							return (c1.*method)(c2);
+
+						Stopwatch test;
+						const Result result = (c1.*method)(c2);
+						narrow_phase += test.lap();
+						return result;
+					};
+				};
+
+				dispatch_with<ContactResult, ContactEventData>(c1, c2, contact_handler_map, compute(&Collider::contacts), phase_tracker, collision_cache);
+				dispatch_with<CollisionResult, CollisionEventData>(c1, c2, collision_handler_map, compute(&Collider::collides), phase_tracker, collision_cache);
+				dispatch_with<OverlapResult, OverlapEventData>(c1, c2, overlap_handler_map, compute(&Collider::overlaps), phase_tracker, collision_cache);
+				if (profiling)
+				{
+					profile.handler_invocation += stopwatch.lap();
+					++profile.candidate_pairs;
+				}
 			}
 		}
+
+		// narrow-phase tests run inside handler dispatch, so their time is moved out of handler_invocation
+		profile.narrow_phase += narrow_phase;
+		profile.handler_invocation -= narrow_phase;
+	}
+
+	void CollisionDispatcher::parallel_tick()
+	{
+		// trees are processed one at a time so that handler side effects reach the next tree's flush, as in serial_tick()
+		Stopwatch stopwatch;
+		for (const CollisionTree& tree : trees)
+		{
+			tree.flush();
+			if (profiling)
+				profile.tree_flush += stopwatch.lap();
+
+			candidate_pairs.clear();
+			auto it = tree.iterator();
+			while (!it.done())
+			{
+				auto pair = it.next();
+				if (pair.first->is_resting() && pair.second->is_resting())
+					continue;
+
+				candidate_pairs.push_back({ .c1 = pair.first, .c2 = pair.second, .test = narrow_phase_test(*pair.first, *pair.second) });
+			}
+			if (profiling)
+			{
+				profile.pair_generation += stopwatch.lap();
+				profile.candidate_pairs += candidate_pairs.size();
+			}
+
+			// lazily-evaluated shape caches must be filled before colliders are shared across threads
+			for (CandidatePair& pair : candidate_pairs)
+			{
+				if (pair.test != NarrowPhaseTest::None)
+				{
+					pair.c1->bake_caches();
+					pair.c2->bake_caches();
+				}
+				pair.c1_modifications = pair.c1->modification_count();
+				pair.c2_modifications = pair.c2->modification_count();
+			}
+
+			if (parallel_dispatch.batch_overlaps)
+				batch_overlap_tests();
+
+			WorkerPool::instance().parallel_for(candidate_pairs.size(), parallel_dispatch.batch_size, [this](size_t begin, size_t end) {
+				for (size_t i = begin; i < end; ++i)
+				{
+					CandidatePair& pair = candidate_pairs[i];
+					if (pair.batched)
+						continue;
+
+					switch (pair.test)
+					{
+					case NarrowPhaseTest::Contact:
+						pair.result = pair.c1->contacts(*pair.c2);
+						break;
+					case NarrowPhaseTest::Collision:
+						pair.result = pair.c1->collides(*pair.c2);
+						break;
+					case NarrowPhaseTest::Overlap:
+						pair.result = pair.c1->overlaps(*pair.c2);
+						break;
+					default:
+						break;
+					}
+				}
+			});
+			if (profiling)
+				profile.narrow_phase += stopwatch.lap();
+
+			// a collider modified by a handler must be re-tested on the main thread for the remainder of the tree, whether or not it has been
+			// flushed since
+			auto is_modified = [](const Collider& c, unsigned long long modifications) { return c.is_dirty() || c.modification_count() != modifications; };
+
+			for (const CandidatePair& pair : candidate_pairs)
+			{
+				const Collider& c1 = *pair.c1;
+				const Collider& c2 = *pair.c2;
+				const bool precomputed = !is_modified(c1, pair.c1_modifications) && !is_modified(c2, pair.c2_modifications);
+				auto replay = [&]<typename Result>(Result(Collider::*method)(const Collider&) const) {
+					return [&, method]() -> Result {
+						if (precomputed)
+							if (const Result* result = pair.result.safe_get<Result>())
+								return *result;
+						return (c1.*method)(c2);
+					};
+				};
+
+				dispatch_with<ContactResult, ContactEventData>(c1, c2, contact_handler_map, replay(&Collider::contacts), phase_tracker, collision_cache);
+				dispatch_with<CollisionResult, CollisionEventData>(c1, c2, collision_handler_map, replay(&Collider::collides), phase_tracker, collision_cache);
+				dispatch_with<OverlapResult, OverlapEventData>(c1, c2, overlap_handler_map, replay(&Collider::overlaps), phase_tracker, collision_cache);
+			}
+			if (profiling)
+				profile.handler_invocation += stopwatch.lap();
+		}
+	}
+
+	void CollisionDispatcher::batch_overlap_tests()
+	{
+		overlap_batches.clear();
+		for (size_t i = 0; i < candidate_pairs.size(); ++i)
+		{
+			CandidatePair& pair = candidate_pairs[i];
+			if (pair.test != NarrowPhaseTest::Overlap)
+				continue;
+			if (pair.c1->obj.id() != (size_t)internal::CObjID::TPRIMITIVE || pair.c2->obj.id() != (size_t)internal::CObjID::TPRIMITIVE)
+				continue;
+
+			const TPrimitive& p1 = *static_cast<const TPrimitive*>(pair.c1->obj.raw_obj());
+			const TPrimitive& p2 = *static_cast<const TPrimitive*>(pair.c2->obj.raw_obj());
+			if (!(p1.mask() & p2.layer()))
+			{
+				pair.result = OverlapResult(false);
+				pair.batched = true;
+			}
+			else
+				pair.batched = overlap_batches.push(p1.get_baked(), p2.get_baked(), i);
+		}
+		overlap_batches.run(candidate_pairs);
+	}
+
+	template<typename Group>
+	static void clear_group(Group& group)
+	{
+		group.pairs.clear();
+		group.indices.clear();
+	}
+
+	void CollisionDispatcher::OverlapBatches::clear()
+	{
+		clear_group(circles);
+		clear_group(aabbs);
+		clear_group(obbs);
+		clear_group(kdop2s);
+		clear_group(kdop3s);
+		clear_group(kdop4s);
+		clear_group(kdop5s);
+		clear_group(kdop6s);
+		clear_group(kdop7s);
+		clear_group(kdop8s);
+	}
+
+	template<typename Shape, typename Group>
+	static bool push_group(const Element::ConstElementVariant& v1, const Element::ConstElementVariant& v2, Group& group, size_t index)
+	{
+		if (!v1.holds<const Shape*>() || !v2.holds<const Shape*>())
+			return false;
+
+		if (!group.pairs.push(*v1.get<const Shape*>(), *v2.get<const Shape*>()))
+			return false;
+
+		group.indices.push_back(index);
+		return true;
+	}
+
+	bool CollisionDispatcher::OverlapBatches::push(const Element& e1, const Element& e2, size_t index)
+	{
+		const Element::ConstElementVariant v1 = e1.variant();
+		const Element::ConstElementVariant v2 = e2.variant();
+		return push_group<Circle>(v1, v2, circles, index)
+			|| push_group<AABB>(v1, v2, aabbs, index)
+			|| push_group<OBB>(v1, v2, obbs, index)
+			|| push_group<KDOP2>(v1, v2, kdop2s, index)
+			|| push_group<KDOP3>(v1, v2, kdop3s, index)
+			|| push_group<KDOP4>(v1, v2, kdop4s, index)
+			|| push_group<KDOP5>(v1, v2, kdop5s, index)
+			|| push_group<KDOP6>(v1, v2, kdop6s, index)
+			|| push_group<KDOP7>(v1, v2, kdop7s, index)
+			|| push_group<KDOP8>(v1, v2, kdop8s, index);
+	}
+
+	template<typename Group, typename CandidatePair>
+	static void run_group(const Group& group, std::vector<OverlapResult>& results, std::vector<CandidatePair>& candidates)
+	{
+		if (group.indices.empty())
+			return;
+
+		results.resize(group.indices.size());
+		batch::overlaps(group.pairs, results.data());
+		for (size_t i = 0; i < group.indices.size(); ++i)
+			candidates[group.indices[i]].result = results[i];
+	}
+
+	void CollisionDispatcher::OverlapBatches::run(std::vector<CandidatePair>& candidates)
+	{
+		run_group(circles, results, candidates);
+		run_group(aabbs, results, candidates);
+		run_group(obbs, results, candidates);
+		run_group(kdop2s, results, candidates);
+		run_group(kdop3s, results, candidates);
+		run_group(kdop4s, results, candidates);
+		run_group(kdop5s, results, candidates);
+		run_group(kdop6s, results, candidates);
+		run_group(kdop7s, results, candidates);
+		run_group(kdop8s, results, candidates);
+	}
+
+	CollisionDispatcher::NarrowPhaseTest CollisionDispatcher::narrow_phase_test(const Collider& c1, const Collider& c2) const
+	{
+		if (!c1.one_way_blocks(c2) || !c2.one_way_blocks(c1))
+			return NarrowPhaseTest::None;
+		else if (contact_handler_map.contains(&c1) || contact_handler_map.contains(&c2))
+			return NarrowPhaseTest::Contact;
+		else if (collision_handler_map.contains(&c1) || collision_handler_map.contains(&c2))
+			return NarrowPhaseTest::Collision;
+		else if (overlap_handler_map.contains(&c1) || overlap_handler_map.contains(&c2))
+			return NarrowPhaseTest::Overlap;
+		else
+			return NarrowPhaseTest::None;
 	}
 
 	void CollisionDispatcher::emit(const Collider& from)
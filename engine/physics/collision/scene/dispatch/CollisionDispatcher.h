@@ -2,7 +2,9 @@
 
 #include "physics/collision/scene/dispatch/CollisionController.h"
 #include "physics/collision/scene/dispatch/CollisionTree.h"
+#include "physics/collision/methods/Batch.h"
 #include "core/containers/SymmetricRefMap.h"
+#include "core/types/Variant.h"
 
 namespace oly::col2d
 {
@@ -107,7 +109,14 @@ namespace oly::col2d
 		class CollisionPhaseTracker
 		{
 			SymmetricRefMap<Collider, Phase> map;
-			SymmetricRefMap<Collider, Phase>::MapType lazy_updates;
+
+			struct LazyUpdate
+			{
+				const Collider* c1;
+				const Collider* c2;
+				Phase phase;
+			};
+			std::vector<LazyUpdate> lazy_updates;
 
 		public:
 			Phase prior_phase(const Collider& c1, const Collider& c2);
@@ -286,10 +295,72 @@ namespace oly::col2d
 		mutable internal::CollisionPhaseTracker phase_tracker;
 		mutable internal::CollisionCache collision_cache;
 
+		enum class NarrowPhaseTest : unsigned char
+		{
+			None,
+			Overlap,
+			Collision,
+			Contact
+		};
+
+		struct CandidatePair
+		{
+			const Collider* c1 = nullptr;
+			const Collider* c2 = nullptr;
+			NarrowPhaseTest test = NarrowPhaseTest::None;
+			Variant<OverlapResult, CollisionResult, ContactResult> result;
+			bool batched = false;
+			// modification counts of the colliders when the result was computed
+			unsigned long long c1_modifications = 0;
+			unsigned long long c2_modifications = 0;
+		};
+
+		std::vector<CandidatePair> candidate_pairs;
+
+		template<typename Pairs>
+		struct BatchGroup
+		{
+			Pairs pairs;
+			std::vector<size_t> indices;
+		};
+
+		// overlap-only pairs of primitives with matching element types, grouped so that each group is tested by a single batch kernel
+		struct OverlapBatches
+		{
+			BatchGroup<batch::CirclePairs> circles;
+			BatchGroup<batch::AABBPairs> aabbs;
+			BatchGroup<batch::OBBPairs> obbs;
+			BatchGroup<batch::KDOPPairs<2>> kdop2s;
+			BatchGroup<batch::KDOPPairs<3>> kdop3s;
+			BatchGroup<batch::KDOPPairs<4>> kdop4s;
+			BatchGroup<batch::KDOPPairs<5>> kdop5s;
+			BatchGroup<batch::KDOPPairs<6>> kdop6s;
+			BatchGroup<batch::KDOPPairs<7>> kdop7s;
+			BatchGroup<batch::KDOPPairs<8>> kdop8s;
+			std::vector<OverlapResult> results;
+
+			void clear();
+			bool push(const Element& e1, const Element& e2, size_t index);
+			void run(std::vector<CandidatePair>& candidates);
+		} overlap_batches;
+
 		CollisionDispatcher() : ITickService(TickPhase::Collision, TerminatePhase::Logic) {}
 
 	public:
-		size_t add_tree(const math::Rect2D bounds, const glm::uvec2 degree = { 2, 2 }, const size_t cell_capacity = 4);
+		// When enabled, narrow-phase tests for each tree's candidate pairs are computed on the worker pool before any handler is invoked.
+		// Handlers are then replayed on the main thread in the same order as the serial path. Colliders that a handler moves or reshapes
+		// are re-tested on the main thread, but a mask/layer change made by a handler only takes effect on the next tick.
+		// Overlap-only pairs of primitives whose baked elements are both circles, AABBs, OBBs or kDOPs of the same degree are tested together
+		// with SIMD batch kernels before the remaining pairs are handed to the worker pool.
+		struct
+		{
+			bool enable = false;
+			size_t batch_size = 64;
+			bool batch_overlaps = true;
+		} parallel_dispatch;
+
+		size_t add_tree(const math::Rect2D bounds, const glm::uvec2 degree = { 2, 2 }, const size_t cell_capacity = 4, const TreeLayout layout = TreeLayout::LinkedQuadtree);
+		size_t add_tree(const TreeLayout layout, const float aabb_margin = 2.0f);
 		const CollisionTree& get_tree(size_t i = 0) const { return trees[i]; }
 		void remove_tree(size_t i) { trees.erase(trees.begin() + i); }
 		void clear();
@@ -301,6 +372,37 @@ namespace oly::col2d
 
 		void on_tick() override;
 
+		// Number of global allocations made during on_tick(), accumulated over ticks, as counted by the hook in core/util/AllocationCounter.h.
+		// Stays at zero unless the program installs the hook. Once pair counts reach a steady state, ticks no longer allocate, so this stays constant.
+		size_t allocation_count() const { return tick_allocations; }
+
+		// Wall-clock seconds spent in each stage of dispatch, accumulated over ticks while profiling is enabled. In the parallel path,
+		// narrow_phase covers the precomputed tests and handler_invocation covers the replay, including any re-tests of modified colliders.
+		struct Profile
+		{
+			double tree_flush = 0.0;
+			double pair_generation = 0.0;
+			double narrow_phase = 0.0;
+			double handler_invocation = 0.0;
+			size_t candidate_pairs = 0;
+		};
+
+		bool profiling = false;
+		const Profile& get_profile() const { return profile; }
+		void reset_profile() { profile = {}; }
+
+	private:
+		Profile profile;
+		size_t tick_allocations = 0;
+
+
+		void serial_tick();
+		void parallel_tick();
+		NarrowPhaseTest narrow_phase_test(const Collider& c1, const Collider& c2) const;
+		void batch_overlap_tests();
+
+	public:
+
 		void emit(const Collider& from);
 	};
 }
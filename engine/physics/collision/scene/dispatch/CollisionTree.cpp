@@ -1,9 +1,13 @@
 #include "CollisionTree.h"
 
 #include "physics/collision/scene/colliders/Collider.h"
+#include "physics/collision/scene/dispatch/FlatQuadtree.h"
+#include "physics/collision/scene/dispatch/DynamicAABBTree.h"
+#include "physics/collision/scene/dispatch/SweepAndPrune.h"
 #include "core/base/Assert.h"
 
 #include <stack>
+#include <queue>
 
 namespace oly::col2d
 {
@@ -168,35 +172,85 @@ namespace oly::col2d
 		}
 	}
 
-	CollisionTree::CollisionTree(math::Rect2D bounds, glm::uvec2 degree, size_t cell_capacity)
+	CollisionTree::CollisionTree(math::Rect2D bounds, glm::uvec2 degree, size_t cell_capacity, TreeLayout layout)
 		: degree(degree), inv_degree(1.0f / glm::vec2(degree)), cell_capacity(cell_capacity)
 	{
 		OLY_ASSERT(degree.x * degree.y >= 2);
 		OLY_ASSERT(cell_capacity >= 2);
-		root = internal::CollisionNode::instantiate(this, bounds);
+		switch (layout)
+		{
+		case TreeLayout::LinkedQuadtree:
+			root = internal::CollisionNode::instantiate(this, bounds);
+			break;
+		case TreeLayout::FlatQuadtree:
+			broad_phase = std::make_unique<internal::FlatQuadtree>(bounds, degree, cell_capacity);
+			break;
+		default:
+			throw Error(ErrorCode::UnsupportedSwitchCase);
+		}
+	}
+
+	CollisionTree::CollisionTree(TreeLayout layout, float aabb_margin)
+		: degree(2, 2), inv_degree(0.5f, 0.5f), cell_capacity(4)
+	{
+		switch (layout)
+		{
+		case TreeLayout::DynamicAABB:
+			broad_phase = std::make_unique<internal::DynamicAABBTree>(aabb_margin);
+			break;
+		case TreeLayout::SweepAndPrune:
+			broad_phase = std::make_unique<internal::SweepAndPrune>(aabb_margin);
+			break;
+		default:
+			throw Error(ErrorCode::UnsupportedSwitchCase);
+		}
 	}
 
 	CollisionTree::CollisionTree(const CollisionTree& other)
 		: cell_capacity(other.cell_capacity), degree(other.degree), inv_degree(other.inv_degree)
 	{
-		root = std::unique_ptr<internal::CollisionNode>(new internal::CollisionNode(this, nullptr, *other.root));
+		if (other.broad_phase)
+			copy_broad_phase(other);
+		else
+			root = std::unique_ptr<internal::CollisionNode>(new internal::CollisionNode(this, nullptr, *other.root));
 	}
 
 	CollisionTree::CollisionTree(CollisionTree&& other) noexcept
 		: cell_capacity(other.cell_capacity), degree(other.degree), inv_degree(other.inv_degree)
 	{
-		root = std::move(other.root);
-		root->assign_tree(this);
+		other.invalidate_iterators();
+		if (other.broad_phase)
+		{
+			broad_phase = std::move(other.broad_phase);
+			reassign_broad_phase(other);
+		}
+		else
+		{
+			root = std::move(other.root);
+			root->assign_tree(this);
+		}
+	}
+
+	CollisionTree::~CollisionTree()
+	{
+		invalidate_iterators();
+		release_broad_phase();
 	}
 
 	CollisionTree& CollisionTree::operator=(const CollisionTree& other)
 	{
 		if (this != &other)
 		{
+			invalidate_iterators();
+			release_broad_phase();
+			root.reset();
 			cell_capacity = other.cell_capacity;
 			degree = other.degree;
 			inv_degree = other.inv_degree;
-			root = std::unique_ptr<internal::CollisionNode>(new internal::CollisionNode(this, nullptr, *other.root));
+			if (other.broad_phase)
+				copy_broad_phase(other);
+			else
+				root = std::unique_ptr<internal::CollisionNode>(new internal::CollisionNode(this, nullptr, *other.root));
 		}
 		return *this;
 	}
@@ -205,17 +259,95 @@ namespace oly::col2d
 	{
 		if (this != &other)
 		{
+			invalidate_iterators();
+			other.invalidate_iterators();
+			release_broad_phase();
+			root.reset();
 			cell_capacity = other.cell_capacity;
 			degree = other.degree;
 			inv_degree = other.inv_degree;
-			root = std::move(other.root);
-			root->assign_tree(this);
+			if (other.broad_phase)
+			{
+				broad_phase = std::move(other.broad_phase);
+				reassign_broad_phase(other);
+			}
+			else
+			{
+				root = std::move(other.root);
+				root->assign_tree(this);
+			}
 		}
 		return *this;
 	}
 
+	void CollisionTree::broad_phase_insert(const Collider& collider) const
+	{
+		invalidate_iterators();
+		broad_phase->insert(collider);
+	}
+
+	void CollisionTree::broad_phase_erase(const Collider& collider) const
+	{
+		invalidate_iterators();
+		broad_phase->erase(collider);
+	}
+
+	void CollisionTree::broad_phase_replace(const Collider& at, const Collider& with) const
+	{
+		invalidate_iterators();
+		broad_phase->replace(at, with);
+	}
+
+	void CollisionTree::broad_phase_touch(const Collider& collider) const
+	{
+		broad_phase->touch(collider);
+	}
+
+	void CollisionTree::copy_broad_phase(const CollisionTree& other)
+	{
+		broad_phase = other.broad_phase->clone_empty();
+		std::vector<const Collider*> colliders;
+		other.broad_phase->get_colliders(colliders);
+		for (const Collider* collider : colliders)
+		{
+			collider->handles.handles[this] = nullptr;
+			broad_phase->insert(*collider);
+		}
+	}
+
+	void CollisionTree::reassign_broad_phase(const CollisionTree& other)
+	{
+		std::vector<const Collider*> colliders;
+		broad_phase->get_colliders(colliders);
+		for (const Collider* collider : colliders)
+		{
+			collider->handles.handles.erase(&other);
+			collider->handles.handles[this] = nullptr;
+		}
+	}
+
+	void CollisionTree::release_broad_phase()
+	{
+		if (broad_phase)
+		{
+			invalidate_iterators();
+			std::vector<const Collider*> colliders;
+			broad_phase->get_colliders(colliders);
+			for (const Collider* collider : colliders)
+				collider->handles.handles.erase(this);
+			broad_phase.reset();
+		}
+	}
+
 	void CollisionTree::flush() const
 	{
+		if (broad_phase)
+		{
+			if (broad_phase->flush())
+				invalidate_iterators();
+			return;
+		}
+
 		flush_update_colliders();
 		flush_insert_downward();
 		flush_remove_upward();
@@ -318,116 +450,174 @@ namespace oly::col2d
 
 	void CollisionTree::invalidate_iterators() const
 	{
-		while (!bfs_collider_iterators.empty())
-			(*bfs_collider_iterators.begin())->invalidate();
-		while (!pair_iterators.empty())
-			(*bfs_collider_iterators.begin())->invalidate();
+		while (collider_iterators)
+			collider_iterators->invalidate();
+		while (pair_iterators)
+			pair_iterators->invalidate();
 	}
 
-	CollisionTree::BFSColliderIterator CollisionTree::query(const Collider& collider) const
+	CollisionTree::ColliderIterator CollisionTree::query(const Collider& collider) const
 	{
-		return BFSColliderIterator(*this, collider.quad_wrap);
+		return ColliderIterator(*this, collider.quad_wrap);
 	}
 
-	CollisionTree::BFSColliderIterator CollisionTree::query(const math::Rect2D bounds) const
+	CollisionTree::ColliderIterator CollisionTree::query(const math::Rect2D bounds) const
 	{
-		return BFSColliderIterator(*this, bounds);
+		return ColliderIterator(*this, bounds);
 	}
 
 	CollisionTree::PairIterator CollisionTree::iterator() const
 	{
-		return PairIterator(*this, root->bounds);
+		return PairIterator(*this, root ? root->bounds : math::Rect2D{});
 	}
 
 	void CollisionTree::set_bounds(math::Rect2D bounds)
 	{
-		root->set_bounds(bounds);
+		if (broad_phase)
+		{
+			invalidate_iterators();
+			broad_phase->set_bounds(bounds);
+		}
+		else
+			root->set_bounds(bounds);
 	}
 
-	CollisionTree::BFSColliderIterator::BFSColliderIterator(const CollisionTree& tree, const math::Rect2D bounds)
-		: tree(&tree), bounds(bounds)
+	CollisionTree::ColliderIterator::ColliderIterator(const CollisionTree& tree, const math::Rect2D bounds)
+		: bounds(bounds)
 	{
-		tree.bfs_collider_iterators.insert(this);
-		nodes.push(tree.root.get());
+		link(&tree);
+		borrow_storage();
+		if (tree.broad_phase)
+			tree.broad_phase->query(bounds, buffered);
+		else
+			nodes.push_back(tree.root.get());
 		increment_current();
 	}
 
-	CollisionTree::BFSColliderIterator::BFSColliderIterator(const BFSColliderIterator& other)
-		: tree(other.tree), bounds(other.bounds), nodes(other.nodes), i(other.i), current(other.current)
+	CollisionTree::ColliderIterator::ColliderIterator(const ColliderIterator& other)
+		: bounds(other.bounds), nodes(other.nodes), front_node(other.front_node), buffered(other.buffered), i(other.i), current(other.current)
 	{
-		if (tree)
-			tree->bfs_collider_iterators.insert(this);
+		link(other.tree);
 	}
 
-	CollisionTree::BFSColliderIterator::BFSColliderIterator(BFSColliderIterator&& other)
-		: tree(other.tree), bounds(other.bounds), nodes(std::move(other.nodes)), i(other.i), current(other.current)
+	CollisionTree::ColliderIterator::ColliderIterator(ColliderIterator&& other)
+		: bounds(other.bounds), nodes(std::move(other.nodes)), front_node(other.front_node), buffered(std::move(other.buffered)), i(other.i), current(other.current)
 	{
-		if (tree)
-		{
-			tree->bfs_collider_iterators.erase(&other);
-			other.tree = nullptr;
-			tree->bfs_collider_iterators.insert(this);
-		}
+		const CollisionTree* t = other.tree;
+		if (t)
+			other.invalidate();
+		link(t);
 	}
 
-	CollisionTree::BFSColliderIterator::~BFSColliderIterator()
+	CollisionTree::ColliderIterator::~ColliderIterator()
 	{
 		if (tree)
-			tree->bfs_collider_iterators.erase(this);
+		{
+			return_storage();
+			invalidate();
+		}
 	}
 
-	CollisionTree::BFSColliderIterator& CollisionTree::BFSColliderIterator::operator=(const BFSColliderIterator& other)
+	CollisionTree::ColliderIterator& CollisionTree::ColliderIterator::operator=(const ColliderIterator& other)
 	{
 		if (this != &other)
 		{
 			if (tree)
-				tree->bfs_collider_iterators.erase(this);
-			tree = other.tree;
-			if (tree)
-				tree->bfs_collider_iterators.insert(this);
+				invalidate();
+			link(other.tree);
 
 			bounds = other.bounds;
 			nodes = other.nodes;
+			front_node = other.front_node;
+			buffered = other.buffered;
 			i = other.i;
 			current = other.current;
 		}
 		return *this;
 	}
 
-	CollisionTree::BFSColliderIterator& CollisionTree::BFSColliderIterator::operator=(BFSColliderIterator&& other)
+	CollisionTree::ColliderIterator& CollisionTree::ColliderIterator::operator=(ColliderIterator&& other)
 	{
 		if (this != &other)
 		{
-			if (tree)
-				tree->bfs_collider_iterators.erase(this);
-			tree = other.tree;
 			if (tree)
 			{
-				tree->bfs_collider_iterators.erase(&other);
-				other.tree = nullptr;
-				tree->bfs_collider_iterators.insert(this);
+				return_storage();
+				invalidate();
 			}
+			const CollisionTree* t = other.tree;
+			if (t)
+				other.invalidate();
+			link(t);
 
 			bounds = other.bounds;
 			nodes = std::move(other.nodes);
+			front_node = other.front_node;
+			buffered = std::move(other.buffered);
 			i = other.i;
 			current = other.current;
 		}
 		return *this;
 	}
 
-	void CollisionTree::BFSColliderIterator::set(const BFSColliderIterator& other)
+	void CollisionTree::ColliderIterator::link(const CollisionTree* tree) const
+	{
+		this->tree = tree;
+		if (tree)
+		{
+			prev_registered = nullptr;
+			next_registered = tree->collider_iterators;
+			if (next_registered)
+				next_registered->prev_registered = this;
+			tree->collider_iterators = this;
+		}
+	}
+
+	void CollisionTree::ColliderIterator::borrow_storage()
+	{
+		if (nodes.capacity() == 0 && !tree->spare_node_queues.empty())
+		{
+			nodes = std::move(tree->spare_node_queues.back());
+			tree->spare_node_queues.pop_back();
+		}
+		if (buffered.capacity() == 0 && !tree->spare_buffers.empty())
+		{
+			buffered = std::move(tree->spare_buffers.back());
+			tree->spare_buffers.pop_back();
+		}
+	}
+
+	void CollisionTree::ColliderIterator::return_storage()
+	{
+		nodes.clear();
+		front_node = 0;
+		buffered.clear();
+		if (nodes.capacity() > 0)
+			tree->spare_node_queues.push_back(std::move(nodes));
+		if (buffered.capacity() > 0)
+			tree->spare_buffers.push_back(std::move(buffered));
+	}
+
+	void CollisionTree::ColliderIterator::set(const ColliderIterator& other)
 	{
 		i = other.i;
-		nodes.push(other.nodes.front());
+		nodes.clear();
+		front_node = 0;
+		nodes.push_back(other.nodes[other.front_node]);
 		current = other.current;
 	}
 
-	void CollisionTree::BFSColliderIterator::increment_current()
+	void CollisionTree::ColliderIterator::increment_current()
 	{
-		while (!nodes.empty())
+		if (!buffered.empty())
+		{
+			current = i < buffered.size() ? buffered[i++] : nullptr;
+			return;
+		}
+
+		while (front_node < nodes.size())
 		{
-			const internal::CollisionNode* node = nodes.front();
+			const internal::CollisionNode* node = nodes[front_node];
 			if (i < node->get_colliders().size())
 			{
 				current = node->get_colliders()[i++];
@@ -435,15 +625,17 @@ namespace oly::col2d
 			}
 
 			i = 0;
-			nodes.pop();
+			++front_node;
 			for (const auto& subnode : node->subnodes)
 				if (subnode.get() && subnode->bounds.overlaps(bounds))
-					nodes.push(subnode.get());
+					nodes.push_back(subnode.get());
 		}
+		nodes.clear();
+		front_node = 0;
 		current = nullptr;
 	}
 
-	const Collider* CollisionTree::BFSColliderIterator::next()
+	const Collider* CollisionTree::ColliderIterator::next()
 	{
 		assert_valid();
 		const Collider* og = current;
@@ -451,49 +643,58 @@ namespace oly::col2d
 		return og;
 	}
 
-	void CollisionTree::BFSColliderIterator::assert_valid() const
+	void CollisionTree::ColliderIterator::assert_valid() const
 	{
 		if (!tree)
 			throw Error(ErrorCode::InvalidIterator);
 	}
 
-	void CollisionTree::BFSColliderIterator::invalidate() const
+	void CollisionTree::ColliderIterator::invalidate() const
 	{
-		tree->bfs_collider_iterators.erase(this);
+		if (prev_registered)
+			prev_registered->next_registered = next_registered;
+		else
+			tree->collider_iterators = next_registered;
+		if (next_registered)
+			next_registered->prev_registered = prev_registered;
+		prev_registered = next_registered = nullptr;
 		tree = nullptr;
 	}
 
 	CollisionTree::PairIterator::PairIterator(const CollisionTree& tree, const math::Rect2D bounds)
-		: tree(&tree), first(tree, bounds), second(bounds)
+		: first(bounds), second(bounds)
 	{
-		second.tree = &tree;
-		tree.bfs_collider_iterators.insert(&second);
-		tree.pair_iterators.insert(this);
+		if (tree.broad_phase)
+			buffered = &tree.broad_phase->pairs();
+		else
+		{
+			first = ColliderIterator(tree, bounds);
+			second.link(&tree);
+			second.borrow_storage();
+		}
+		link(&tree);
 		increment_current();
 	}
 
 	CollisionTree::PairIterator::PairIterator(const PairIterator& other)
-		: tree(other.tree), first(other.first), second(other.second), current(other.current)
+		: first(other.first), second(other.second), buffered(other.buffered), buffered_index(other.buffered_index), current(other.current)
 	{
-		if (tree)
-			tree->pair_iterators.insert(this);
+		link(other.tree);
 	}
 
 	CollisionTree::PairIterator::PairIterator(PairIterator&& other)
-		: tree(other.tree), first(std::move(other.first)), second(std::move(other.second)), current(other.current)
+		: first(std::move(other.first)), second(std::move(other.second)), buffered(other.buffered), buffered_index(other.buffered_index), current(other.current)
 	{
-		if (tree)
-		{
-			tree->pair_iterators.erase(&other);
-			other.tree = nullptr;
-			tree->pair_iterators.insert(this);
-		}
+		const CollisionTree* t = other.tree;
+		if (t)
+			other.invalidate();
+		link(t);
 	}
 
 	CollisionTree::PairIterator::~PairIterator()
 	{
 		if (tree)
-			tree->pair_iterators.erase(this);
+			invalidate();
 	}
 
 	CollisionTree::PairIterator& CollisionTree::PairIterator::operator=(const PairIterator& other)
@@ -501,13 +702,13 @@ namespace oly::col2d
 		if (this != &other)
 		{
 			if (tree)
-				tree->pair_iterators.erase(this);
-			tree = other.tree;
-			if (tree)
-				tree->pair_iterators.insert(this);
+				invalidate();
+			link(other.tree);
 
 			first = other.first;
 			second = other.second;
+			buffered = other.buffered;
+			buffered_index = other.buffered_index;
 			current = other.current;
 		}
 		return *this;
@@ -518,24 +719,49 @@ namespace oly::col2d
 		if (this != &other)
 		{
 			if (tree)
-				tree->pair_iterators.erase(this);
-			tree = other.tree;
-			if (tree)
-			{
-				tree->pair_iterators.erase(&other);
-				other.tree = nullptr;
-				tree->pair_iterators.insert(this);
-			}
+				invalidate();
+			const CollisionTree* t = other.tree;
+			if (t)
+				other.invalidate();
+			link(t);
 
 			first = std::move(other.first);
 			second = std::move(other.second);
+			buffered = other.buffered;
+			buffered_index = other.buffered_index;
 			current = other.current;
 		}
 		return *this;
 	}
 
+	void CollisionTree::PairIterator::link(const CollisionTree* tree) const
+	{
+		this->tree = tree;
+		if (tree)
+		{
+			prev_registered = nullptr;
+			next_registered = tree->pair_iterators;
+			if (next_registered)
+				next_registered->prev_registered = this;
+			tree->pair_iterators = this;
+		}
+	}
+
 	void CollisionTree::PairIterator::increment_current()
 	{
+		if (buffered)
+		{
+			if (buffered_index < buffered->size())
+			{
+				const internal::BroadPhase::Pair& pair = (*buffered)[buffered_index++];
+				current.first = pair.first;
+				current.second = pair.second;
+			}
+			else
+				current.first = current.second = nullptr;
+			return;
+		}
+
 		if (second.done())
 		{
 			current.first = first.next();
@@ -567,7 +793,13 @@ namespace oly::col2d
 
 	void CollisionTree::PairIterator::invalidate() const
 	{
-		tree->pair_iterators.erase(this);
+		if (prev_registered)
+			prev_registered->next_registered = next_registered;
+		else
+			tree->pair_iterators = next_registered;
+		if (next_registered)
+			next_registered->prev_registered = prev_registered;
+		prev_registered = next_registered = nullptr;
 		tree = nullptr;
 	}
 }
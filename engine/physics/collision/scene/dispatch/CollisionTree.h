@@ -6,10 +6,10 @@
 
 #include "physics/collision/scene/luts/LUT.h"
 #include "physics/collision/scene/luts/LUTVariant.h"
+#include "physics/collision/scene/dispatch/BroadPhase.h"
 #include "physics/collision/Tolerance.h"
 
 #include <memory>
-#include <queue>
 
 namespace oly::col2d
 {
@@ -62,6 +62,18 @@ namespace oly::col2d
 
 	class CollisionDispatcher;
 
+	enum class TreeLayout
+	{
+		// quadtree whose nodes are individually allocated and linked by pointer
+		LinkedQuadtree,
+		// quadtree whose nodes and collider lists are stored in contiguous arrays and rebuilt when colliders move
+		FlatQuadtree,
+		// unbounded balanced AABB hierarchy over fattened collider bounds
+		DynamicAABB,
+		// unbounded incremental sort-and-sweep that never pairs colliders of two static bodies
+		SweepAndPrune
+	};
+
 	class CollisionTree
 	{
 		friend class internal::CollisionNode;
@@ -74,11 +86,15 @@ namespace oly::col2d
 		glm::vec2 inv_degree;
 
 		std::unique_ptr<internal::CollisionNode> root;
+		std::unique_ptr<internal::BroadPhase> broad_phase;
 
 	public:
-		CollisionTree(math::Rect2D bounds, glm::uvec2 degree = { 2, 2 }, size_t cell_capacity = 4);
+		CollisionTree(math::Rect2D bounds, glm::uvec2 degree = { 2, 2 }, size_t cell_capacity = 4, TreeLayout layout = TreeLayout::LinkedQuadtree);
+		// for layouts that don't need world bounds up front - aabb_margin is how far a collider can move before it is reinserted
+		CollisionTree(TreeLayout layout, float aabb_margin = 2.0f);
 		CollisionTree(const CollisionTree&);
 		CollisionTree(CollisionTree&&) noexcept;
+		~CollisionTree();
 		CollisionTree& operator=(const CollisionTree&);
 		CollisionTree& operator=(CollisionTree&&) noexcept;
 
@@ -92,27 +108,45 @@ namespace oly::col2d
 
 		void invalidate_iterators() const;
 
-		class BFSColliderIterator
+		void broad_phase_insert(const Collider& collider) const;
+		void broad_phase_erase(const Collider& collider) const;
+		void broad_phase_replace(const Collider& at, const Collider& with) const;
+		void broad_phase_touch(const Collider& collider) const;
+		void copy_broad_phase(const CollisionTree& other);
+		void reassign_broad_phase(const CollisionTree& other);
+		void release_broad_phase();
+
+		// Iterators register themselves in intrusive lists on the tree, so that they can be invalidated, and borrow their node queue and buffer
+		// from the tree, so that iterating every tick doesn't allocate once the spare storage has grown.
+		class ColliderIterator
 		{
 			friend class CollisionTree;
 			mutable const CollisionTree* tree = nullptr;
+			mutable const ColliderIterator* prev_registered = nullptr;
+			mutable const ColliderIterator* next_registered = nullptr;
 
 			math::Rect2D bounds;
-			std::queue<const internal::CollisionNode*> nodes;
+			// breadth-first queue of nodes, whose front is at front_node
+			std::vector<const internal::CollisionNode*> nodes;
+			size_t front_node = 0;
+			std::vector<const Collider*> buffered;
 			size_t i = 0;
 			const Collider* current = nullptr;
 			
 		public:
-			BFSColliderIterator(const math::Rect2D bounds) : bounds(bounds) {}
-			BFSColliderIterator(const CollisionTree& tree, const math::Rect2D bounds);
-			BFSColliderIterator(const BFSColliderIterator&);
-			BFSColliderIterator(BFSColliderIterator&&);
-			~BFSColliderIterator();
-			BFSColliderIterator& operator=(const BFSColliderIterator&);
-			BFSColliderIterator& operator=(BFSColliderIterator&&);
+			ColliderIterator(const math::Rect2D bounds) : bounds(bounds) {}
+			ColliderIterator(const CollisionTree& tree, const math::Rect2D bounds);
+			ColliderIterator(const ColliderIterator&);
+			ColliderIterator(ColliderIterator&&);
+			~ColliderIterator();
+			ColliderIterator& operator=(const ColliderIterator&);
+			ColliderIterator& operator=(ColliderIterator&&);
 
 		private:
-			void set(const BFSColliderIterator&);
+			void link(const CollisionTree* tree) const;
+			void borrow_storage();
+			void return_storage();
+			void set(const ColliderIterator&);
 
 			void increment_current();
 
@@ -124,15 +158,23 @@ namespace oly::col2d
 			void assert_valid() const;
 			void invalidate() const;
 		};
+		// former name, from when the linked quadtree was the only layout
+		using BFSColliderIterator = ColliderIterator;
 
-		mutable std::unordered_set<const BFSColliderIterator*> bfs_collider_iterators;
+		mutable const ColliderIterator* collider_iterators = nullptr;
+		mutable std::vector<std::vector<const internal::CollisionNode*>> spare_node_queues;
+		mutable std::vector<std::vector<const Collider*>> spare_buffers;
 
 		class PairIterator
 		{
 			friend class CollisionTree;
 			mutable const CollisionTree* tree = nullptr;
+			mutable const PairIterator* prev_registered = nullptr;
+			mutable const PairIterator* next_registered = nullptr;
 
-			BFSColliderIterator first, second;
+			ColliderIterator first, second;
+			const std::vector<internal::BroadPhase::Pair>* buffered = nullptr;
+			size_t buffered_index = 0;
 			struct ColliderPtrPair
 			{
 				const Collider* first = nullptr;
@@ -150,6 +192,7 @@ namespace oly::col2d
 			PairIterator& operator=(PairIterator&&);
 
 		private:
+			void link(const CollisionTree* tree) const;
 			void increment_current();
 
 		public:
@@ -161,11 +204,11 @@ namespace oly::col2d
 			void invalidate() const;
 		};
 
-		mutable std::unordered_set<const PairIterator*> pair_iterators;
+		mutable const PairIterator* pair_iterators = nullptr;
 
 	public:
-		BFSColliderIterator query(const Collider& collider) const;
-		BFSColliderIterator query(const math::Rect2D bounds) const;
+		ColliderIterator query(const Collider& collider) const;
+		ColliderIterator query(const math::Rect2D bounds) const;
 		PairIterator iterator() const;
 		
 		void set_bounds(math::Rect2D bounds);
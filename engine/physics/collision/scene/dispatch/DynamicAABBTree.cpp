@@ -0,0 +1,345 @@
+#include "DynamicAABBTree.h"
+
+#include "core/base/Assert.h"
+
+namespace oly::col2d::internal
+{
+	static math::Rect2D merge(const math::Rect2D& a, const math::Rect2D& b)
+	{
+		return { .x1 = glm::min(a.x1, b.x1), .x2 = glm::max(a.x2, b.x2), .y1 = glm::min(a.y1, b.y1), .y2 = glm::max(a.y2, b.y2) };
+	}
+
+	static float perimeter(const math::Rect2D& r)
+	{
+		return 2.0f * (r.width() + r.height());
+	}
+
+	DynamicAABBTree::DynamicAABBTree(float margin)
+		: margin(margin)
+	{
+		OLY_ASSERT(margin >= 0.0f);
+	}
+
+	std::unique_ptr<BroadPhase> DynamicAABBTree::clone_empty() const
+	{
+		return std::make_unique<DynamicAABBTree>(margin);
+	}
+
+	void DynamicAABBTree::insert(const Collider& collider)
+	{
+		if (proxy_lut.try_emplace(&collider, (unsigned int)proxies.size()).second)
+		{
+			const unsigned int leaf = allocate_node();
+			nodes[leaf].aabb = fattened(collider_bounds(collider));
+			nodes[leaf].height = 0;
+			nodes[leaf].proxy = (unsigned int)proxies.size();
+			proxies.push_back({ .collider = &collider, .leaf = leaf });
+			insert_leaf(leaf);
+			dirty_pairs = true;
+		}
+	}
+
+	void DynamicAABBTree::erase(const Collider& collider)
+	{
+		auto it = proxy_lut.find(&collider);
+		if (it == proxy_lut.end())
+			return;
+
+		const unsigned int index = it->second;
+		proxy_lut.erase(it);
+		remove_leaf(proxies[index].leaf);
+		free_node(proxies[index].leaf);
+		if (index + 1 < proxies.size())
+		{
+			proxies[index] = proxies.back();
+			proxy_lut[proxies[index].collider] = index;
+			nodes[proxies[index].leaf].proxy = index;
+		}
+		proxies.pop_back();
+		dirty_pairs = true;
+	}
+
+	void DynamicAABBTree::replace(const Collider& at, const Collider& with)
+	{
+		auto it = proxy_lut.find(&at);
+		if (it == proxy_lut.end())
+			return;
+
+		const unsigned int index = it->second;
+		proxy_lut.erase(it);
+		proxy_lut[&with] = index;
+		proxies[index].collider = &with;
+		dirty_pairs = true;
+	}
+
+	bool DynamicAABBTree::flush()
+	{
+		bool changed = false;
+		for (const Proxy& proxy : proxies)
+		{
+			flush_collider(*proxy.collider);
+			const math::Rect2D aabb = collider_bounds(*proxy.collider);
+			if (!aabb.inside(nodes[proxy.leaf].aabb))
+			{
+				remove_leaf(proxy.leaf);
+				nodes[proxy.leaf].aabb = fattened(aabb);
+				insert_leaf(proxy.leaf);
+				changed = true;
+			}
+		}
+
+		if (changed)
+			dirty_pairs = true;
+		return changed;
+	}
+
+	void DynamicAABBTree::get_colliders(std::vector<const Collider*>& colliders) const
+	{
+		colliders.reserve(colliders.size() + proxies.size());
+		for (const Proxy& proxy : proxies)
+			colliders.push_back(proxy.collider);
+	}
+
+	void DynamicAABBTree::query(math::Rect2D bounds, std::vector<const Collider*>& colliders)
+	{
+		if (root == NONE)
+			return;
+
+		stack.clear();
+		stack.push_back(root);
+		while (!stack.empty())
+		{
+			const Node& node = nodes[stack.back()];
+			stack.pop_back();
+			if (!node.aabb.overlaps(bounds))
+				continue;
+
+			if (node.is_leaf())
+				colliders.push_back(proxies[node.proxy].collider);
+			else
+			{
+				stack.push_back(node.child2);
+				stack.push_back(node.child1);
+			}
+		}
+	}
+
+	const std::vector<BroadPhase::Pair>& DynamicAABBTree::pairs()
+	{
+		if (dirty_pairs)
+		{
+			dirty_pairs = false;
+			_pairs.clear();
+			for (unsigned int i = 0; i < proxies.size(); ++i)
+			{
+				const math::Rect2D& aabb = nodes[proxies[i].leaf].aabb;
+				stack.clear();
+				stack.push_back(root);
+				while (!stack.empty())
+				{
+					const Node& node = nodes[stack.back()];
+					stack.pop_back();
+					if (!node.aabb.overlaps(aabb))
+						continue;
+
+					if (node.is_leaf())
+					{
+						// each pair is reported once, by its lower proxy
+						if (node.proxy > i)
+							_pairs.push_back({ .first = proxies[i].collider, .second = proxies[node.proxy].collider });
+					}
+					else
+					{
+						stack.push_back(node.child2);
+						stack.push_back(node.child1);
+					}
+				}
+			}
+		}
+		return _pairs;
+	}
+
+	math::Rect2D DynamicAABBTree::fattened(const math::Rect2D& aabb) const
+	{
+		return { .x1 = aabb.x1 - margin, .x2 = aabb.x2 + margin, .y1 = aabb.y1 - margin, .y2 = aabb.y2 + margin };
+	}
+
+	unsigned int DynamicAABBTree::allocate_node()
+	{
+		if (free_list == NONE)
+		{
+			nodes.emplace_back();
+			return (unsigned int)nodes.size() - 1;
+		}
+
+		const unsigned int node = free_list;
+		free_list = nodes[node].parent;
+		nodes[node] = Node{};
+		return node;
+	}
+
+	void DynamicAABBTree::free_node(unsigned int node)
+	{
+		nodes[node].parent = free_list;
+		nodes[node].child1 = NONE;
+		nodes[node].child2 = NONE;
+		nodes[node].height = -1;
+		nodes[node].proxy = NONE;
+		free_list = node;
+	}
+
+	void DynamicAABBTree::insert_leaf(unsigned int leaf)
+	{
+		if (root == NONE)
+		{
+			root = leaf;
+			nodes[root].parent = NONE;
+			return;
+		}
+
+		// descend toward the sibling that minimizes the increase in total perimeter
+		const math::Rect2D leaf_aabb = nodes[leaf].aabb;
+		unsigned int sibling = root;
+		while (!nodes[sibling].is_leaf())
+		{
+			const unsigned int child1 = nodes[sibling].child1;
+			const unsigned int child2 = nodes[sibling].child2;
+
+			const float area = perimeter(nodes[sibling].aabb);
+			const float combined_area = perimeter(merge(nodes[sibling].aabb, leaf_aabb));
+			const float cost = 2.0f * combined_area;
+			const float inheritance_cost = 2.0f * (combined_area - area);
+
+			auto descend_cost = [&](unsigned int child) {
+				const float merged = perimeter(merge(leaf_aabb, nodes[child].aabb));
+				if (nodes[child].is_leaf())
+					return merged + inheritance_cost;
+				else
+					return merged - perimeter(nodes[child].aabb) + inheritance_cost;
+				};
+
+			const float cost1 = descend_cost(child1);
+			const float cost2 = descend_cost(child2);
+			if (cost < cost1 && cost < cost2)
+				break;
+
+			sibling = cost1 < cost2 ? child1 : child2;
+		}
+
+		const unsigned int old_parent = nodes[sibling].parent;
+		const unsigned int new_parent = allocate_node();
+		nodes[new_parent].parent = old_parent;
+		nodes[new_parent].aabb = merge(leaf_aabb, nodes[sibling].aabb);
+		nodes[new_parent].height = nodes[sibling].height + 1;
+		nodes[new_parent].child1 = sibling;
+		nodes[new_parent].child2 = leaf;
+		nodes[sibling].parent = new_parent;
+		nodes[leaf].parent = new_parent;
+
+		if (old_parent == NONE)
+			root = new_parent;
+		else if (nodes[old_parent].child1 == sibling)
+			nodes[old_parent].child1 = new_parent;
+		else
+			nodes[old_parent].child2 = new_parent;
+
+		refit(new_parent);
+	}
+
+	void DynamicAABBTree::remove_leaf(unsigned int leaf)
+	{
+		if (leaf == root)
+		{
+			root = NONE;
+			return;
+		}
+
+		const unsigned int parent = nodes[leaf].parent;
+		const unsigned int grandparent = nodes[parent].parent;
+		const unsigned int sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+		if (grandparent == NONE)
+		{
+			root = sibling;
+			nodes[sibling].parent = NONE;
+		}
+		else
+		{
+			if (nodes[grandparent].child1 == parent)
+				nodes[grandparent].child1 = sibling;
+			else
+				nodes[grandparent].child2 = sibling;
+			nodes[sibling].parent = grandparent;
+			refit(grandparent);
+		}
+		free_node(parent);
+		nodes[leaf].parent = NONE;
+	}
+
+	void DynamicAABBTree::refit(unsigned int node)
+	{
+		while (node != NONE)
+		{
+			node = balance(node);
+			const unsigned int child1 = nodes[node].child1;
+			const unsigned int child2 = nodes[node].child2;
+			nodes[node].height = 1 + glm::max(nodes[child1].height, nodes[child2].height);
+			nodes[node].aabb = merge(nodes[child1].aabb, nodes[child2].aabb);
+			node = nodes[node].parent;
+		}
+	}
+
+	unsigned int DynamicAABBTree::balance(unsigned int a)
+	{
+		if (nodes[a].is_leaf() || nodes[a].height < 2)
+			return a;
+
+		const unsigned int b = nodes[a].child1;
+		const unsigned int c = nodes[a].child2;
+		const int skew = nodes[c].height - nodes[b].height;
+
+		// rotate the taller child up so that it replaces a, and a adopts one of its children
+		auto rotate = [this, a](unsigned int up, unsigned int other, bool up_is_child2) {
+			Node& A = nodes[a];
+			Node& U = nodes[up];
+			const unsigned int f = U.child1;
+			const unsigned int g = U.child2;
+
+			U.child1 = a;
+			U.parent = A.parent;
+			A.parent = up;
+
+			if (U.parent == NONE)
+				root = up;
+			else if (nodes[U.parent].child1 == a)
+				nodes[U.parent].child1 = up;
+			else
+				nodes[U.parent].child2 = up;
+
+			// the taller grandchild stays under up, and the shorter one moves under a
+			const bool keep_f = nodes[f].height > nodes[g].height;
+			const unsigned int kept = keep_f ? f : g;
+			const unsigned int moved = keep_f ? g : f;
+
+			U.child2 = kept;
+			if (up_is_child2)
+				A.child2 = moved;
+			else
+				A.child1 = moved;
+			nodes[moved].parent = a;
+
+			A.aabb = merge(nodes[other].aabb, nodes[moved].aabb);
+			A.height = 1 + glm::max(nodes[other].height, nodes[moved].height);
+			U.aabb = merge(A.aabb, nodes[kept].aabb);
+			U.height = 1 + glm::max(A.height, nodes[kept].height);
+			return up;
+			};
+
+		if (skew > 1)
+			return rotate(c, b, true);
+		else if (skew < -1)
+			return rotate(b, c, false);
+		else
+			return a;
+	}
+}
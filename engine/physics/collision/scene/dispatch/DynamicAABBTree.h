@@ -0,0 +1,76 @@
+#pragma once
+
+#include "physics/collision/scene/dispatch/BroadPhase.h"
+
+#include <unordered_map>
+
+namespace oly::col2d::internal
+{
+	// Incrementally balanced bounding volume hierarchy over fattened collider AABBs. It has no fixed world bounds,
+	// and colliders are only reinserted once their AABB leaves its fattened AABB.
+	// Candidate pairs are those whose fattened AABBs overlap.
+	class DynamicAABBTree final : public BroadPhase
+	{
+		static constexpr unsigned int NONE = ~0u;
+
+		struct Node
+		{
+			math::Rect2D aabb;
+			// doubles as the next free node when the node is not in use
+			unsigned int parent = NONE;
+			unsigned int child1 = NONE;
+			unsigned int child2 = NONE;
+			int height = -1;
+			unsigned int proxy = NONE;
+
+			bool is_leaf() const { return child1 == NONE; }
+		};
+
+		struct Proxy
+		{
+			const Collider* collider = nullptr;
+			unsigned int leaf = NONE;
+		};
+
+		float margin;
+
+		std::vector<Node> nodes;
+		unsigned int root = NONE;
+		unsigned int free_list = NONE;
+
+		std::vector<Proxy> proxies;
+		std::unordered_map<const Collider*, unsigned int> proxy_lut;
+
+		std::vector<unsigned int> stack;
+		std::vector<Pair> _pairs;
+		bool dirty_pairs = true;
+
+	public:
+		DynamicAABBTree(float margin);
+
+		std::unique_ptr<BroadPhase> clone_empty() const override;
+
+		void insert(const Collider& collider) override;
+		void erase(const Collider& collider) override;
+		void replace(const Collider& at, const Collider& with) override;
+
+		bool flush() override;
+
+		void get_colliders(std::vector<const Collider*>& colliders) const override;
+		void query(math::Rect2D bounds, std::vector<const Collider*>& colliders) override;
+		const std::vector<Pair>& pairs() override;
+
+		int height() const { return root == NONE ? 0 : nodes[root].height; }
+
+	private:
+		math::Rect2D fattened(const math::Rect2D& aabb) const;
+
+		unsigned int allocate_node();
+		void free_node(unsigned int node);
+
+		void insert_leaf(unsigned int leaf);
+		void remove_leaf(unsigned int leaf);
+		void refit(unsigned int node);
+		unsigned int balance(unsigned int a);
+	};
+}
@@ -0,0 +1,280 @@
+#include "FlatQuadtree.h"
+
+#include "physics/collision/Tolerance.h"
+#include "core/base/Assert.h"
+
+#include <numeric>
+
+namespace oly::col2d::internal
+{
+	FlatQuadtree::FlatQuadtree(math::Rect2D bounds, glm::uvec2 degree, size_t cell_capacity)
+		: bounds(bounds), degree(degree), inv_degree(1.0f / glm::vec2(degree)), cell_capacity((unsigned int)cell_capacity)
+	{
+		OLY_ASSERT(degree.x * degree.y >= 2);
+		OLY_ASSERT(cell_capacity >= 2);
+	}
+
+	std::unique_ptr<BroadPhase> FlatQuadtree::clone_empty() const
+	{
+		return std::make_unique<FlatQuadtree>(bounds, degree, cell_capacity);
+	}
+
+	void FlatQuadtree::insert(const Collider& collider)
+	{
+		if (proxy_lut.try_emplace(&collider, (unsigned int)proxies.size()).second)
+		{
+			proxies.push_back({ .collider = &collider, .aabb = collider_bounds(collider) });
+			dirty = true;
+		}
+	}
+
+	void FlatQuadtree::erase(const Collider& collider)
+	{
+		auto it = proxy_lut.find(&collider);
+		if (it == proxy_lut.end())
+			return;
+
+		const unsigned int index = it->second;
+		proxy_lut.erase(it);
+		if (index + 1 < proxies.size())
+		{
+			proxies[index] = proxies.back();
+			proxy_lut[proxies[index].collider] = index;
+		}
+		proxies.pop_back();
+		dirty = true;
+	}
+
+	void FlatQuadtree::replace(const Collider& at, const Collider& with)
+	{
+		auto it = proxy_lut.find(&at);
+		if (it == proxy_lut.end())
+			return;
+
+		const unsigned int index = it->second;
+		proxy_lut.erase(it);
+		proxy_lut[&with] = index;
+		proxies[index].collider = &with;
+		dirty = true;
+	}
+
+	bool FlatQuadtree::flush()
+	{
+		bool moved = false;
+		for (unsigned int p = 0; p < (unsigned int)proxies.size(); ++p)
+		{
+			Entry& proxy = proxies[p];
+			flush_collider(*proxy.collider);
+			const math::Rect2D aabb = collider_bounds(*proxy.collider);
+			if (proxy.aabb != aabb)
+			{
+				proxy.aabb = aabb;
+				moved = true;
+				// a proxy that stays in its node leaves the layout, and so the pairs, as a rebuild would make them
+				if (!dirty && home_node(aabb) == proxy_node[p])
+					entries[proxy_entry[p]].aabb = aabb;
+				else
+					dirty = true;
+			}
+		}
+
+		if (dirty)
+		{
+			rebuild();
+			return true;
+		}
+		return moved;
+	}
+
+	void FlatQuadtree::set_bounds(math::Rect2D bounds)
+	{
+		this->bounds = bounds;
+		dirty = true;
+	}
+
+	void FlatQuadtree::get_colliders(std::vector<const Collider*>& colliders) const
+	{
+		colliders.reserve(colliders.size() + proxies.size());
+		for (const Entry& proxy : proxies)
+			colliders.push_back(proxy.collider);
+	}
+
+	void FlatQuadtree::query(math::Rect2D bounds, std::vector<const Collider*>& colliders)
+	{
+		if (dirty)
+			rebuild();
+
+		// nodes are laid out in DFS order with children in contiguous blocks, so a simple index stack suffices
+		stack.clear();
+		stack.push_back(0);
+		while (!stack.empty())
+		{
+			const Node& node = nodes[stack.back()];
+			stack.pop_back();
+
+			for (unsigned int i = node.first_entry; i < node.first_entry + node.count; ++i)
+				colliders.push_back(entries[i].collider);
+
+			if (node.first_child != NONE)
+			{
+				const unsigned int cells = degree.x * degree.y;
+				for (unsigned int c = cells; c > 0; --c)
+				{
+					const Node& child = nodes[node.first_child + c - 1];
+					if (child.first_entry < child.subtree_end && child.bounds.overlaps(bounds))
+						stack.push_back(node.first_child + c - 1);
+				}
+			}
+		}
+	}
+
+	const std::vector<BroadPhase::Pair>& FlatQuadtree::pairs()
+	{
+		if (dirty)
+			rebuild();
+
+		if (dirty_pairs)
+		{
+			dirty_pairs = false;
+			_pairs.clear();
+			for (const Node& node : nodes)
+				for (unsigned int i = node.first_entry; i < node.first_entry + node.count; ++i)
+					for (unsigned int j = i + 1; j < node.subtree_end; ++j)
+						_pairs.push_back({ .first = entries[i].collider, .second = entries[j].collider });
+		}
+		return _pairs;
+	}
+
+	void FlatQuadtree::rebuild()
+	{
+		dirty = false;
+		dirty_pairs = true;
+
+		const unsigned int count = (unsigned int)proxies.size();
+		order.resize(count);
+		std::iota(order.begin(), order.end(), 0u);
+		sorted.resize(count);
+		cell_of.resize(count);
+
+		nodes.clear();
+		nodes.push_back({ .bounds = bounds, .first_entry = 0, .subtree_end = count });
+		build(0, 0, count, 0);
+
+		entries.resize(count);
+		proxy_entry.resize(count);
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			entries[i] = proxies[order[i]];
+			proxy_entry[order[i]] = i;
+		}
+
+		proxy_node.resize(count);
+		for (unsigned int n = 0; n < (unsigned int)nodes.size(); ++n)
+			for (unsigned int i = nodes[n].first_entry; i < nodes[n].first_entry + nodes[n].count; ++i)
+				proxy_node[order[i]] = n;
+	}
+
+	void FlatQuadtree::build(unsigned int node, unsigned int begin, unsigned int end, unsigned int depth)
+	{
+		nodes[node].first_entry = begin;
+		nodes[node].subtree_end = end;
+		nodes[node].count = end - begin;
+		if (end - begin < cell_capacity || depth == MAX_DEPTH)
+			return;
+
+		const math::Rect2D node_bounds = nodes[node].bounds;
+		const unsigned int cells = degree.x * degree.y;
+
+		// bucket 0 holds colliders that remain in this node, and bucket c + 1 holds colliders that fit in cell c
+		cell_offsets.assign(cells + 2, 0);
+		for (unsigned int i = begin; i < end; ++i)
+		{
+			const unsigned int cell = cell_index(node_bounds, proxies[order[i]].aabb);
+			cell_of[i] = cell == NONE ? 0 : cell + 1;
+			++cell_offsets[cell_of[i] + 1];
+		}
+
+		if (cell_offsets[1] == end - begin)
+			return;
+
+		for (unsigned int b = 1; b < cells + 2; ++b)
+			cell_offsets[b] += cell_offsets[b - 1];
+
+		for (unsigned int i = begin; i < end; ++i)
+			sorted[begin + cell_offsets[cell_of[i]]++] = order[i];
+		std::copy(sorted.begin() + begin, sorted.begin() + end, order.begin() + begin);
+
+		// after the scatter, cell_offsets[b] is the end of bucket b
+		nodes[node].count = cell_offsets[0];
+		const unsigned int first_child = (unsigned int)nodes.size();
+		nodes[node].first_child = first_child;
+		nodes.resize(nodes.size() + cells);
+		for (unsigned int y = 0; y < degree.y; ++y)
+		{
+			for (unsigned int x = 0; x < degree.x; ++x)
+			{
+				const unsigned int c = y * degree.x + x;
+				Node& child = nodes[first_child + c];
+				child.bounds = subdivision(node_bounds, x, y);
+				child.first_entry = begin + cell_offsets[c];
+				child.subtree_end = begin + cell_offsets[c + 1];
+			}
+		}
+
+		for (unsigned int c = 0; c < cells; ++c)
+			build(first_child + c, nodes[first_child + c].first_entry, nodes[first_child + c].subtree_end, depth + 1);
+	}
+
+	unsigned int FlatQuadtree::home_node(const math::Rect2D& aabb) const
+	{
+		unsigned int node = 0;
+		for (unsigned int depth = 0; ; ++depth)
+		{
+			const unsigned int cell = cell_index(nodes[node].bounds, aabb);
+			if (cell == NONE)
+				return node;
+			// a rebuild would split a full leaf once one of its entries fits a cell, so its layout can't be kept
+			if (nodes[node].first_child == NONE)
+				return nodes[node].count >= cell_capacity && depth < MAX_DEPTH ? NONE : node;
+			node = nodes[node].first_child + cell;
+		}
+	}
+
+	unsigned int FlatQuadtree::cell_index(const math::Rect2D& node_bounds, const math::Rect2D& aabb) const
+	{
+		if (!aabb.strict_inside(node_bounds))
+			return NONE;
+
+		const float x1 = (float)degree.x * (aabb.x1 - node_bounds.x1) / node_bounds.width();
+		if (near_zero(x1 - trunc(x1)))
+			return NONE;
+
+		const float x2 = (float)degree.x * (aabb.x2 - node_bounds.x1) / node_bounds.width();
+		if (near_zero(x2 - trunc(x2)))
+			return NONE;
+
+		if ((unsigned int)x1 != (unsigned int)x2)
+			return NONE;
+
+		const float y1 = (float)degree.y * (aabb.y1 - node_bounds.y1) / node_bounds.height();
+		if (near_zero(y1 - trunc(y1)))
+			return NONE;
+
+		const float y2 = (float)degree.y * (aabb.y2 - node_bounds.y1) / node_bounds.height();
+		if (near_zero(y2 - trunc(y2)))
+			return NONE;
+
+		if ((unsigned int)y1 != (unsigned int)y2)
+			return NONE;
+
+		return (unsigned int)y1 * degree.x + (unsigned int)x1;
+	}
+
+	math::Rect2D FlatQuadtree::subdivision(const math::Rect2D& node_bounds, unsigned int x, unsigned int y) const
+	{
+		return {
+			.x1 = glm::mix(node_bounds.x1, node_bounds.x2, float(x) * inv_degree.x), .x2 = glm::mix(node_bounds.x1, node_bounds.x2, (float(x) + 1.0f) * inv_degree.x),
+			.y1 = glm::mix(node_bounds.y1, node_bounds.y2, float(y) * inv_degree.y), .y2 = glm::mix(node_bounds.y1, node_bounds.y2, (float(y) + 1.0f) * inv_degree.y)
+		};
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "physics/collision/scene/dispatch/BroadPhase.h"
+
+#include <unordered_map>
+
+namespace oly::col2d::internal
+{
+	// Quadtree stored as a single node array. Each node owns a contiguous span of the entry pool, and a node's descendants
+	// occupy the remainder of its subtree span, so pair generation and queries are linear scans over contiguous memory.
+	// Candidate pairs match those of the linked CollisionNode quadtree.
+	class FlatQuadtree final : public BroadPhase
+	{
+		static constexpr unsigned int NONE = ~0u;
+		static constexpr unsigned int MAX_DEPTH = 24;
+
+		struct Node
+		{
+			math::Rect2D bounds;
+			unsigned int first_child = NONE;
+			unsigned int first_entry = 0;
+			unsigned int count = 0;
+			unsigned int subtree_end = 0;
+		};
+
+		struct Entry
+		{
+			const Collider* collider = nullptr;
+			math::Rect2D aabb;
+		};
+
+		math::Rect2D bounds;
+		glm::uvec2 degree;
+		glm::vec2 inv_degree;
+		unsigned int cell_capacity;
+
+		std::vector<Entry> proxies;
+		std::unordered_map<const Collider*, unsigned int> proxy_lut;
+
+		std::vector<Node> nodes;
+		std::vector<Entry> entries;
+		std::vector<unsigned int> order, sorted, cell_of, cell_offsets;
+		// node and entry of each proxy as of the last rebuild
+		std::vector<unsigned int> proxy_node, proxy_entry;
+		std::vector<unsigned int> stack;
+		bool dirty = true;
+
+		std::vector<Pair> _pairs;
+		bool dirty_pairs = true;
+
+	public:
+		FlatQuadtree(math::Rect2D bounds, glm::uvec2 degree, size_t cell_capacity);
+
+		std::unique_ptr<BroadPhase> clone_empty() const override;
+
+		void insert(const Collider& collider) override;
+		void erase(const Collider& collider) override;
+		void replace(const Collider& at, const Collider& with) override;
+
+		bool flush() override;
+		void set_bounds(math::Rect2D bounds) override;
+
+		void get_colliders(std::vector<const Collider*>& colliders) const override;
+		void query(math::Rect2D bounds, std::vector<const Collider*>& colliders) override;
+		const std::vector<Pair>& pairs() override;
+
+	private:
+		void rebuild();
+		void build(unsigned int node, unsigned int begin, unsigned int end, unsigned int depth);
+		unsigned int home_node(const math::Rect2D& aabb) const;
+		unsigned int cell_index(const math::Rect2D& node_bounds, const math::Rect2D& aabb) const;
+		math::Rect2D subdivision(const math::Rect2D& node_bounds, unsigned int x, unsigned int y) const;
+	};
+}
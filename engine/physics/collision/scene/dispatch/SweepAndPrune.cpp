@@ -0,0 +1,339 @@
+#include "SweepAndPrune.h"
+
+#include "core/base/Assert.h"
+
+#include <limits>
+#include <algorithm>
+
+namespace oly::col2d::internal
+{
+	static float lower(const math::Rect2D& aabb, unsigned int axis)
+	{
+		return axis == 0 ? aabb.x1 : aabb.y1;
+	}
+
+	static float upper(const math::Rect2D& aabb, unsigned int axis)
+	{
+		return axis == 0 ? aabb.x2 : aabb.y2;
+	}
+
+	// at equal values, min endpoints precede max endpoints so that touching AABBs are reported as overlapping
+	static bool precedes(const auto& e, const auto& f)
+	{
+		return e.value < f.value || (e.value == f.value && !e.is_max && f.is_max);
+	}
+
+	static unsigned long long overlap_key(unsigned int p, unsigned int q)
+	{
+		return p < q ? ((unsigned long long)p << 32) | q : ((unsigned long long)q << 32) | p;
+	}
+
+	static constexpr float SENTINEL = std::numeric_limits<float>::max();
+
+	SweepAndPrune::SweepAndPrune(float margin)
+		: margin(margin)
+	{
+		OLY_ASSERT(margin >= 0.0f);
+	}
+
+	std::unique_ptr<BroadPhase> SweepAndPrune::clone_empty() const
+	{
+		return std::make_unique<SweepAndPrune>(margin);
+	}
+
+	void SweepAndPrune::insert(const Collider& collider)
+	{
+		if (proxy_lut.count(&collider))
+			return;
+
+		unsigned int id;
+		if (free_proxies.empty())
+		{
+			id = (unsigned int)proxies.size();
+			proxies.emplace_back();
+		}
+		else
+		{
+			id = free_proxies.back();
+			free_proxies.pop_back();
+		}
+		proxy_lut[&collider] = id;
+
+		Proxy& proxy = proxies[id];
+		proxy.collider = &collider;
+		proxy.aabb = { .x1 = SENTINEL, .x2 = SENTINEL, .y1 = SENTINEL, .y2 = SENTINEL };
+		proxy.is_static = collider_is_static(collider);
+		set_dynamic(id, !proxy.is_static);
+		// the collider may not have been flushed yet
+		recheck(id);
+		for (unsigned int axis = 0; axis < 2; ++axis)
+		{
+			proxy.min[axis] = (unsigned int)axes[axis].size();
+			axes[axis].push_back({ .value = SENTINEL, .proxy = id, .is_max = false });
+			proxy.max[axis] = (unsigned int)axes[axis].size();
+			axes[axis].push_back({ .value = SENTINEL, .proxy = id, .is_max = true });
+		}
+
+		move_proxy(id, fattened(collider_bounds(collider)));
+	}
+
+	void SweepAndPrune::erase(const Collider& collider)
+	{
+		auto it = proxy_lut.find(&collider);
+		if (it == proxy_lut.end())
+			return;
+
+		const unsigned int id = it->second;
+		proxy_lut.erase(it);
+
+		// sweeping the proxy past every other endpoint removes all of its overlaps, and leaves its endpoints at the back
+		move_proxy(id, { .x1 = SENTINEL, .x2 = SENTINEL, .y1 = SENTINEL, .y2 = SENTINEL });
+		for (unsigned int axis = 0; axis < 2; ++axis)
+		{
+			OLY_ASSERT(proxies[id].max[axis] + 1 == axes[axis].size() && proxies[id].min[axis] + 2 == axes[axis].size());
+			axes[axis].pop_back();
+			axes[axis].pop_back();
+		}
+
+		set_dynamic(id, false);
+		// an id still waiting to be rechecked is skipped, or rechecked harmlessly if reused before the next flush
+		proxies[id] = Proxy{};
+		free_proxies.push_back(id);
+	}
+
+	void SweepAndPrune::replace(const Collider& at, const Collider& with)
+	{
+		auto it = proxy_lut.find(&at);
+		if (it == proxy_lut.end())
+			return;
+
+		const unsigned int id = it->second;
+		proxy_lut.erase(it);
+		proxy_lut[&with] = id;
+		proxies[id].collider = &with;
+		// the new collider may belong to a different body, which is only assigned after it is constructed
+		recheck(id);
+		dirty_pairs = true;
+	}
+
+	void SweepAndPrune::touch(const Collider& collider)
+	{
+		// non-static proxies are flushed every tick anyway
+		auto it = proxy_lut.find(&collider);
+		if (it != proxy_lut.end() && proxies[it->second].is_static)
+			recheck(it->second);
+	}
+
+	bool SweepAndPrune::flush()
+	{
+		bool moved = false;
+		for (unsigned int id : recheck_proxies)
+		{
+			if (!proxies[id].collider || !proxies[id].rechecked)
+				continue;
+
+			proxies[id].rechecked = false;
+			if (update_proxy(id))
+				moved = true;
+			if (refresh_static(id))
+				moved = true;
+		}
+		recheck_proxies.clear();
+
+		for (size_t i = 0; i < dynamic_proxies.size();)
+		{
+			const unsigned int id = dynamic_proxies[i];
+			if (update_proxy(id))
+				moved = true;
+			// a proxy that turned static is swapped out of the list
+			if (refresh_static(id))
+				moved = true;
+			else
+				++i;
+		}
+		return moved;
+	}
+
+	void SweepAndPrune::get_colliders(std::vector<const Collider*>& colliders) const
+	{
+		colliders.reserve(colliders.size() + proxy_lut.size());
+		for (const Proxy& proxy : proxies)
+			if (proxy.collider)
+				colliders.push_back(proxy.collider);
+	}
+
+	void SweepAndPrune::query(math::Rect2D bounds, std::vector<const Collider*>& colliders)
+	{
+		// a proxy that reaches bounds.x1 starts at most max_width before it
+		const float from = bounds.x1 - max_width;
+		auto it = std::lower_bound(axes[0].begin(), axes[0].end(), from, [](const Endpoint& endpoint, float value) { return endpoint.value < value; });
+		for (; it != axes[0].end() && it->value <= bounds.x2; ++it)
+		{
+			if (!it->is_max)
+			{
+				const Proxy& proxy = proxies[it->proxy];
+				if (proxy.aabb.overlaps(bounds))
+					colliders.push_back(proxy.collider);
+			}
+		}
+	}
+
+	const std::vector<BroadPhase::Pair>& SweepAndPrune::pairs()
+	{
+		if (dirty_pairs)
+		{
+			dirty_pairs = false;
+			_pairs.resize(overlaps.size());
+			for (size_t i = 0; i < overlaps.size(); ++i)
+				_pairs[i] = { .first = proxies[overlaps[i].first].collider, .second = proxies[overlaps[i].second].collider };
+		}
+		return _pairs;
+	}
+
+	math::Rect2D SweepAndPrune::fattened(const math::Rect2D& aabb) const
+	{
+		return { .x1 = aabb.x1 - margin, .x2 = aabb.x2 + margin, .y1 = aabb.y1 - margin, .y2 = aabb.y2 + margin };
+	}
+
+	bool SweepAndPrune::update_proxy(unsigned int id)
+	{
+		flush_collider(*proxies[id].collider);
+		const math::Rect2D aabb = collider_bounds(*proxies[id].collider);
+		if (aabb.inside(proxies[id].aabb))
+			return false;
+
+		move_proxy(id, fattened(aabb));
+		return true;
+	}
+
+	bool SweepAndPrune::refresh_static(unsigned int id)
+	{
+		const bool is_static = collider_is_static(*proxies[id].collider);
+		if (is_static == proxies[id].is_static)
+			return false;
+
+		// pairs are filtered by whether both proxies are static as endpoints swap, so the proxy is swept out and back in
+		const math::Rect2D aabb = proxies[id].aabb;
+		move_proxy(id, { .x1 = SENTINEL, .x2 = SENTINEL, .y1 = SENTINEL, .y2 = SENTINEL });
+		proxies[id].is_static = is_static;
+		move_proxy(id, aabb);
+		set_dynamic(id, !is_static);
+		return true;
+	}
+
+	void SweepAndPrune::set_dynamic(unsigned int id, bool dynamic)
+	{
+		Proxy& proxy = proxies[id];
+		if (dynamic && proxy.dynamic_slot == NONE)
+		{
+			proxy.dynamic_slot = (unsigned int)dynamic_proxies.size();
+			dynamic_proxies.push_back(id);
+		}
+		else if (!dynamic && proxy.dynamic_slot != NONE)
+		{
+			const unsigned int last = dynamic_proxies.back();
+			dynamic_proxies[proxy.dynamic_slot] = last;
+			proxies[last].dynamic_slot = proxy.dynamic_slot;
+			dynamic_proxies.pop_back();
+			proxy.dynamic_slot = NONE;
+		}
+	}
+
+	void SweepAndPrune::recheck(unsigned int id)
+	{
+		if (!proxies[id].rechecked)
+		{
+			proxies[id].rechecked = true;
+			recheck_proxies.push_back(id);
+		}
+	}
+
+	void SweepAndPrune::move_proxy(unsigned int id, const math::Rect2D& aabb)
+	{
+		const math::Rect2D old = proxies[id].aabb;
+		proxies[id].aabb = aabb;
+		if (aabb.x2 != SENTINEL)
+			max_width = std::max(max_width, aabb.x2 - aabb.x1);
+		for (unsigned int axis = 0; axis < 2; ++axis)
+		{
+			axes[axis][proxies[id].min[axis]].value = lower(aabb, axis);
+			axes[axis][proxies[id].max[axis]].value = upper(aabb, axis);
+
+			// sift the leading endpoint first so that it never blocks the other one
+			if (upper(aabb, axis) > upper(old, axis))
+			{
+				sift(axis, proxies[id].max[axis]);
+				sift(axis, proxies[id].min[axis]);
+			}
+			else
+			{
+				sift(axis, proxies[id].min[axis]);
+				sift(axis, proxies[id].max[axis]);
+			}
+		}
+	}
+
+	void SweepAndPrune::sift(unsigned int axis, unsigned int index)
+	{
+		const std::vector<Endpoint>& endpoints = axes[axis];
+		while (index > 0 && precedes(endpoints[index], endpoints[index - 1]))
+		{
+			swap_endpoints(axis, index - 1, index);
+			--index;
+		}
+		while (index + 1 < endpoints.size() && precedes(endpoints[index + 1], endpoints[index]))
+		{
+			swap_endpoints(axis, index, index + 1);
+			++index;
+		}
+	}
+
+	void SweepAndPrune::swap_endpoints(unsigned int axis, unsigned int lo, unsigned int hi)
+	{
+		std::vector<Endpoint>& endpoints = axes[axis];
+		const Endpoint& a = endpoints[lo];
+		const Endpoint& b = endpoints[hi];
+		if (a.proxy != b.proxy)
+		{
+			if (a.is_max && !b.is_max)
+				add_overlap(a.proxy, b.proxy);
+			else if (!a.is_max && b.is_max)
+				remove_overlap(a.proxy, b.proxy);
+		}
+
+		std::swap(endpoints[lo], endpoints[hi]);
+		(endpoints[lo].is_max ? proxies[endpoints[lo].proxy].max : proxies[endpoints[lo].proxy].min)[axis] = lo;
+		(endpoints[hi].is_max ? proxies[endpoints[hi].proxy].max : proxies[endpoints[hi].proxy].min)[axis] = hi;
+	}
+
+	void SweepAndPrune::add_overlap(unsigned int p, unsigned int q)
+	{
+		if (proxies[p].is_static && proxies[q].is_static)
+			return;
+		if (!proxies[p].aabb.overlaps(proxies[q].aabb))
+			return;
+
+		if (overlap_lut.try_emplace(overlap_key(p, q), (unsigned int)overlaps.size()).second)
+		{
+			overlaps.push_back({ p, q });
+			dirty_pairs = true;
+		}
+	}
+
+	void SweepAndPrune::remove_overlap(unsigned int p, unsigned int q)
+	{
+		auto it = overlap_lut.find(overlap_key(p, q));
+		if (it == overlap_lut.end())
+			return;
+
+		const unsigned int index = it->second;
+		overlap_lut.erase(it);
+		if (index + 1 < overlaps.size())
+		{
+			overlaps[index] = overlaps.back();
+			overlap_lut[overlap_key(overlaps[index].first, overlaps[index].second)] = index;
+		}
+		overlaps.pop_back();
+		dirty_pairs = true;
+	}
+}
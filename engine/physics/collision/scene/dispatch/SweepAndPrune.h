@@ -0,0 +1,87 @@
+#pragma once
+
+#include "physics/collision/scene/dispatch/BroadPhase.h"
+
+#include <unordered_map>
+
+namespace oly::col2d::internal
+{
+	// Incremental sort-and-sweep over both axes. Endpoint lists stay sorted across ticks, and only the endpoints of colliders that left their
+	// fattened AABB are moved, by insertion, so the per-tick cost scales with the number of moving colliders rather than the total.
+	// Overlapping pairs are maintained as endpoints swap, and pairs between two colliders of static bodies are never generated.
+	// Only colliders of non-static bodies are flushed every tick. Colliders of static bodies are flushed after being inserted, replaced or
+	// touched, which is also when a change of body type is noticed. A collider touches its trees when its shape or local transform is
+	// modified, and a static body touches its colliders when it moves.
+	class SweepAndPrune final : public BroadPhase
+	{
+		static constexpr unsigned int NONE = ~0u;
+
+		struct Endpoint
+		{
+			float value = 0.0f;
+			unsigned int proxy = NONE;
+			bool is_max = false;
+		};
+
+		struct Proxy
+		{
+			const Collider* collider = nullptr;
+			math::Rect2D aabb;
+			unsigned int min[2] = { NONE, NONE };
+			unsigned int max[2] = { NONE, NONE };
+			bool is_static = false;
+			// index in dynamic_proxies, if not static
+			unsigned int dynamic_slot = NONE;
+			bool rechecked = false;
+		};
+
+		float margin;
+
+		std::vector<Proxy> proxies;
+		std::vector<unsigned int> free_proxies;
+		std::unordered_map<const Collider*, unsigned int> proxy_lut;
+		std::vector<unsigned int> dynamic_proxies;
+		std::vector<unsigned int> recheck_proxies;
+		std::vector<Endpoint> axes[2];
+		// widest proxy along the x-axis so far, which bounds how far before a query a proxy overlapping it can start. It never shrinks, which
+		// only widens queries.
+		float max_width = 0.0f;
+
+		std::vector<std::pair<unsigned int, unsigned int>> overlaps;
+		std::unordered_map<unsigned long long, unsigned int> overlap_lut;
+
+		std::vector<Pair> _pairs;
+		bool dirty_pairs = true;
+
+	public:
+		SweepAndPrune(float margin);
+
+		std::unique_ptr<BroadPhase> clone_empty() const override;
+
+		void insert(const Collider& collider) override;
+		void erase(const Collider& collider) override;
+		void replace(const Collider& at, const Collider& with) override;
+		void touch(const Collider& collider) override;
+
+		bool flush() override;
+
+		void get_colliders(std::vector<const Collider*>& colliders) const override;
+		void query(math::Rect2D bounds, std::vector<const Collider*>& colliders) override;
+		const std::vector<Pair>& pairs() override;
+
+	private:
+		math::Rect2D fattened(const math::Rect2D& aabb) const;
+
+		bool update_proxy(unsigned int id);
+		bool refresh_static(unsigned int id);
+		void set_dynamic(unsigned int id, bool dynamic);
+		void recheck(unsigned int id);
+
+		void move_proxy(unsigned int id, const math::Rect2D& aabb);
+		void sift(unsigned int axis, unsigned int index);
+		void swap_endpoints(unsigned int axis, unsigned int lo, unsigned int hi);
+
+		void add_overlap(unsigned int p, unsigned int q);
+		void remove_overlap(unsigned int p, unsigned int q);
+	};
+}
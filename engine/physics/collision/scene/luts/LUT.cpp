@@ -16,6 +16,7 @@ namespace oly::col2d::internal
 	
 	using FlushFn = math::Rect2D(*)(const void*);
 	using IsDirtyFn = bool(*)(const void*);
+	using BakeCachesFn = void(*)(const void*);
 	using DebugOverlayFn = debug::DebugShapeGroup(*)(const void*, glm::vec4);
 	using UpdateViewFn = void(*)(debug::DebugOverlay&, const void*, size_t);
 
@@ -38,6 +39,7 @@ namespace oly::col2d::internal
 
 		FlushFn flush_[(size_t)CObjID::_c];
 		IsDirtyFn is_dirty_[(size_t)CObjID::_c];
+		BakeCachesFn bake_caches_[(size_t)CObjID::_c];
 		DebugOverlayFn create_debug_overlay_[(size_t)CObjID::_c];
 		UpdateViewFn modify_debug_overlay_[(size_t)CObjID::_c];
 
@@ -162,6 +164,13 @@ namespace oly::col2d::internal
 #undef OLY_LUT_IS_DIRTY
 		}
 
+		void load_bake_caches()
+		{
+#define OLY_LUT_BAKE_CACHES(Class) bake_caches_[cobj_id_of<Class>] = [](const void* ptr) { static_cast<const Class*>(ptr)->bake_caches(); };
+			OLY_LUT_LIST(OLY_LUT_BAKE_CACHES)
+#undef OLY_LUT_BAKE_CACHES
+		}
+
 		void load_collision_view()
 		{
 #define OLY_LUT_COLLISION_VIEW(Class) create_debug_overlay_[cobj_id_of<Class>] = [](const void* ptr, glm::vec4 color)\
@@ -226,6 +235,7 @@ namespace oly::col2d::internal
 
 		lut.load_flush();
 		lut.load_is_dirty();
+		lut.load_bake_caches();
 		lut.load_collision_view();
 		lut.load_update_view();
 
@@ -286,6 +296,11 @@ namespace oly::col2d::internal
 		return (lut.is_dirty_[c.id()])(c.raw_obj());
 	}
 
+	void lut_bake_caches(const ColliderObject& c)
+	{
+		(lut.bake_caches_[c.id()])(c.raw_obj());
+	}
+
 	debug::DebugOverlay lut_create_debug_overlay(debug::DebugOverlayLayer& layer, const ColliderObject& c, glm::vec4 color, debug::DebugOverlay::PaintOptions paint_options)
 	{
 		return debug::DebugOverlay(layer, (lut.create_debug_overlay_[c.id()])(c.raw_obj(), color), paint_options);
@@ -21,6 +21,7 @@ namespace oly::col2d::internal
 
 	extern math::Rect2D lut_flush(const ColliderObject&);
 	extern bool lut_is_dirty(const ColliderObject&);
+	extern void lut_bake_caches(const ColliderObject&);
 	extern debug::DebugOverlay lut_create_debug_overlay(debug::DebugOverlayLayer&, const ColliderObject&, glm::vec4, debug::DebugOverlay::PaintOptions = {});
 	extern void lut_modify_debug_overlay(debug::DebugOverlay&, const ColliderObject&, size_t);
 
@@ -40,7 +40,11 @@ namespace oly::physics
 		if (data.phase & (col2d::Phase::Started | col2d::Phase::Ongoing))
 			if (const RigidBody* other = rigid_body(data.passive_collider))
 				if (other != this)
-					dynamics.add_collision(data.active_contact.impulse, data.active_contact.position - dynamics.get_state().position, dynamics_of(*other));
+				{
+					if (!is_asleep())
+						dynamics.add_collision(data.active_contact.impulse, data.active_contact.position - dynamics.get_state().position, dynamics_of(*other));
+					record_touch(*other);
+				}
 		delegator.emit(data);
 	}
 
@@ -40,7 +40,12 @@ namespace oly::physics
 		if (data.phase & (col2d::Phase::Started | col2d::Phase::Ongoing))
 			if (const RigidBody* other = rigid_body(data.passive_collider))
 				if (other != this)
-					dynamics.add_collision(data.mtv(), {}, dynamics_of(*other));
+				{
+					// sleeping bodies never step, so their collisions would never be cleared
+					if (!is_asleep())
+						dynamics.add_collision(data.mtv(), {}, dynamics_of(*other));
+					record_touch(*other);
+				}
 		delegator.emit(data);
 	}
 
@@ -0,0 +1,249 @@
+#include "PhysicsStepper.h"
+
+#include "physics/dynamics/bodies/RigidBody.h"
+#include "core/util/Time.h"
+#include "core/base/Assert.h"
+
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <bit>
+
+namespace oly::physics
+{
+	const std::vector<RigidBody*>& PhysicsStepper::rigid_bodies()
+	{
+		// the registry is unordered, so bodies are re-sorted whenever one is added or removed
+		const auto& registry = oly::internal::AutoRegistry<RigidBody>::instance();
+		if (registry.version() != ordered_version)
+		{
+			ordered_version = registry.version();
+			ordered_bodies.assign(registry.tracked().begin(), registry.tracked().end());
+			std::sort(ordered_bodies.begin(), ordered_bodies.end(), [](const RigidBody* a, const RigidBody* b) { return a->step_order < b->step_order; });
+		}
+		return ordered_bodies;
+	}
+
+	void PhysicsStepper::on_tick()
+	{
+		// takes over collision dispatch while stepping with a fixed timestep, from the next frame's collision phase onward
+		if (fixed_timestep.enable != owns_dispatch)
+		{
+			owns_dispatch = fixed_timestep.enable;
+			col2d::CollisionDispatcher::instance().auto_tick = !owns_dispatch;
+		}
+
+		update_sleeping_state();
+
+		if (fixed_timestep.enable)
+			fixed_tick();
+		else
+			variable_tick();
+	}
+
+	void PhysicsStepper::on_terminate()
+	{
+		oly::internal::AutoRegistry<RigidBody>::instance().clear();
+		ordered_bodies.clear();
+		accumulator = 0.0;
+		touches.clear();
+	}
+
+	size_t PhysicsStepper::state_hash() const
+	{
+		static const auto mix = [](uint64_t h, float f) -> uint64_t {
+			h ^= std::bit_cast<uint32_t>(f);
+			return h * 0x100000001B3ull;
+			};
+
+		// per-body hashes are summed so that iteration order over the registry doesn't matter
+		uint64_t hash = 0;
+		for (const RigidBody* rigid_body : oly::internal::AutoRegistry<RigidBody>::instance().tracked())
+		{
+			const State state = rigid_body->get_dynamics().get_state();
+			uint64_t h = 0xCBF29CE484222325ull;
+			h = mix(h, state.position.x);
+			h = mix(h, state.position.y);
+			h = mix(h, state.rotation);
+			h = mix(h, state.linear_velocity.x);
+			h = mix(h, state.linear_velocity.y);
+			h = mix(h, state.angular_velocity);
+			hash += h ^ (h >> 29);
+		}
+		return (size_t)hash;
+	}
+
+	void PhysicsStepper::record_touch(const RigidBody& a, const RigidBody& b)
+	{
+		// tracked bodies are never const, so the touching pair can be updated during the next step
+		if (sleeping.enable)
+			touches.push_back({ const_cast<RigidBody*>(&a), const_cast<RigidBody*>(&b) });
+	}
+
+	void PhysicsStepper::variable_tick()
+	{
+		accumulator = 0.0;
+		alpha = 1.0f;
+		for (RigidBody* rigid_body : rigid_bodies())
+			rigid_body->restore_stepped_transform();
+		step();
+	}
+
+	void PhysicsStepper::fixed_tick()
+	{
+		OLY_ASSERT(fixed_timestep.rate > 0.0f && fixed_timestep.max_substeps > 0);
+		const double substep = 1.0 / fixed_timestep.rate;
+
+		accumulator += TIME.delta<double>();
+		unsigned int substeps = 0;
+		while (accumulator >= substep && substeps < fixed_timestep.max_substeps)
+		{
+			for (RigidBody* rigid_body : rigid_bodies())
+				rigid_body->restore_stepped_transform();
+
+			col2d::CollisionDispatcher::instance().on_tick();
+
+			TIME.begin_fixed_step(substep);
+			step();
+			TIME.end_fixed_step();
+
+			for (RigidBody* rigid_body : rigid_bodies())
+				rigid_body->record_stepped_transform();
+
+			accumulator -= substep;
+			++substeps;
+		}
+
+		if (accumulator >= substep)
+			accumulator = std::fmod(accumulator, substep);
+
+		alpha = fixed_timestep.interpolate ? (float)(accumulator / substep) : 1.0f;
+		if (fixed_timestep.interpolate)
+			for (RigidBody* rigid_body : rigid_bodies())
+				if (!rigid_body->asleep)
+					rigid_body->interpolate_transform(alpha);
+	}
+
+	void PhysicsStepper::step()
+	{
+		if (sleeping.enable)
+			wake_islands();
+
+		// TODO v10 RigidBody should have a physics enabled bool member to be able to turn on/off collision.
+		Stopwatch stopwatch;
+		for (RigidBody* rigid_body : rigid_bodies())
+			if (!rigid_body->asleep)
+				rigid_body->physics_pre_tick();
+		for (RigidBody* rigid_body : rigid_bodies())
+			if (!rigid_body->asleep)
+				rigid_body->physics_post_tick();
+		if (profiling)
+		{
+			profile.integration += stopwatch.lap();
+			++profile.steps;
+		}
+
+		if (sleeping.enable)
+			sleep_islands();
+		touches.clear();
+	}
+
+	void PhysicsStepper::update_sleeping_state()
+	{
+		if (sleeping.enable == sleeping_active)
+			return;
+
+		sleeping_active = sleeping.enable;
+		for (RigidBody* rigid_body : rigid_bodies())
+		{
+			rigid_body->wake();
+			rigid_body->set_resting(sleeping_active && rigid_body->is_static());
+		}
+	}
+
+	void PhysicsStepper::wake_islands()
+	{
+		islands_to_wake.clear();
+		for (auto [a, b] : touches)
+		{
+			if (a->asleep && !b->asleep && !b->is_static())
+				islands_to_wake.push_back(a->sleep_island);
+			if (b->asleep && !a->asleep && !a->is_static())
+				islands_to_wake.push_back(b->sleep_island);
+		}
+
+		for (RigidBody* rigid_body : rigid_bodies())
+		{
+			if (rigid_body->is_static())
+				rigid_body->set_resting(true);
+			else if (rigid_body->asleep && (rigid_body->get_dynamics().stimulus() != rigid_body->sleep_stimulus
+				|| rigid_body->transformer.global() != rigid_body->sleep_global))
+				islands_to_wake.push_back(rigid_body->sleep_island);
+		}
+
+		if (islands_to_wake.empty())
+			return;
+
+		std::sort(islands_to_wake.begin(), islands_to_wake.end());
+		for (RigidBody* rigid_body : rigid_bodies())
+			if (rigid_body->asleep && std::binary_search(islands_to_wake.begin(), islands_to_wake.end(), rigid_body->sleep_island))
+				rigid_body->wake();
+	}
+
+	void PhysicsStepper::sleep_islands()
+	{
+		static const auto island_root = [](RigidBody* rigid_body) -> RigidBody* {
+			while (rigid_body->island_parent != rigid_body)
+			{
+				rigid_body->island_parent = rigid_body->island_parent->island_parent;
+				rigid_body = rigid_body->island_parent;
+			}
+			return rigid_body;
+			};
+
+		const float dt = TIME.delta();
+		for (RigidBody* rigid_body : rigid_bodies())
+		{
+			if (rigid_body->asleep || rigid_body->is_static())
+				continue;
+
+			const State state = rigid_body->get_dynamics().get_state();
+			if (glm::length(state.linear_velocity) <= sleeping.linear_speed && glm::abs(state.angular_velocity) <= sleeping.angular_speed)
+				rigid_body->rest_time += dt;
+			else
+				rigid_body->rest_time = 0.0f;
+
+			rigid_body->island_parent = rigid_body;
+			rigid_body->island_rest_time = std::numeric_limits<float>::max();
+			rigid_body->sleep_island = 0;
+		}
+
+		// static bodies don't join islands, so that everything resting on the same ground isn't one island
+		for (auto [a, b] : touches)
+			if (!a->asleep && !a->is_static() && !b->asleep && !b->is_static())
+				island_root(a)->island_parent = island_root(b);
+
+		for (RigidBody* rigid_body : rigid_bodies())
+		{
+			if (rigid_body->asleep || rigid_body->is_static())
+				continue;
+
+			RigidBody* root = island_root(rigid_body);
+			root->island_rest_time = std::min(root->island_rest_time, rigid_body->rest_time);
+		}
+
+		for (RigidBody* rigid_body : rigid_bodies())
+		{
+			if (rigid_body->asleep || rigid_body->is_static())
+				continue;
+
+			RigidBody* root = island_root(rigid_body);
+			if (root->island_rest_time >= sleeping.time_to_sleep)
+			{
+				if (root->sleep_island == 0)
+					root->sleep_island = ++last_island;
+				rigid_body->fall_asleep(root->sleep_island);
+			}
+		}
+	}
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "core/context/TickService.h"
+
+#include <vector>
+
+namespace oly::physics
+{
+	class RigidBody;
+
+	class PhysicsStepper final : public Singleton<PhysicsStepper>, public ITickService
+	{
+		friend class Singleton<PhysicsStepper>;
+
+		double accumulator = 0.0;
+		float alpha = 1.0f;
+		bool owns_dispatch = false;
+
+		bool sleeping_active = false;
+		unsigned int last_island = 0;
+		std::vector<std::pair<RigidBody*, RigidBody*>> touches;
+		std::vector<unsigned int> islands_to_wake;
+
+		std::vector<RigidBody*> ordered_bodies;
+		unsigned long long ordered_version = 0;
+
+		PhysicsStepper() : ITickService(TickPhase::Physics, TerminatePhase::Logic) {}
+
+	public:
+		// When enabled, rigid bodies are stepped in fixed substeps of 1 / rate seconds of game time, with TIME.delta() reporting the substep
+		// length. Collision dispatch then runs once per substep instead of in the collision phase, so a frame may dispatch zero or several times.
+		// Leftover time beyond max_substeps per frame is dropped. With interpolation, body transformers are set between the last two substep
+		// states for rendering, and restored to the simulated state before the next substep unless they were moved in between.
+		struct
+		{
+			bool enable = false;
+			float rate = 120.0f;
+			unsigned int max_substeps = 8;
+			bool interpolate = true;
+		} fixed_timestep;
+
+		// Bodies whose linear and angular speeds stay under the thresholds for time_to_sleep seconds fall asleep, but only together with every
+		// body they are in contact with. Sleeping bodies are not ticked, and pairs of colliders that belong to sleeping or static bodies are not
+		// dispatched. A sleeping island wakes as a whole when an awake body touches it, when the net accelerations, forces or impulses on one
+		// of its bodies change, or when one of its bodies is moved. Moving a static body does not wake bodies resting on it.
+		struct
+		{
+			bool enable = false;
+			float linear_speed = 1.0f;
+			float angular_speed = 0.05f;
+			float time_to_sleep = 0.5f;
+		} sleeping;
+
+		// interpolation factor applied to body transformers on the last tick
+		float interpolation_alpha() const { return alpha; }
+
+		// Wall-clock seconds spent integrating rigid bodies, accumulated over steps while profiling is enabled.
+		struct Profile
+		{
+			double integration = 0.0;
+			size_t steps = 0;
+		};
+
+		bool profiling = false;
+		const Profile& get_profile() const { return profile; }
+		void reset_profile() { profile = {}; }
+
+		// Hash of the exact position, rotation and velocities of every rigid body. Bodies are combined independently of their registration order,
+		// so two runs of the same scenario hash equally only if they simulate bit-identically.
+		size_t state_hash() const;
+
+		void on_tick() override;
+		void on_terminate() override;
+
+	private:
+		Profile profile;
+
+		friend class RigidBody;
+		void record_touch(const RigidBody& a, const RigidBody& b);
+
+		const std::vector<RigidBody*>& rigid_bodies();
+
+		void variable_tick();
+		void fixed_tick();
+		void step();
+
+		void update_sleeping_state();
+		void wake_islands();
+		void sleep_islands();
+	};
+}
@@ -1,36 +1,12 @@
 #include "RigidBody.h"
 
+#include "physics/dynamics/bodies/PhysicsStepper.h"
+
 namespace oly::physics
 {
-	namespace internal
-	{
-		struct RigidBodyOnTick
-		{
-			void operator()() const
-			{
-				// TODO v10 RigidBody should have a physics enabled bool member to be able to turn on/off collision.
-				auto& rigid_bodies = oly::internal::AutoRegistry<RigidBody>::instance().tracked();
-				for (RigidBody* rigid_body : rigid_bodies)
-					rigid_body->physics_pre_tick();
-				for (RigidBody* rigid_body : rigid_bodies)
-					rigid_body->physics_post_tick();
-			}
-		};
-
-		struct RigidBodyOnTerminate
-		{
-			void operator()() const
-			{
-				oly::internal::AutoRegistry<RigidBody>::instance().clear();
-			}
-		};
-
-		using RigidBodyTickService = SingletonTickService<TickPhase::Physics, RigidBodyOnTick, TerminatePhase::Logic, RigidBodyOnTerminate>;
-	}
-
 	RigidBody::RigidBody()
 	{
-		internal::RigidBodyTickService::instance(); // only need to call once in non-copy/move ctor.
+		PhysicsStepper::instance(); // only need to call once in non-copy/move ctor.
 	}
 
 	RigidBody::RigidBody(const RigidBody& other)
@@ -39,6 +15,7 @@ namespace oly::physics
 		for (auto it = colliders.begin(); it != colliders.end(); ++it)
 		{
 			it->rigid_body = this;
+			it->resting = resting;
 			it->set_transformer().attach_parent(&transformer);
 		}
 	}
@@ -49,6 +26,7 @@ namespace oly::physics
 		for (auto it = colliders.begin(); it != colliders.end(); ++it)
 		{
 			it->rigid_body = this;
+			it->resting = resting;
 			it->set_transformer().attach_parent(&transformer);
 			other.unbind(*it);
 		}
@@ -64,6 +42,7 @@ namespace oly::physics
 			for (auto it = colliders.begin(); it != colliders.end(); ++it)
 			{
 				it->rigid_body = this;
+				it->resting = resting;
 				it->set_transformer().attach_parent(&transformer);
 				bind(*it);
 			}
@@ -81,6 +60,7 @@ namespace oly::physics
 			for (auto it = colliders.begin(); it != colliders.end(); ++it)
 			{
 				it->rigid_body = this;
+				it->resting = resting;
 				it->set_transformer().attach_parent(&transformer);
 				bind(*it);
 				other.unbind(*it);
@@ -95,6 +75,7 @@ namespace oly::physics
 			collider.rigid_body->remove_collider(collider);
 		col2d::Collider& c = colliders.emplace_back(std::move(collider));
 		c.rigid_body = this;
+		c.resting = resting;
 		c.set_transformer().attach_parent(&transformer);
 		c.handles.attach();
 		bind(c);
@@ -168,6 +149,66 @@ namespace oly::physics
 			unbind(*it);
 	}
 
+	void RigidBody::restore_stepped_transform()
+	{
+		// a transformer that was moved since it was interpolated keeps its new transform
+		if (interpolated && transformer.global() == interpolated_global)
+			transformer.set_global(stepped_global);
+		interpolated = false;
+	}
+
+	void RigidBody::record_stepped_transform()
+	{
+		stepped_global = transformer.global();
+	}
+
+	void RigidBody::interpolate_transform(float alpha)
+	{
+		if (interpolated && transformer.global() != interpolated_global)
+		{
+			interpolated = false;
+			return;
+		}
+
+		const State state = get_dynamics().interpolated_state(alpha);
+		interpolated_global = Transform2D{ .position = state.position, .rotation = state.rotation, .scale = transformer.get_local().scale }.matrix();
+		transformer.set_global(interpolated_global);
+		interpolated = true;
+	}
+
+	void RigidBody::wake()
+	{
+		asleep = false;
+		rest_time = 0.0f;
+		if (!is_static())
+			set_resting(false);
+	}
+
+	void RigidBody::set_resting(bool resting)
+	{
+		if (this->resting != resting)
+		{
+			this->resting = resting;
+			for (col2d::Collider& collider : colliders)
+				collider.resting = resting;
+		}
+	}
+
+	void RigidBody::fall_asleep(unsigned int island)
+	{
+		asleep = true;
+		sleep_island = island;
+		get_dynamics().halt();
+		sleep_stimulus = get_dynamics().stimulus();
+		sleep_global = transformer.global();
+		set_resting(true);
+	}
+
+	void RigidBody::record_touch(const RigidBody& other) const
+	{
+		PhysicsStepper::instance().record_touch(*this, other);
+	}
+
 	const RigidBody* RigidBody::rigid_body(const col2d::Collider& collider)
 	{
 		return collider.rigid_body;
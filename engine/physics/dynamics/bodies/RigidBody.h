@@ -7,10 +7,7 @@
 
 namespace oly::physics
 {
-	namespace internal
-	{
-		struct RigidBodyOnTick;
-	}
+	class PhysicsStepper;
 
 	class RigidBody : public col2d::CollisionController, public AutoRegistrable<RigidBody>
 	{
@@ -56,13 +53,41 @@ namespace oly::physics
 		void modify_debug_overlay(size_t i, debug::DebugOverlay& overlay) const;
 
 	private:
-		friend class internal::RigidBodyOnTick;
+		friend class PhysicsStepper;
 		virtual void physics_pre_tick() = 0;
 		virtual void physics_post_tick() = 0;
 
+		glm::mat3 stepped_global = 1.0f;
+		glm::mat3 interpolated_global = 1.0f;
+		bool interpolated = false;
+
+		void restore_stepped_transform();
+		void record_stepped_transform();
+		void interpolate_transform(float alpha);
+
+		// bodies are stepped in construction order, so that stepping doesn't depend on where they are allocated
+		inline static unsigned long long constructed = 0;
+		unsigned long long step_order = constructed++;
+
+		bool asleep = false;
+		bool resting = false;
+		float rest_time = 0.0f;
+		unsigned int sleep_island = 0;
+		glm::vec4 sleep_stimulus = {};
+		glm::mat3 sleep_global = 1.0f;
+		RigidBody* island_parent = nullptr;
+		float island_rest_time = 0.0f;
+
+		void set_resting(bool resting);
+		void fall_asleep(unsigned int island);
+
 	public:
 		virtual State state() const = 0;
 		virtual bool is_colliding() const = 0;
+		virtual bool is_static() const { return false; }
+
+		bool is_asleep() const { return asleep; }
+		void wake();
 
 	protected:
 		virtual void bind(const col2d::Collider& collider) const = 0;
@@ -71,6 +96,8 @@ namespace oly::physics
 		void unbind_all() const;
 
 		virtual const DynamicsComponent& get_dynamics() const = 0;
+		// marks this body as in contact with other, for grouping bodies into sleep islands
+		void record_touch(const RigidBody& other) const;
 		static const RigidBody* rigid_body(const col2d::Collider& collider);
 		static const DynamicsComponent& dynamics_of(const RigidBody& other) { return other.get_dynamics(); }
 	};
@@ -28,24 +28,42 @@ namespace oly::physics
 
 	void StaticBody::physics_pre_tick()
 	{
+		touch_colliders();
 		dynamics.pre_tick(transformer.global());
 	}
 
 	void StaticBody::physics_post_tick()
 	{
 		dynamics.post_tick();
-		transformer.set_global(Transform2D{ .position = dynamics.get_state().position, .rotation = dynamics.get_state().rotation, .scale = transformer.get_local().scale }.matrix());
+		// avoid dirtying the colliders of bodies that didn't move
+		const glm::mat3 global = Transform2D{ .position = dynamics.get_state().position, .rotation = dynamics.get_state().rotation, .scale = transformer.get_local().scale }.matrix();
+		if (global != transformer.global())
+		{
+			transformer.set_global(global);
+			touch_colliders();
+		}
 	}
 
 	void StaticBody::handle_overlaps(const col2d::OverlapEventData& data) const
 	{
 		if (data.phase & (col2d::Phase::Started | col2d::Phase::Ongoing))
 			if (const RigidBody* other = rigid_body(data.passive_collider))
-				if (other != this)
+				if (other != this && !is_asleep())
 					dynamics.add_collision({}, {}, dynamics_of(*other));
 		delegator.emit(data);
 	}
 
+	void StaticBody::touch_colliders()
+	{
+		// broad phases only flush the colliders of static bodies when told that they may have moved
+		if (transformer.global() != touched_global)
+		{
+			touched_global = transformer.global();
+			for (const col2d::Collider& collider : colliders)
+				collider.handles.touch();
+		}
+	}
+
 	void StaticBody::bind(const col2d::Collider& collider) const
 	{
 		col2d::CollisionController::bind(collider, &StaticBody::handle_overlaps);
@@ -8,6 +8,7 @@ namespace oly::physics
 	class StaticBody : public RigidBody
 	{
 		DynamicsComponent dynamics;
+		glm::mat3 touched_global = 0.0f;
 
 	public:
 		ActionDelegator<col2d::OverlapEventData> delegator;
@@ -27,6 +28,7 @@ namespace oly::physics
 
 		State state() const override { return dynamics.get_state(); }
 		bool is_colliding() const override { return dynamics.is_colliding(); }
+		bool is_static() const override { return true; }
 
 	protected:
 		void bind(const col2d::Collider& collider) const override;
@@ -40,6 +42,7 @@ namespace oly::physics
 
 	private:
 		void handle_overlaps(const col2d::OverlapEventData& data) const;
+		void touch_colliders();
 	};
 
 	typedef SmartReference<StaticBody> StaticBodyRef;
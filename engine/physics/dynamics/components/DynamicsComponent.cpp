@@ -1,5 +1,7 @@
 #include "DynamicsComponent.h"
 
+#include "core/base/SimpleMath.h"
+
 namespace oly::physics
 {
 	FrictionType friction_type(UnitVector2D tangent, glm::vec2 relative_contact_velocity, glm::vec2 relative_linear_velocity,
@@ -33,6 +35,25 @@ namespace oly::physics
 		collisions.clear();
 	}
 
+	void DynamicsComponent::halt() const
+	{
+		post_state.linear_velocity = {};
+		post_state.angular_velocity = 0.0f;
+		pre_state = post_state;
+		collisions.clear();
+	}
+
+	State DynamicsComponent::interpolated_state(float alpha) const
+	{
+		const float rotation_delta = unsigned_fmod(post_state.rotation - pre_state.rotation + glm::pi<float>(), glm::two_pi<float>()) - glm::pi<float>();
+		return State{
+			.position = pre_state.position + alpha * (post_state.position - pre_state.position),
+			.rotation = pre_state.rotation + alpha * rotation_delta,
+			.linear_velocity = pre_state.linear_velocity + alpha * (post_state.linear_velocity - pre_state.linear_velocity),
+			.angular_velocity = pre_state.angular_velocity + alpha * (post_state.angular_velocity - pre_state.angular_velocity)
+		};
+	}
+
 	float DynamicsComponent::teleport_factor(const DynamicsComponent& other) const
 	{
 		std::optional<float> m1 = teleport_mass();
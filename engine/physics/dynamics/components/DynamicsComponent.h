@@ -54,6 +54,8 @@ namespace oly::physics
 
 	public:
 		State get_state() const { return post_state; }
+		// state between the start (alpha = 0) and end (alpha = 1) of the last tick, with rotation taking the shortest arc
+		State interpolated_state(float alpha) const;
 
 		void add_collision(glm::vec2 mtv, glm::vec2 contact, const DynamicsComponent& other) const;
 		bool is_colliding() const { return was_colliding; }
@@ -61,6 +63,11 @@ namespace oly::physics
 		void pre_tick(const glm::mat3& global) const;
 		virtual void post_tick() const;
 
+		// net external inputs, compared across ticks to wake sleeping bodies when they change
+		virtual glm::vec4 stimulus() const { return {}; }
+		// zeroes velocity and discards pending collisions, as when a body falls asleep
+		void halt() const;
+
 	protected:
 		float teleport_factor(const DynamicsComponent& other) const;
 	};
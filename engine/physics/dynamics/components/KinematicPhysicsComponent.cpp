@@ -157,6 +157,17 @@ namespace oly::physics
 		collisions.clear();
 	}
 
+	glm::vec4 KinematicPhysicsComponent::stimulus() const
+	{
+		glm::vec2 linear = properties.net_linear_acceleration + properties.net_force * properties.mass_inverse() + properties.net_linear_impulse;
+		for (const AppliedAcceleration& accel : properties.get_applied_accelerations())
+			linear += accel.acceleration;
+		for (const AppliedForce& force : properties.get_applied_forces())
+			linear += force.force * properties.mass_inverse();
+		const float angular = properties.net_angular_acceleration + properties.net_torque * properties.moi_inverse() + properties.net_angular_impulse;
+		return { linear, angular, (float)properties.applied_impulses.size() };
+	}
+
 	void KinematicPhysicsComponent::update_colliding_linear_motion(glm::vec2 new_velocity) const
 	{
 		// determine teleportation and update angular collision impulse
@@ -132,6 +132,7 @@ namespace oly::physics
 		KinematicPhysicsProperties properties;
 
 		void post_tick() const override;
+		glm::vec4 stimulus() const override;
 
 	protected:
 		std::optional<float> teleport_mass() const override { return properties.mass(); }
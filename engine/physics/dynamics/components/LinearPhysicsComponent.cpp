@@ -75,6 +75,16 @@ namespace oly::physics
 		collisions.clear();
 	}
 
+	glm::vec4 LinearPhysicsComponent::stimulus() const
+	{
+		glm::vec2 linear = properties.net_acceleration + properties.net_force * properties.mass_inverse() + properties.net_impulse;
+		for (glm::vec2 accel : properties.get_applied_accelerations())
+			linear += accel;
+		for (glm::vec2 force : properties.get_applied_forces())
+			linear += force * properties.mass_inverse();
+		return { linear, 0.0f, (float)properties.applied_impulses.size() };
+	}
+
 	void LinearPhysicsComponent::update_colliding_linear_motion(glm::vec2 new_velocity) const
 	{
 		// determine teleportation
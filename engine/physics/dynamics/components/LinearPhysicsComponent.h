@@ -82,6 +82,7 @@ namespace oly::physics
 		LinearPhysicsProperties properties;
 
 		void post_tick() const override;
+		glm::vec4 stimulus() const override;
 
 	protected:
 		std::optional<float> teleport_mass() const override { return properties.mass(); }